@@ -0,0 +1,69 @@
+// memory bandwidth of a fused elementwise chain versus op-by-op ml::ops
+//
+// usage: bench_fused [n_elements]   (default 100M, ~1.6 GB of inputs+output)
+//   computes relu(a * w + b) both ways; bytes are the minimum traffic of
+//   each path: fused reads 3 and writes 1 array, unfused makes three passes
+//   (mul 2R+1W, add 2R+1W, relu 1R+1W) with two temporaries
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ml/ops/elementwise.hpp"
+#include "ml/ops/expr.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+static Tensor filled(size_t n, float start, float step) {
+    Tensor t = Tensor::empty({ n });
+    float* p = t.data();
+    for (size_t i = 0; i < n; ++i) p[i] = start + step * float(i % 1024);
+    return t;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+    auto a = filled(n, -1.0f, 0.002f);
+    auto w = filled(n, 0.5f, 0.001f);
+    auto b = filled(n, -0.25f, 0.0005f);
+
+    double t_unfused = time_best([&] {
+        (void)ml::ops::relu(ml::ops::add(ml::ops::mul(a, w), b));
+        }, 3);
+    double t_fused = time_best([&] {
+        (void)ml::expr::eval(ml::expr::relu(ml::expr::add(ml::expr::mul(a, w), b)));
+        }, 3);
+
+    const double bytes = double(n) * sizeof(float);
+    const double unfused_bytes = 8.0 * bytes;
+    const double fused_bytes = 4.0 * bytes;
+
+    std::cout << "n = " << n << ", threads: " << ml::get_num_threads() << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "unfused: " << t_unfused * 1e3 << " ms, "
+        << unfused_bytes / t_unfused * 1e-9 << " GB/s, "
+        << unfused_bytes * 1e-9 << " GB moved\n";
+    std::cout << "fused:   " << t_fused * 1e3 << " ms, "
+        << fused_bytes / t_fused * 1e-9 << " GB/s, "
+        << fused_bytes * 1e-9 << " GB moved\n";
+    std::cout << "speedup: " << t_unfused / t_fused << "x\n";
+    return 0;
+}
@@ -0,0 +1,71 @@
+// batch-1 and skinny matmul: weight streaming rate of ops::matmul
+//
+// usage: bench_gemv [K] [N]   (default 4096 x 4096, a 64 MB weight)
+//   x[M,K] * w[K,N] for M = 1..16; "w^T view" is the usual [N,K] weight
+//   passed as w.transpose(0, 1) (dot-product kernels), "w row-major" a
+//   [K,N] weight (axpy kernels); M = 16 is the packed GEMM for reference
+//   GB/s counts the weight bytes once per call
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+static Tensor random_tensor(size_t rows, size_t cols, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(rows * cols);
+    for (auto& x : v) x = dist(gen);
+    return Tensor::from_vector(v, { rows, cols });
+}
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t K = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t N = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+
+    auto w_nk = random_tensor(N, K, 1);
+    auto w_t = w_nk.transpose(0, 1);          // [K,N], contiguous along K
+    auto w_kn = w_t.contiguous();             // [K,N], row-major
+    const double bytes = double(K) * N * sizeof(float);
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << ", K=" << K << " N=" << N << "\n";
+    std::cout << std::setw(4) << "M"
+        << std::setw(16) << "w^T view ms" << std::setw(9) << "GB/s"
+        << std::setw(16) << "w row-major ms" << std::setw(9) << "GB/s"
+        << std::setw(10) << "GF/s" << "\n";
+
+    for (size_t M : { 1, 2, 4, 8, 15, 16 }) {
+        auto x = random_tensor(M, K, 2);
+        double t_t = time_best([&] { (void)ml::ops::matmul(x, w_t); }, 10);
+        double t_r = time_best([&] { (void)ml::ops::matmul(x, w_kn); }, 10);
+        std::cout << std::setw(4) << M << std::fixed << std::setprecision(3)
+            << std::setw(16) << t_t * 1e3 << std::setw(9) << std::setprecision(1) << bytes / t_t * 1e-9
+            << std::setw(16) << std::setprecision(3) << t_r * 1e3 << std::setw(9) << std::setprecision(1) << bytes / t_r * 1e-9
+            << std::setw(10) << 2.0 * M * K * N / std::min(t_t, t_r) * 1e-9 << "\n";
+    }
+    return 0;
+}
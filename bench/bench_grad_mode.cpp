@@ -0,0 +1,83 @@
+// per-op cost of graph recording: small ops with and without the guards
+//
+// usage: bench_grad_mode [iterations]   (default 200k)
+//   one step is 5 ops on [16] tensors, y = relu(x * w + b) and two views of
+//   it (reshape, slice), so the time is almost entirely op overhead:
+//   allocation, dispatch and, with grad on, the GradFn nodes, their saved
+//   tensors and the AutogradMeta of every result
+//   "plain": no input requires grad (the floor)
+//   "grad": w and b require grad, the graph is built and dropped each step
+//   "no_grad" / "inference": the same inputs under NoGradGuard / InferenceMode
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ml/autograd/grad_mode.hpp"
+#include "ml/ops/elementwise.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+// ops in one step below
+constexpr size_t kOpsPerStep = 5;
+
+template <class F>
+static double ns_per_op(F&& fn, size_t iters) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto t0 = Clock::now();
+        fn(iters);
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best * 1e9 / double(iters * kOpsPerStep);
+}
+
+int main(int argc, char** argv) {
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    Tensor x = Tensor::ones({ 16 });
+    Tensor w = Tensor::ones({ 16 });
+    Tensor b = Tensor::zeros({ 16 });
+    Tensor wg = Tensor::ones({ 16 });
+    Tensor bg = Tensor::zeros({ 16 });
+    wg.set_requires_grad(true);
+    bg.set_requires_grad(true);
+
+    // sink keeps the loops from being optimized away
+    volatile size_t sink = 0;
+    auto step = [&](const Tensor& wt, const Tensor& bt) {
+        Tensor y = ml::ops::relu(ml::ops::add(ml::ops::mul(x, wt), bt));
+        sink = sink + y.reshape({ 4, 4 }).slice(0, 1, 2).numel();
+    };
+
+    double t_plain = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) step(w, b);
+        }, iters);
+    double t_grad = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) step(wg, bg);
+        }, iters);
+    double t_no_grad = ns_per_op([&](size_t n) {
+        ml::NoGradGuard guard;
+        for (size_t i = 0; i < n; ++i) step(wg, bg);
+        }, iters);
+    double t_inference = ns_per_op([&](size_t n) {
+        ml::InferenceMode guard;
+        for (size_t i = 0; i < n; ++i) step(wg, bg);
+        }, iters);
+
+    std::cout << "ns per op (" << kOpsPerStep << "-op steps on [16] tensors, " << iters << " steps)\n";
+    auto row = [&](const std::string& name, double t) {
+        std::cout << std::setw(12) << name << std::fixed << std::setprecision(1)
+            << std::setw(10) << t << "   x" << std::setprecision(2) << t / t_plain << "\n";
+    };
+    row("plain", t_plain);
+    row("grad", t_grad);
+    row("no_grad", t_no_grad);
+    row("inference", t_inference);
+    return 0;
+}
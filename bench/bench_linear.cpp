@@ -0,0 +1,96 @@
+// fused ops::linear versus the unfused matmul -> add -> relu / add chain
+//
+// usage: bench_linear
+//   typical transformer MLP shapes (d_model 768, hidden 3072) at several
+//   token counts; "saved MB" is the output traffic the fused epilogue avoids:
+//   every extra elementwise op reads and writes the whole [M, N] output
+//   (bias add + relu: 2 passes, bias add + residual add: 2 passes)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/elementwise.hpp"
+#include "ml/ops/linear.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using ml::ops::Activation;
+using Clock = std::chrono::steady_clock;
+
+static Tensor random_tensor(const ml::core::Shape& sizes, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(ml::core::numel(sizes));
+    for (auto& x : v) x = dist(gen);
+    return Tensor::from_vector(v, sizes);
+}
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main() {
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << "\n";
+    std::cout << std::setw(6) << "M" << std::setw(6) << "K" << std::setw(6) << "N"
+        << std::setw(16) << "epilogue"
+        << std::setw(12) << "unfused ms"
+        << std::setw(10) << "fused ms"
+        << std::setw(10) << "speedup"
+        << std::setw(10) << "saved MB" << "\n";
+
+    struct Shape3 { size_t K, N; };
+    for (size_t M : { 32, 128, 512 }) {
+        for (Shape3 s : { Shape3{ 768, 3072 }, Shape3{ 3072, 768 } }) {
+            auto x = random_tensor({ M, s.K }, 1);
+            auto w = random_tensor({ s.N, s.K }, 2).transpose(0, 1);   // [N,K] weight, as stored
+            auto bias = random_tensor({ s.N }, 3);
+            auto res = random_tensor({ M, s.N }, 4);
+            int reps = M <= 128 ? 20 : 5;
+            double saved_mb = 2.0 * 2.0 * M * s.N * sizeof(float) / 1e6;
+
+            // up-projection: bias + activation; down-projection: bias + residual
+            const bool up = s.N > s.K;
+            double t_unfused = time_best([&] {
+                auto y = ml::ops::add(ml::ops::matmul(x, w), bias);
+                auto z = up ? ml::ops::relu(y) : ml::ops::add(y, res);
+                (void)z;
+                }, reps);
+            double t_fused = time_best([&] {
+                auto z = up ? ml::ops::linear(x, w, bias, Activation::ReLU)
+                    : ml::ops::linear(x, w, bias, Activation::None, res);
+                (void)z;
+                }, reps);
+            std::cout << std::setw(6) << M << std::setw(6) << s.K << std::setw(6) << s.N
+                << std::setw(16) << (up ? "bias+relu" : "bias+residual")
+                << std::fixed << std::setprecision(3)
+                << std::setw(12) << t_unfused * 1e3
+                << std::setw(10) << t_fused * 1e3
+                << std::setw(9) << std::setprecision(2) << t_unfused / t_fused << "x"
+                << std::setw(10) << std::setprecision(1) << saved_mb << "\n";
+            if (up) {
+                double t_gelu = time_best([&] { (void)ml::ops::linear(x, w, bias, Activation::GELU); }, reps);
+                std::cout << std::setw(18) << "" << std::setw(16) << "bias+gelu"
+                    << std::setw(12) << "-" << std::fixed << std::setprecision(3)
+                    << std::setw(10) << t_gelu * 1e3 << "\n";
+            }
+        }
+    }
+    return 0;
+}
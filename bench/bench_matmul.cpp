@@ -0,0 +1,123 @@
+// GFLOP/s of ops::matmul versus the original at()-based i-k-j loop
+//
+// usage: bench_matmul [max_size] [naive_max_size]
+//   sizes run 64, 128, ... up to max_size (default 1024)
+//   "a*b^T" feeds a transposed view (the linear-layer layout) straight to matmul
+//   the naive loop is skipped above naive_max_size (default 512), it is very slow
+//   ML_CPU_LEVEL=scalar|avx2|avx512|avx512vnni compares the dispatch levels
+//   ML_NUM_THREADS=n sets the pool size (the naive loop is always serial)
+//   a second table compares bmm on [batch, n, n] with a per-slice matmul loop
+//   (the pre-bmm attention code: slice + contiguous + matmul for each batch)
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+static Tensor random_tensor(size_t rows, size_t cols, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(rows * cols);
+    for (auto& x : v) x = dist(gen);
+    return Tensor::from_vector(v, { rows, cols });
+}
+
+// the pre-GEMM implementation, kept here as the baseline
+static Tensor matmul_naive(const Tensor& a, const Tensor& b) {
+    size_t M = a.sizes()[0], K = a.sizes()[1], N = b.sizes()[1];
+    Tensor out = Tensor::zeros({ M, N });
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t k = 0; k < K; ++k) {
+            float aik = a.at({ i, k });
+            for (size_t j = 0; j < N; ++j) {
+                out.at({ i, j }) += aik * b.at({ k, j });
+            }
+        }
+    }
+    return out;
+}
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t max_n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    size_t naive_max = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 512;
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << "\n";
+    std::cout << std::setw(6) << "n"
+        << std::setw(14) << "gemm GF/s"
+        << std::setw(14) << "a*b^T GF/s"
+        << std::setw(14) << "naive GF/s"
+        << std::setw(10) << "speedup" << "\n";
+
+    for (size_t n = 64; n <= max_n; n *= 2) {
+        auto A = random_tensor(n, n, 1);
+        auto B = random_tensor(n, n, 2);
+        double flops = 2.0 * n * n * n;
+        int reps = n <= 256 ? 10 : 3;
+
+        double t_gemm = time_best([&] { (void)ml::ops::matmul(A, B); }, reps);
+        auto Bt = B.transpose(0, 1);
+        double t_nt = time_best([&] { (void)ml::ops::matmul(A, Bt); }, reps);
+        std::cout << std::setw(6) << n
+            << std::setw(14) << std::fixed << std::setprecision(2) << flops / t_gemm * 1e-9
+            << std::setw(14) << flops / t_nt * 1e-9;
+
+        if (n <= naive_max) {
+            double t_naive = time_best([&] { (void)matmul_naive(A, B); }, 1);
+            std::cout << std::setw(14) << flops / t_naive * 1e-9
+                << std::setw(9) << t_naive / t_gemm << "x";
+        }
+        else {
+            std::cout << std::setw(14) << "-" << std::setw(10) << "-";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "\n" << std::setw(6) << "batch" << std::setw(6) << "n"
+        << std::setw(14) << "bmm GF/s"
+        << std::setw(14) << "loop GF/s"
+        << std::setw(10) << "speedup" << "\n";
+    for (size_t n : { 16, 32, 64, 128 }) {
+        size_t batch = 4096 * 64 / (n * n);
+        auto A = random_tensor(batch * n, n, 3).reshape({ batch, n, n });
+        auto B = random_tensor(batch * n, n, 4).reshape({ batch, n, n });
+        double flops = 2.0 * batch * n * n * n;
+
+        double t_bmm = time_best([&] { (void)ml::ops::bmm(A, B); }, 5);
+        double t_loop = time_best([&] {
+            for (size_t i = 0; i < batch; ++i) {
+                auto a = A.slice(0, i, 1).reshape({ n, n });
+                auto b = B.slice(0, i, 1).reshape({ n, n });
+                (void)ml::ops::matmul(a, b);
+            }
+            }, 5);
+        std::cout << std::setw(6) << batch << std::setw(6) << n
+            << std::setw(14) << std::fixed << std::setprecision(2) << flops / t_bmm * 1e-9
+            << std::setw(14) << flops / t_loop * 1e-9
+            << std::setw(9) << t_loop / t_bmm << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// normalization: ops::layer_norm / rms_norm against a plain loop that
+// makes a pass per statistic (mean, variance, then normalize) per row
+//
+// usage: bench_norm [rows] [cols]   (default 4096 x 4096, 64 MB)
+//   the ops read a row once for its statistics and once more to write
+//   the output; "ln backward" times the backward alone (dx, dw, db), the
+//   loop recomputing the row statistics the graph node has saved
+//   GB/s counts the input bytes once per call
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/norm.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t R = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t C = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(R * C);
+    for (auto& x : v) x = dist(gen);
+    Tensor x = Tensor::from_vector(v, { R, C });
+    const float* px = x.data();
+    const double bytes = double(R) * C * sizeof(float);
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << ", " << R << " x " << C << "\n";
+    std::cout << std::setw(12) << "op"
+        << std::setw(12) << "loop ms" << std::setw(12) << "ops ms"
+        << std::setw(9) << "GB/s" << std::setw(10) << "speedup" << "\n";
+
+    std::vector<float> out(R * C);
+    auto row = [&](const std::string& name, auto&& loop, auto&& op) {
+        double t_loop = time_best(loop, 3);
+        double t_op = time_best(op, 10);
+        std::cout << std::setw(12) << name << std::fixed << std::setprecision(3)
+            << std::setw(12) << t_loop * 1e3 << std::setw(12) << t_op * 1e3
+            << std::setw(9) << std::setprecision(1) << bytes / t_op * 1e-9
+            << std::setw(9) << t_loop / t_op << "x\n";
+    };
+
+    std::vector<float> wv(C), bv(C);
+    for (auto& w : wv) w = dist(gen);
+    for (auto& b : bv) b = dist(gen);
+    Tensor w = Tensor::from_vector(wv, { C }), b = Tensor::from_vector(bv, { C });
+
+    row("layer_norm", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float mean = 0.0f;
+            for (size_t j = 0; j < C; ++j) mean += r[j];
+            mean /= float(C);
+            float var = 0.0f;
+            for (size_t j = 0; j < C; ++j) var += (r[j] - mean) * (r[j] - mean);
+            const float rstd = 1.0f / std::sqrt(var / float(C) + 1e-5f);
+            for (size_t j = 0; j < C; ++j) out[i * C + j] = (r[j] - mean) * rstd * wv[j] + bv[j];
+        }
+        }, [&] { (void)ml::ops::layer_norm(x, w, b); });
+
+    row("rms_norm", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float ss = 0.0f;
+            for (size_t j = 0; j < C; ++j) ss += r[j] * r[j];
+            const float rstd = 1.0f / std::sqrt(ss / float(C) + 1e-6f);
+            for (size_t j = 0; j < C; ++j) out[i * C + j] = r[j] * rstd * wv[j];
+        }
+        }, [&] { (void)ml::ops::rms_norm(x, w); });
+
+    // loop: the textbook backward, sums per row then dx, dw/db in the same
+    // row loop; ops: the graph node, which also adds dx into x.grad
+    x.set_requires_grad(true);
+    w.set_requires_grad(true);
+    b.set_requires_grad(true);
+    Tensor y = ml::ops::layer_norm(x, w, b);
+    Tensor g = Tensor::ones({ R, C });
+    const float* pg = g.data();
+    std::vector<float> dw(C), db(C);
+    row("ln backward", [&] {
+        std::fill(dw.begin(), dw.end(), 0.0f);
+        std::fill(db.begin(), db.end(), 0.0f);
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            const float* gr = pg + i * C;
+            float mean = 0.0f;
+            for (size_t j = 0; j < C; ++j) mean += r[j];
+            mean /= float(C);
+            float var = 0.0f;
+            for (size_t j = 0; j < C; ++j) var += (r[j] - mean) * (r[j] - mean);
+            const float rstd = 1.0f / std::sqrt(var / float(C) + 1e-5f);
+            float sg = 0.0f, sgx = 0.0f;
+            for (size_t j = 0; j < C; ++j) {
+                sg += gr[j] * wv[j];
+                sgx += gr[j] * wv[j] * (r[j] - mean) * rstd;
+            }
+            for (size_t j = 0; j < C; ++j) {
+                const float xh = (r[j] - mean) * rstd;
+                out[i * C + j] = rstd * (gr[j] * wv[j] - sg / float(C) - xh * sgx / float(C));
+                dw[j] += gr[j] * xh;
+                db[j] += gr[j];
+            }
+        }
+        }, [&] { y.grad_fn()->backward(g); });
+
+    volatile float sink = out[0];
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,94 @@
+// int8 quantized_matmul versus fp32 matmul on the same problem
+//
+// usage: bench_qmatmul [max_size]
+//   sizes run 64, 128, ... up to max_size (default 1024)
+//   "int8" is u8 activations (full range) x s8 per-channel weights -> fp32,
+//   "int8 r7" uses reduce_range activations (single-maddubs kernel on AVX2);
+//   the quantization of the inputs is done once, outside the timing
+//   ML_CPU_LEVEL=scalar|avx2|avx512|avx512vnni compares the dispatch levels
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/ops/quantize.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::DType;
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+static Tensor random_tensor(size_t rows, size_t cols, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(rows * cols);
+    for (auto& x : v) x = dist(gen);
+    return Tensor::from_vector(v, { rows, cols });
+}
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+// relative Frobenius error of c against ref
+static double rel_err(const Tensor& c, const Tensor& ref) {
+    double err = 0.0, norm = 0.0;
+    for (size_t i = 0; i < c.numel(); ++i) {
+        double d = double(c.data()[i]) - ref.data()[i];
+        err += d * d;
+        norm += double(ref.data()[i]) * ref.data()[i];
+    }
+    return std::sqrt(err / norm);
+}
+
+int main(int argc, char** argv) {
+    size_t max_n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << "\n";
+    std::cout << std::setw(6) << "n"
+        << std::setw(12) << "fp32 GF/s"
+        << std::setw(12) << "int8 GOP/s"
+        << std::setw(14) << "int8 r7 GOP/s"
+        << std::setw(10) << "speedup"
+        << std::setw(11) << "rel err" << "\n";
+
+    for (size_t n = 64; n <= max_n; n *= 2) {
+        auto A = random_tensor(n, n, 1);
+        auto W = random_tensor(n, n, 2);
+        auto qw = ml::ops::quantize(W, DType::Int8, ml::ops::choose_qparams(W, DType::Int8, 1));
+        auto qa = ml::ops::quantize(A, DType::UInt8, ml::ops::choose_qparams(A, DType::UInt8));
+        auto qa7 = ml::ops::quantize(A, DType::UInt8, ml::ops::choose_qparams(A, DType::UInt8, -1, true));
+        double ops = 2.0 * n * n * n;
+        int reps = n <= 256 ? 10 : 3;
+
+        double t_f32 = time_best([&] { (void)ml::ops::matmul(A, W); }, reps);
+        double t_q = time_best([&] { (void)ml::ops::quantized_matmul(qa, qw); }, reps);
+        double t_q7 = time_best([&] { (void)ml::ops::quantized_matmul(qa7, qw); }, reps);
+        double err = rel_err(ml::ops::quantized_matmul(qa, qw), ml::ops::matmul(A, W));
+
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(2)
+            << std::setw(12) << ops / t_f32 * 1e-9
+            << std::setw(12) << ops / t_q * 1e-9
+            << std::setw(14) << ops / t_q7 * 1e-9
+            << std::setw(9) << t_f32 / t_q << "x"
+            << std::setw(11) << std::setprecision(4) << err << "\n";
+    }
+    return 0;
+}
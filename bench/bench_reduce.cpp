@@ -0,0 +1,107 @@
+// reductions: ops::sum / max / argmax against a plain serial loop
+//
+// usage: bench_reduce [rows] [cols]   (default 4096 x 4096, 64 MB)
+//   "rows" reduces the contiguous dim (one output per row), "cols" the
+//   leading dim (one output per column, accumulated row by row), "all"
+//   every element; the loop is a one-accumulator loop over the data
+//   GB/s counts the input bytes once per call
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/reduce.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t R = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t C = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(R * C);
+    for (auto& x : v) x = dist(gen);
+    Tensor x = Tensor::from_vector(v, { R, C });
+    const float* px = x.data();
+    const double bytes = double(R) * C * sizeof(float);
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << ", " << R << " x " << C << "\n";
+    std::cout << std::setw(12) << "op"
+        << std::setw(12) << "loop ms" << std::setw(12) << "ops ms"
+        << std::setw(9) << "GB/s" << std::setw(10) << "speedup" << "\n";
+
+    std::vector<float> out(std::max(R, C));
+    auto row = [&](const std::string& name, auto&& loop, auto&& op) {
+        double t_loop = time_best(loop, 5);
+        double t_op = time_best(op, 10);
+        std::cout << std::setw(12) << name << std::fixed << std::setprecision(3)
+            << std::setw(12) << t_loop * 1e3 << std::setw(12) << t_op * 1e3
+            << std::setw(9) << std::setprecision(1) << bytes / t_op * 1e-9
+            << std::setw(9) << t_loop / t_op << "x\n";
+    };
+
+    row("sum rows", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            float s = 0.0f;
+            for (size_t j = 0; j < C; ++j) s += px[i * C + j];
+            out[i] = s;
+        }
+        }, [&] { (void)ml::ops::sum(x, 1); });
+
+    row("sum cols", [&] {
+        for (size_t j = 0; j < C; ++j) {
+            float s = 0.0f;
+            for (size_t i = 0; i < R; ++i) s += px[i * C + j];
+            out[j] = s;
+        }
+        }, [&] { (void)ml::ops::sum(x, 0); });
+
+    row("sum all", [&] {
+        float s = 0.0f;
+        for (size_t i = 0; i < R * C; ++i) s += px[i];
+        out[0] = s;
+        }, [&] { (void)ml::ops::sum(x); });
+
+    row("max rows", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            float m = px[i * C];
+            for (size_t j = 1; j < C; ++j) m = px[i * C + j] > m ? px[i * C + j] : m;
+            out[i] = m;
+        }
+        }, [&] { (void)ml::ops::max(x, 1); });
+
+    row("argmax rows", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            size_t best = 0;
+            for (size_t j = 1; j < C; ++j) best = px[i * C + j] > px[i * C + best] ? j : best;
+            out[i] = float(best);
+        }
+        }, [&] { (void)ml::ops::argmax(x, 1); });
+
+    volatile float sink = out[0];
+    (void)sink;
+    return 0;
+}
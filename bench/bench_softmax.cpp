@@ -0,0 +1,136 @@
+// softmax family: ops::softmax / log_softmax / logsumexp against a plain
+// three-pass loop (max, sum of std::exp, normalize) per row
+//
+// usage: bench_softmax [rows] [cols]   (default 4096 x 4096, 64 MB)
+//   the ops make one pass over x for the running max and sum and one
+//   writing the output (logsumexp: no output pass)
+//   "xent fwd+bwd" is ops::cross_entropy and its backward against the
+//   unfused path: a probability matrix, log, gather, mean, then p - onehot
+//   GB/s counts the input bytes once per call
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ml/core/cpu.hpp"
+#include "ml/ops/convert.hpp"
+#include "ml/ops/loss.hpp"
+#include "ml/ops/softmax.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+// best-of-reps wall time in seconds
+template <class F>
+static double time_best(F&& fn, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t R = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t C = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<float> v(R * C);
+    for (auto& x : v) x = dist(gen);
+    Tensor x = Tensor::from_vector(v, { R, C });
+    const float* px = x.data();
+    const double bytes = double(R) * C * sizeof(float);
+
+    std::cout << "kernels: " << ml::core::cpu_level_name(ml::core::cpu_level())
+        << ", threads: " << ml::get_num_threads() << ", " << R << " x " << C << "\n";
+    std::cout << std::setw(12) << "op"
+        << std::setw(12) << "loop ms" << std::setw(12) << "ops ms"
+        << std::setw(9) << "GB/s" << std::setw(10) << "speedup" << "\n";
+
+    std::vector<float> out(R * C);
+    auto row = [&](const std::string& name, auto&& loop, auto&& op) {
+        double t_loop = time_best(loop, 3);
+        double t_op = time_best(op, 10);
+        std::cout << std::setw(12) << name << std::fixed << std::setprecision(3)
+            << std::setw(12) << t_loop * 1e3 << std::setw(12) << t_op * 1e3
+            << std::setw(9) << std::setprecision(1) << bytes / t_op * 1e-9
+            << std::setw(9) << t_loop / t_op << "x\n";
+    };
+
+    row("softmax", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float m = r[0];
+            for (size_t j = 1; j < C; ++j) m = std::max(m, r[j]);
+            float s = 0.0f;
+            for (size_t j = 0; j < C; ++j) s += std::exp(r[j] - m);
+            for (size_t j = 0; j < C; ++j) out[i * C + j] = std::exp(r[j] - m) / s;
+        }
+        }, [&] { (void)ml::ops::softmax(x, 1); });
+
+    row("log_softmax", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float m = r[0];
+            for (size_t j = 1; j < C; ++j) m = std::max(m, r[j]);
+            float s = 0.0f;
+            for (size_t j = 0; j < C; ++j) s += std::exp(r[j] - m);
+            const float c = m + std::log(s);
+            for (size_t j = 0; j < C; ++j) out[i * C + j] = r[j] - c;
+        }
+        }, [&] { (void)ml::ops::log_softmax(x, 1); });
+
+    row("logsumexp", [&] {
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float m = r[0];
+            for (size_t j = 1; j < C; ++j) m = std::max(m, r[j]);
+            float s = 0.0f;
+            for (size_t j = 0; j < C; ++j) s += std::exp(r[j] - m);
+            out[i] = m + std::log(s);
+        }
+        }, [&] { (void)ml::ops::logsumexp(x, 1); });
+
+    std::vector<float> tv(R);
+    for (size_t i = 0; i < R; ++i) tv[i] = float((i * 7919) % C);
+    Tensor targets = ml::ops::to_dtype(Tensor::from_vector(tv, { R }), ml::DType::Int32);
+    std::vector<float> grad(R * C);
+    row("xent fwd+bwd", [&] {
+        double loss = 0.0;
+        for (size_t i = 0; i < R; ++i) {
+            const float* r = px + i * C;
+            float* p = out.data() + i * C;
+            float m = r[0];
+            for (size_t j = 1; j < C; ++j) m = std::max(m, r[j]);
+            float s = 0.0f;
+            for (size_t j = 0; j < C; ++j) s += std::exp(r[j] - m);
+            for (size_t j = 0; j < C; ++j) p[j] = std::exp(r[j] - m) / s;
+        }
+        for (size_t i = 0; i < R; ++i) loss -= std::log(out[i * C + size_t(tv[i])]);
+        out[0] = float(loss / double(R));
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) grad[i * C + j] = out[i * C + j] / float(R);
+            grad[i * C + size_t(tv[i])] -= 1.0f / float(R);
+        }
+        }, [&] {
+            Tensor logits = x.detach();
+            logits.set_requires_grad(true);
+            ml::ops::cross_entropy(logits, targets).backward();
+        });
+
+    volatile float sink = out[0];
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,70 @@
+// tiny fixed-size matmul: StaticTensor versus ops::matmul on Tensor
+//
+// usage: bench_static [iterations]   (default 1M)
+//   each iteration multiplies the running product by a constant matrix, so
+//   the calls form a dependency chain and cannot be hoisted out of the loop
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/ops/matmul.hpp"
+#include "ml/tensor/static_tensor.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::StaticTensor;
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double ns_per_op(F&& fn, size_t iters) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto t0 = Clock::now();
+        fn(iters);
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best * 1e9 / double(iters);
+}
+
+template <size_t N>
+static void run(size_t iters) {
+    // a scaled rotation-like matrix keeps the running product bounded
+    StaticTensor<float, N, N> m;
+    for (size_t i = 0; i < N; ++i) m(i, (i + 1) % N) = 1.0f;
+    volatile float sink = 0.0f;
+
+    double t_static = ns_per_op([&](size_t n) {
+        auto acc = StaticTensor<float, N, N>::identity();
+        for (size_t i = 0; i < n; ++i) acc = ml::matmul(acc, m);
+        sink = acc(0, 0);
+        }, iters);
+
+    Tensor tm = m.as_tensor();
+    double t_tensor = ns_per_op([&](size_t n) {
+        auto ident = StaticTensor<float, N, N>::identity();
+        Tensor acc = ident.as_tensor().contiguous();
+        for (size_t i = 0; i < n; ++i) acc = ml::ops::matmul(acc, tm);
+        sink = acc.at({ 0, 0 });
+        }, iters);
+
+    std::cout << std::setw(3) << N << "x" << std::setw(2) << std::left << N << std::right
+        << std::fixed << std::setprecision(1)
+        << std::setw(14) << t_static
+        << std::setw(14) << t_tensor
+        << std::setw(9) << t_tensor / t_static << "x\n";
+    (void)sink;
+}
+
+int main(int argc, char** argv) {
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::cout << "iterations: " << iters << "\n";
+    std::cout << std::setw(5) << "n" << std::setw(14) << "static ns" << std::setw(14) << "Tensor ns"
+        << std::setw(10) << "speedup" << "\n";
+    run<3>(iters);
+    run<4>(iters);
+    run<8>(iters);
+    return 0;
+}
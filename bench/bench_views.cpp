@@ -0,0 +1,76 @@
+// cost of shape metadata: view creation and at() indexing
+//
+// usage: bench_views [iterations]   (default 10M)
+//   each view op runs on a small 4D tensor, so the time is almost entirely
+//   Tensor construction (sizes/strides copies + the shared_ptr refcount);
+//   at() is the checked scalar read on a transposed view, accessor<4>() the
+//   unchecked one
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+static double ns_per_op(F&& fn, size_t iters) {
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto t0 = Clock::now();
+        fn(iters);
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best * 1e9 / double(iters);
+}
+
+int main(int argc, char** argv) {
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    Tensor x = Tensor::ones({ 2, 3, 4, 5 });
+    Tensor xt = x.transpose(1, 3);
+
+    // sink keeps the loops from being optimized away
+    volatile size_t sink = 0;
+    volatile float fsink = 0.0f;
+
+    double t_transpose = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) sink = sink + x.transpose(0, 3).ndim();
+        }, iters);
+    double t_slice = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) sink = sink + x.slice(2, 1, 2).ndim();
+        }, iters);
+    double t_reshape = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) sink = sink + x.reshape({ 6, 20 }).ndim();
+        }, iters);
+    double t_chain = ns_per_op([&](size_t n) {
+        for (size_t i = 0; i < n; ++i) sink = sink + x.transpose(0, 1).slice(0, 1, 2).slice(3, 0, 4).ndim();
+        }, iters);
+    double t_at = ns_per_op([&](size_t n) {
+        float acc = 0.0f;
+        for (size_t i = 0; i < n; ++i) acc += xt.at({ 1, i % 5, 3, i % 3 });
+        fsink = acc;
+        }, iters);
+    double t_acc = ns_per_op([&](size_t n) {
+        auto a = xt.accessor<4>();
+        float acc = 0.0f;
+        for (size_t i = 0; i < n; ++i) acc += a(1, i % 5, 3, i % 3);
+        fsink = acc;
+        }, iters);
+
+    std::cout << "iterations: " << iters << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "transpose          " << std::setw(8) << t_transpose << " ns/op\n";
+    std::cout << "slice              " << std::setw(8) << t_slice << " ns/op\n";
+    std::cout << "reshape            " << std::setw(8) << t_reshape << " ns/op\n";
+    std::cout << "transpose+2xslice  " << std::setw(8) << t_chain << " ns/op\n";
+    std::cout << "at() on a view     " << std::setw(8) << t_at << " ns/op\n";
+    std::cout << "accessor on a view " << std::setw(8) << t_acc << " ns/op\n";
+    (void)sink;
+    (void)fsink;
+    return 0;
+}
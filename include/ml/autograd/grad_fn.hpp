@@ -1,17 +1,54 @@
 ﻿#pragma once
+#include <cstddef>
 #include <memory>
 #include <vector>
 
 namespace ml {
 
     class Tensor;
+    struct GradFn;
+
+    // autograd state of a tensor that requires grad, shared by the tensor
+    // and by the nodes that consumed it: tensors are move-only values, so
+    // this is how a node reaches its inputs
+    struct AutogradMeta {
+        AutogradMeta();
+        ~AutogradMeta();
+
+        // leaves: accumulated dL/dt; non-leaves: the incoming gradient while
+        // backward() runs
+        std::unique_ptr<Tensor> grad;
+        std::shared_ptr<GradFn> grad_fn;   // null for leaves
+    };
 
     // graph knows how to do backward for some op
     struct GradFn {
-        virtual ~GradFn() = default;
+        GradFn();
+        virtual ~GradFn();
+
+        // one entry per op input, null where the input needs no gradient
+        std::vector<std::shared_ptr<AutogradMeta>> inputs;
 
-        // grad_out = dL/d(this_output)
+        // grad_out = dL/d(this_output); hands dL/d(input i) to accumulate(i, ...)
         virtual void backward(const Tensor& grad_out) = 0;
+
+        // drops the saved tensors; Tensor::backward() calls it once the node
+        // has run (unless the graph is retained), so activations are freed
+        // as early as possible and a second backward through the node throws
+        void release();
+        bool released() const { return released_; }
+
+    protected:
+        // inputs[i]->grad += g, in place once the grad exists (g must have
+        // the input's shape); nothing for a null input
+        void accumulate(size_t i, Tensor g);
+
+        // what backward() reads (detached views or results), kept in one
+        // place so that release() can free them
+        std::vector<Tensor> saved;
+
+    private:
+        bool released_{ false };
     };
 
 } // namespace ml
@@ -0,0 +1,72 @@
+#pragma once
+
+// thread-local switches for graph recording
+//     {
+//         ml::NoGradGuard no_grad;   // ops record no nodes on this thread
+//         Tensor y = model(x);       // ...even if parameters require grad
+//     }                              // previous mode restored here
+// both guards affect the thread that creates them, and the ranges of the
+// parallel_for calls it makes meanwhile (workers take on the caller's mode
+// for each task); they nest: each one restores what it found
+
+namespace ml {
+
+    // false while a NoGradGuard or InferenceMode is alive on this thread:
+    // ops and views then skip GradFn creation, their results do not
+    // require grad
+    bool grad_enabled();
+
+    // true while an InferenceMode is alive on this thread
+    bool inference_mode_enabled();
+
+    namespace detail {
+
+        // both flags, for handing a thread's mode to the pool workers
+        struct GradModeState {
+            bool grad;
+            bool inference;
+        };
+
+        GradModeState grad_mode_state();
+
+        // `state` on this thread for the scope's lifetime
+        class GradModeScope {
+        public:
+            explicit GradModeScope(GradModeState state);
+            ~GradModeScope();
+            GradModeScope(const GradModeScope&) = delete;
+            GradModeScope& operator=(const GradModeScope&) = delete;
+
+        private:
+            GradModeState prev_;
+        };
+
+    } // namespace detail
+
+    class NoGradGuard {
+    public:
+        NoGradGuard();
+        ~NoGradGuard();
+        NoGradGuard(const NoGradGuard&) = delete;
+        NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+    private:
+        bool prev_;
+    };
+
+    // no grad, and every tensor created meanwhile (views included) is an
+    // inference tensor: it can never require grad, so views of it skip the
+    // graph checks for good, also after the mode has ended
+    // for serving code that never calls backward()
+    class InferenceMode {
+    public:
+        InferenceMode();
+        ~InferenceMode();
+        InferenceMode(const InferenceMode&) = delete;
+        InferenceMode& operator=(const InferenceMode&) = delete;
+
+    private:
+        bool prev_grad_, prev_inference_;
+    };
+
+} // namespace ml
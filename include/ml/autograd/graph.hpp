@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "ml/autograd/grad_fn.hpp"
+#include "ml/autograd/grad_mode.hpp"
+#include "ml/tensor/tensor.hpp"
+
+// helpers for ops that record graph nodes
+//     if (autograd::needs_grad({ &x })) {
+//         auto node = std::make_shared<SoftmaxBackward>(...);
+//         autograd::record(out, std::move(node), { &x });
+//     }
+
+namespace ml::autograd {
+
+    // true if an op on these inputs has to record a node: grad mode is on
+    // (no NoGradGuard / InferenceMode) and some input requires grad
+    inline bool needs_grad(std::initializer_list<const Tensor*> inputs) {
+        if (!grad_enabled()) return false;
+        for (const Tensor* t : inputs) {
+            if (t && t->requires_grad()) return true;
+        }
+        return false;
+    }
+
+    template <size_t K>
+    bool needs_grad(const std::array<const Tensor*, K>& inputs) {
+        if (!grad_enabled()) return false;
+        for (const Tensor* t : inputs) {
+            if (t && t->requires_grad()) return true;
+        }
+        return false;
+    }
+
+    // node gets one input entry per tensor (null for null pointers and for
+    // tensors that need no grad) and becomes out's grad_fn
+    inline void record(Tensor& out, std::shared_ptr<GradFn> node, std::initializer_list<const Tensor*> inputs) {
+        node->inputs.clear();
+        for (const Tensor* t : inputs) {
+            node->inputs.push_back(t && t->requires_grad() ? t->autograd_meta() : nullptr);
+        }
+        out.set_grad_fn(std::move(node));
+    }
+
+    template <size_t K>
+    void record(Tensor& out, std::shared_ptr<GradFn> node, const std::array<const Tensor*, K>& inputs) {
+        node->inputs.clear();
+        for (const Tensor* t : inputs) {
+            node->inputs.push_back(t && t->requires_grad() ? t->autograd_meta() : nullptr);
+        }
+        out.set_grad_fn(std::move(node));
+    }
+
+    // g summed over the dims broadcasting added to an input of these sizes
+    // (leading dims, size-1 dims that were expanded); g itself when none
+    Tensor sum_to(const Tensor& g, const Shape& sizes);
+
+} // namespace ml::autograd
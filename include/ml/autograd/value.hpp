@@ -1,165 +1,214 @@
 #pragma once
 #include <cmath>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <unordered_set>
+#include <stdexcept>
 #include <utility>
 #include <vector>
-#include <stdexcept>
 
 namespace ml::autograd {
 
-    // Forward declaration
     struct Value;
-    using V = std::shared_ptr<Value>;
 
-    // one node for scalar
+    // what produced a node; backward() switches on it
+    enum class Op : uint8_t { Leaf, Add, Sub, Mul, Div, Relu, Exp, Log };
+
+    // handle to a node (one pointer, free to copy); a class, not Value*, so
+    // that x * y can be an operator
+    struct V {
+        Value* node = nullptr;
+
+        Value* operator->() const { return node; }
+        Value& operator*() const { return *node; }
+        explicit operator bool() const { return node != nullptr; }
+    };
+
+    // one node for scalar: plain data, no destructor, no heap of its own
     struct Value {
         double data = 0.0;   // forward value
         double grad = 0.0;   // d(loss)/d(this)
 
-        // parents in node
-        std::vector<V> parents;
-
-        // local backwards: how to give backward to parents
-        // catch pointers for backward
-        std::function<void()> backward_fn;
-
-        explicit Value(double v) : data(v) {}
+        // inputs in node, inline (null past the op's arity)
+        Value* parents[2] = { nullptr, nullptr };
+        Op op = Op::Leaf;
+        bool visited = false;   // backward() scratch, false between calls
 
         // ====== API creation ======
-        static V make(double v) { return std::make_shared<Value>(v); }
+        // a leaf in the current arena (see Arena below)
+        static V make(double v);
 
         // ====== backward start ======
-        void backward() {
-            // 1) topologic sort
-            std::vector<Value*> topo;
-            std::unordered_set<Value*> visited;
-            topo_sort(this, topo, visited);
-
-            // 2) start dl/dl = 1
-            grad = 1.0;
-
-            // 3) go backwards
-            for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
-                Value* node = *it;
-                if (node->backward_fn) node->backward_fn();
-            }
+        void backward();
+    };
+
+    // node pool: nodes are carved from fixed-size blocks with a bump
+    // pointer, so building a graph never calls the allocator once the
+    // blocks exist, and the graph is freed in one go:
+    //     for (...) {                  // training step
+    //         auto loss = model(x);
+    //         loss->backward();
+    //         ... read the parameter grads ...
+    //         arena.clear();            // every node of the step, O(1)
+    //     }
+    // nodes live until clear() or the arena's destruction, whatever handles
+    // remain: handles into a cleared arena dangle
+    // without an ArenaScope, nodes go to a per-thread default arena that is
+    // never cleared on its own: code that builds graph after graph without
+    // a scope must call Arena::current().clear() between them (once their
+    // handles are no longer used) or its memory keeps growing
+    class Arena {
+    public:
+        explicit Arena(size_t block_nodes = 4096) : block_nodes_(block_nodes ? block_nodes : 1) {}
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        Value* alloc(double data, Op op, Value* a = nullptr, Value* b = nullptr) {
+            if (used_ == block_nodes_ || blocks_.empty()) next_block();
+            Value* v = blocks_[block_].get() + used_++;
+            v->data = data;
+            v->grad = 0.0;
+            v->parents[0] = a;
+            v->parents[1] = b;
+            v->op = op;
+            v->visited = false;
+            return v;
+        }
+
+        // drops every node; the blocks stay for the next graph
+        void clear() {
+            block_ = 0;
+            used_ = 0;
         }
 
+        // nodes alive
+        size_t size() const { return blocks_.empty() ? 0 : block_ * block_nodes_ + used_; }
+        // nodes the blocks hold, alive or not
+        size_t capacity() const { return blocks_.size() * block_nodes_; }
+
+        // the arena Value::make and the ops allocate from on this thread: a
+        // thread-local default unless an ArenaScope is active
+        static Arena& current() { return *current_ptr(); }
+
     private:
-        static void topo_sort(Value* v,
-            std::vector<Value*>& topo,
-            std::unordered_set<Value*>& visited) {
-            if (visited.count(v)) return;
-            visited.insert(v);
-            for (auto& p : v->parents) {
-                topo_sort(p.get(), topo, visited);
-            }
-            topo.push_back(v);
+        friend class ArenaScope;
+
+        static Arena*& current_ptr() {
+            static thread_local Arena fallback;
+            static thread_local Arena* current = &fallback;
+            return current;
+        }
+
+        void next_block() {
+            if (!blocks_.empty()) ++block_;
+            if (block_ == blocks_.size()) blocks_.push_back(std::make_unique<Value[]>(block_nodes_));
+            used_ = 0;
         }
+
+        size_t block_nodes_;
+        std::vector<std::unique_ptr<Value[]>> blocks_;
+        size_t block_ = 0;   // block being filled
+        size_t used_ = 0;    // nodes taken from it
     };
 
-    // ====== Ops (forward and backward) ======
-
-    inline V add(const V& a, const V& b) {
-        auto out = Value::make(a->data + b->data);
-        out->parents = { a, b };
-
-        // local df:
-        // out = a + b
-        // dL/da += dL/dout * 1
-        // dL/db += dL/dout * 1
-        out->backward_fn = [out, a, b]() {
-            a->grad += 1.0 * out->grad;
-            b->grad += 1.0 * out->grad;
-            };
-        return out;
-    }
+    // makes `arena` the current one on this thread until the scope ends
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& arena) : prev_(Arena::current_ptr()) { Arena::current_ptr() = &arena; }
+        ~ArenaScope() { Arena::current_ptr() = prev_; }
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
 
-    inline V sub(const V& a, const V& b) {
-        auto out = Value::make(a->data - b->data);
-        out->parents = { a, b };
-        // out = a - b
-        // dL/da += dL/dout
-        // dL/db += -dL/dout
-        out->backward_fn = [out, a, b]() {
-            a->grad += 1.0 * out->grad;
-            b->grad += -1.0 * out->grad;
-            };
-        return out;
-    }
+    private:
+        Arena* prev_;
+    };
 
-    inline V mul(const V& a, const V& b) {
-        auto out = Value::make(a->data * b->data);
-        out->parents = { a, b };
-
-        // out = a * b
-        // dL/da += dL/dout * b
-        // dL/db += dL/dout * a
-        out->backward_fn = [out, a, b]() {
-            a->grad += b->data * out->grad;
-            b->grad += a->data * out->grad;
-            };
-        return out;
-    }
+    inline V Value::make(double v) { return { Arena::current().alloc(v, Op::Leaf) }; }
+
+    inline void Value::backward() {
+        // 1) topologic sort: explicit stack (deep chains do not recurse),
+        //    inputs before their consumers; both buffers are kept per
+        //    thread, so repeated backward() calls do not reallocate them
+        static thread_local std::vector<Value*> topo;
+        static thread_local std::vector<std::pair<Value*, int>> stack;
+        topo.clear();
+        stack.assign(1, { this, 0 });
+        visited = true;
+        while (!stack.empty()) {
+            auto& [v, next] = stack.back();
+            if (next < 2 && v->parents[next]) {
+                Value* p = v->parents[next++];
+                if (!p->visited) {
+                    p->visited = true;
+                    stack.push_back({ p, 0 });
+                }
+                continue;
+            }
+            topo.push_back(v);
+            stack.pop_back();
+        }
 
-    inline V div(const V& a, const V& b) {
-        auto out = Value::make(a->data / b->data);
-        out->parents = { a, b };
-
-        // out = a / b
-        // d(out)/da = 1/b
-        // d(out)/db = -a/(b^2)
-        out->backward_fn = [out, a, b]() {
-            a->grad += (1.0 / b->data) * out->grad;
-            b->grad += (-a->data / (b->data * b->data)) * out->grad;
-            };
-        return out;
+        // 2) start dl/dl = 1
+        grad = 1.0;
+
+        // 3) go backwards: each node hands its grad to its inputs
+        for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+            Value* out = *it;
+            out->visited = false;
+            Value* a = out->parents[0];
+            Value* b = out->parents[1];
+            const double g = out->grad;
+            switch (out->op) {
+            case Op::Leaf:
+                break;
+            case Op::Add:   // out = a + b
+                a->grad += g;
+                b->grad += g;
+                break;
+            case Op::Sub:   // out = a - b
+                a->grad += g;
+                b->grad -= g;
+                break;
+            case Op::Mul:   // out = a * b
+                a->grad += b->data * g;
+                b->grad += a->data * g;
+                break;
+            case Op::Div:   // out = a / b: 1/b, -a/(b^2)
+                a->grad += (1.0 / b->data) * g;
+                b->grad += (-a->data / (b->data * b->data)) * g;
+                break;
+            case Op::Relu:  // out = max(0, a)
+                a->grad += a->data > 0.0 ? g : 0.0;
+                break;
+            case Op::Exp:   // out = exp(a): dout/da = out
+                a->grad += out->data * g;
+                break;
+            case Op::Log:   // out = log(a): dout/da = 1/a
+                a->grad += (1.0 / a->data) * g;
+                break;
+            }
+        }
     }
 
-    inline V relu(const V& x) {
-        auto out = Value::make(x->data > 0.0 ? x->data : 0.0);
-        out->parents = { x };
-
-        // out = max(0, x)
-        // dout/dx = 1 if x>0, else 0
-        out->backward_fn = [out, x]() {
-            double mask = (x->data > 0.0) ? 1.0 : 0.0;
-            x->grad += mask * out->grad;
-            };
-        return out;
-    }
+    // ====== Ops (forward; backward is Value::backward's switch) ======
 
-    inline V exp(const V& x) {
-        auto out = Value::make(std::exp(x->data));
-        out->parents = { x };
+    inline V add(V a, V b) { return { Arena::current().alloc(a->data + b->data, Op::Add, a.node, b.node) }; }
+    inline V sub(V a, V b) { return { Arena::current().alloc(a->data - b->data, Op::Sub, a.node, b.node) }; }
+    inline V mul(V a, V b) { return { Arena::current().alloc(a->data * b->data, Op::Mul, a.node, b.node) }; }
+    inline V div(V a, V b) { return { Arena::current().alloc(a->data / b->data, Op::Div, a.node, b.node) }; }
 
-        // out = exp(x)
-        // dout/dx = exp(x) = out
-        out->backward_fn = [out, x]() {
-            x->grad += out->data * out->grad;
-            };
-        return out;
-    }
+    inline V relu(V x) { return { Arena::current().alloc(x->data > 0.0 ? x->data : 0.0, Op::Relu, x.node) }; }
+    inline V exp(V x) { return { Arena::current().alloc(std::exp(x->data), Op::Exp, x.node) }; }
 
-    inline V log(const V& x) {
+    inline V log(V x) {
         if (x->data <= 0.0) throw std::runtime_error("log(): x must be > 0");
-        auto out = Value::make(std::log(x->data));
-        out->parents = { x };
-
-        // out = log(x)
-        // dout/dx = 1/x
-        out->backward_fn = [out, x]() {
-            x->grad += (1.0 / x->data) * out->grad;
-            };
-        return out;
+        return { Arena::current().alloc(std::log(x->data), Op::Log, x.node) };
     }
 
     // useful operators
-    inline V operator+(const V& a, const V& b) { return add(a, b); }
-    inline V operator-(const V& a, const V& b) { return sub(a, b); }
-    inline V operator*(const V& a, const V& b) { return mul(a, b); }
-    inline V operator/(const V& a, const V& b) { return div(a, b); }
+    inline V operator+(V a, V b) { return add(a, b); }
+    inline V operator-(V a, V b) { return sub(a, b); }
+    inline V operator*(V a, V b) { return mul(a, b); }
+    inline V operator/(V a, V b) { return div(a, b); }
 
 } // namespace ml::autograd
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+namespace ml::core {
+
+    // size-class caching allocator behind Storage
+    //
+    // blocks are kAllocAlignment aligned and uninitialized
+    // freed blocks are parked in a per-thread cache keyed by size class
+    // (4 classes per power of two, so at most 25% slack) and handed back on
+    // the next request of the same class; the same shapes allocated and freed
+    // in a loop stop reaching malloc after the first iteration
+    // blocks cached by a thread are moved to a shared pool when it exits
+    // once the cached total would exceed the cache limit, freed blocks go
+    // straight back to the OS
+
+    // every block starts on a cache line (and a full AVX-512 vector)
+    constexpr size_t kAllocAlignment = 64;
+
+    struct AllocatorStats {
+        size_t hits;           // requests served from a cache
+        size_t misses;         // requests that went to the system allocator
+        size_t bytes_cached;   // bytes parked in caches right now
+        size_t bytes_in_use;   // bytes handed out and not yet freed
+    };
+
+    void* cached_alloc(size_t bytes);
+    void cached_free(void* p, size_t bytes);
+
+    AllocatorStats allocator_stats();
+    void reset_allocator_stats();        // zeroes hits/misses only
+
+    // release every cached block (calling thread + shared pool) to the OS
+    void empty_allocator_cache();
+
+    // upper bound on bytes_cached, 0 disables caching
+    // default: ML_ALLOC_CACHE_LIMIT (bytes) if set, else 1 GiB
+    void set_allocator_cache_limit(size_t bytes);
+    size_t allocator_cache_limit();
+
+    // std allocator adapter
+    template <class T>
+    struct CachingAllocator {
+        using value_type = T;
+
+        CachingAllocator() = default;
+        template <class U>
+        CachingAllocator(const CachingAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(cached_alloc(n * sizeof(T)));
+        }
+        void deallocate(T* p, size_t n) noexcept {
+            cached_free(p, n * sizeof(T));
+        }
+
+        template <class U>
+        bool operator==(const CachingAllocator<U>&) const noexcept { return true; }
+        template <class U>
+        bool operator!=(const CachingAllocator<U>&) const noexcept { return false; }
+    };
+
+} // namespace ml::core
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace ml::core {
+
+    // SIMD level used by the kernel dispatch, ordered from weakest to strongest
+    enum class CpuLevel {
+        Scalar = 0,
+        AVX2 = 1,     // AVX2 + FMA + F16C
+        AVX512 = 2,   // AVX-512F
+        AVX512VNNI = 3,   // AVX-512F/BW/VL + VNNI (int8 dot products)
+    };
+
+    // best level this CPU and OS support (CPUID + XGETBV)
+    CpuLevel detected_cpu_level();
+
+    // level the kernels actually run at, fixed on first call
+    // ML_CPU_LEVEL=scalar|avx2|avx512|avx512vnni caps it (never raises it above detected)
+    CpuLevel cpu_level();
+
+    const char* cpu_level_name(CpuLevel level);
+
+} // namespace ml::core
@@ -0,0 +1,193 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "ml/core/error.hpp"
+
+namespace ml::core {
+
+    // element type of a Storage (and of every tensor viewing it)
+    enum class DType : uint8_t {
+        Float32 = 0,
+        Float64,
+        Float16,    // IEEE binary16
+        BFloat16,   // upper half of a float32
+        Int32,
+        Int8,
+        UInt8,      // quantized activations
+    };
+
+    size_t dtype_size(DType dt);
+    const char* dtype_name(DType dt);
+
+    // ---- scalar 16-bit float conversions (round to nearest even) ----
+    // the vectorized versions live in the kernel tables
+
+    inline uint16_t float_to_bf16_bits(float f) {
+        uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+        if ((x & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<uint16_t>((x >> 16) | 0x40u);   // NaN stays (quiet) NaN
+        }
+        x += 0x7fffu + ((x >> 16) & 1u);
+        return static_cast<uint16_t>(x >> 16);
+    }
+
+    inline float bf16_bits_to_float(uint16_t h) {
+        uint32_t x = static_cast<uint32_t>(h) << 16;
+        float f;
+        std::memcpy(&f, &x, sizeof(f));
+        return f;
+    }
+
+    inline uint16_t float_to_half_bits(float f) {
+        uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+        const uint32_t sign = (x >> 16) & 0x8000u;
+        const uint32_t exp = (x >> 23) & 0xffu;
+        uint32_t man = x & 0x7fffffu;
+
+        if (exp == 0xffu) {
+            // inf, or NaN with the top payload bits and the quiet bit set
+            return static_cast<uint16_t>(sign | 0x7c00u | (man ? 0x200u | (man >> 13) : 0u));
+        }
+        const int e = static_cast<int>(exp) - 127 + 15;
+        if (e >= 31) return static_cast<uint16_t>(sign | 0x7c00u);   // overflow -> inf
+        if (e <= 0) {
+            // subnormal half (or zero): value = m * 2^-24
+            if (e < -10) return static_cast<uint16_t>(sign);
+            man |= 0x800000u;
+            const uint32_t shift = static_cast<uint32_t>(14 - e);
+            uint32_t h = man >> shift;
+            const uint32_t rem = man & ((1u << shift) - 1u);
+            const uint32_t half = 1u << (shift - 1);
+            if (rem > half || (rem == half && (h & 1u))) ++h;
+            return static_cast<uint16_t>(sign | h);
+        }
+        uint32_t h = (static_cast<uint32_t>(e) << 10) | (man >> 13);
+        const uint32_t rem = man & 0x1fffu;
+        if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h;   // a carry rounds up to inf
+        return static_cast<uint16_t>(sign | h);
+    }
+
+    inline float half_bits_to_float(uint16_t h) {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+        const uint32_t exp = (h >> 10) & 0x1fu;
+        uint32_t man = h & 0x3ffu;
+        uint32_t x;
+        if (exp == 0x1fu) {
+            x = sign | 0x7f800000u | (man << 13);
+        }
+        else if (exp == 0) {
+            if (man == 0) {
+                x = sign;
+            }
+            else {
+                // subnormal: shift until the implicit bit appears
+                int e = -1;
+                do {
+                    ++e;
+                    man <<= 1;
+                } while (!(man & 0x400u));
+                x = sign | (static_cast<uint32_t>(112 - e) << 23) | ((man & 0x3ffu) << 13);
+            }
+        }
+        else {
+            x = sign | ((exp + 112u) << 23) | (man << 13);
+        }
+        float f;
+        std::memcpy(&f, &x, sizeof(f));
+        return f;
+    }
+
+    // 16-bit float element types: storage only, arithmetic goes through float
+    struct Half {
+        uint16_t bits;
+
+        Half() = default;
+        explicit Half(float f) : bits(float_to_half_bits(f)) {}
+        explicit operator float() const { return half_bits_to_float(bits); }
+    };
+
+    struct BFloat16 {
+        uint16_t bits;
+
+        BFloat16() = default;
+        explicit BFloat16(float f) : bits(float_to_bf16_bits(f)) {}
+        explicit operator float() const { return bf16_bits_to_float(bits); }
+    };
+
+    // ---- C++ type <-> DType ----
+    template <class T> struct dtype_of;
+    template <> struct dtype_of<float> { static constexpr DType value = DType::Float32; };
+    template <> struct dtype_of<double> { static constexpr DType value = DType::Float64; };
+    template <> struct dtype_of<Half> { static constexpr DType value = DType::Float16; };
+    template <> struct dtype_of<BFloat16> { static constexpr DType value = DType::BFloat16; };
+    template <> struct dtype_of<int32_t> { static constexpr DType value = DType::Int32; };
+    template <> struct dtype_of<int8_t> { static constexpr DType value = DType::Int8; };
+    template <> struct dtype_of<uint8_t> { static constexpr DType value = DType::UInt8; };
+
+    template <class T>
+    constexpr DType dtype_v = dtype_of<T>::value;
+
+    template <class T>
+    constexpr bool is_reduced_float_v = std::is_same_v<T, Half> || std::is_same_v<T, BFloat16>;
+
+    // type arithmetic is done in: float for the 16-bit floats, int64_t for
+    // integers (the narrowing store wraps, no signed overflow), T otherwise
+    template <class T>
+    using compute_t = std::conditional_t<is_reduced_float_v<T>, float,
+        std::conditional_t<std::is_integral_v<T>, int64_t, T>>;
+
+    // value conversion between element types
+    // 16-bit floats go through float; float -> int truncates toward zero and
+    // saturates (NaN -> 0), int -> narrower int saturates
+    template <class To, class From>
+    To convert_value(From v) {
+        if constexpr (std::is_same_v<To, From>) {
+            return v;
+        }
+        else if constexpr (is_reduced_float_v<From>) {
+            return convert_value<To>(static_cast<float>(v));
+        }
+        else if constexpr (is_reduced_float_v<To>) {
+            return To(static_cast<float>(v));
+        }
+        else if constexpr (std::is_integral_v<To>) {
+            const double d = static_cast<double>(v);
+            if (d != d) return To(0);
+            if (d <= static_cast<double>(std::numeric_limits<To>::min())) return std::numeric_limits<To>::min();
+            if (d >= static_cast<double>(std::numeric_limits<To>::max())) return std::numeric_limits<To>::max();
+            return static_cast<To>(d);
+        }
+        else {
+            return static_cast<To>(v);
+        }
+    }
+
+    // ---- runtime dispatch ----
+    template <class T>
+    struct TypeTag {
+        using type = T;
+    };
+
+    // f(TypeTag<T>{}) for the C++ type of dt; every branch must return the same type
+    //     dispatch_dtype(t.dtype(), [&](auto tag) { using T = typename decltype(tag)::type; ... });
+    template <class F>
+    decltype(auto) dispatch_dtype(DType dt, F&& f) {
+        switch (dt) {
+        case DType::Float32:  return f(TypeTag<float>{});
+        case DType::Float64:  return f(TypeTag<double>{});
+        case DType::Float16:  return f(TypeTag<Half>{});
+        case DType::BFloat16: return f(TypeTag<BFloat16>{});
+        case DType::Int32:    return f(TypeTag<int32_t>{});
+        case DType::Int8:     return f(TypeTag<int8_t>{});
+        case DType::UInt8:    return f(TypeTag<uint8_t>{});
+        }
+        fail("dispatch_dtype: unknown dtype", __FILE__, __LINE__);
+    }
+
+} // namespace ml::core
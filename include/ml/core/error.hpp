@@ -5,7 +5,7 @@
 
 namespace ml::core {
 
-    inline [[noreturn]] void fail(const std::string& msg,
+    [[noreturn]] inline void fail(const std::string& msg,
         const char* file,
         int line) {
         std::ostringstream oss;
@@ -28,4 +28,28 @@ namespace ml::core {
 #define ML_CHECK_LT(a, b, msg) \
     do { \
         if (!((a) < (b))) ::ml::core::fail((msg), __FILE__, __LINE__); \
-    } while (0)
\ No newline at end of file
+    } while (0)
+
+// ML_DCHECK*: internal invariants on hot paths (things the library itself
+// guarantees, not user input); compiled out when NDEBUG is defined, unless
+// the build keeps them (MLCPP_STRIP_DCHECKS=OFF defines ML_KEEP_DCHECKS)
+// API-boundary validation always uses ML_CHECK*
+#if defined(NDEBUG) && !defined(ML_KEEP_DCHECKS)
+#define ML_DCHECKS_ENABLED 0
+#else
+#define ML_DCHECKS_ENABLED 1
+#endif
+
+#if ML_DCHECKS_ENABLED
+#define ML_DCHECK(cond, msg) ML_CHECK(cond, msg)
+#define ML_DCHECK_EQ(a, b, msg) ML_CHECK_EQ(a, b, msg)
+#define ML_DCHECK_LT(a, b, msg) ML_CHECK_LT(a, b, msg)
+#else
+// unevaluated: no code, but the expression still has to compile
+#define ML_DCHECK(cond, msg) \
+    do { (void)sizeof(!(cond)); } while (0)
+#define ML_DCHECK_EQ(a, b, msg) \
+    do { (void)sizeof((a) == (b)); } while (0)
+#define ML_DCHECK_LT(a, b, msg) \
+    do { (void)sizeof((a) < (b)); } while (0)
+#endif
@@ -2,23 +2,36 @@
 #include <cstddef>
 #include <vector>
 
+#include "ml/core/small_vector.hpp"
+
 namespace ml::core {
 
+    // max tensor rank: sizes/strides live inline, so views never allocate
+    constexpr size_t kMaxDims = 8;
+
+    // sizes or strides of a tensor
+    using Shape = SmallVector<size_t, kMaxDims>;
+
     // number of elements
     // [] -> 1 (scalar)
-    size_t numel(const std::vector<size_t>& sizes);
+    size_t numel(const Shape& sizes);
 
     // compute row-major contiguous strides
     // sizes [2,3,4] -> strides [12,4,1]
-    std::vector<size_t> contiguous_strides(const std::vector<size_t>& sizes);
+    Shape contiguous_strides(const Shape& sizes);
 
     // true if strides match contiguous_strides(sizes)
-    bool is_contiguous(const std::vector<size_t>& sizes,
-        const std::vector<size_t>& strides);
+    bool is_contiguous(const Shape& sizes,
+        const Shape& strides);
 
     // offset + sum(indices[d] * strides[d])
     size_t linear_index(size_t offset,
-        const std::vector<size_t>& strides,
-        const std::vector<size_t>& indices);
+        const Shape& strides,
+        const Shape& indices);
+
+    // NumPy broadcasting: align trailing dims, each pair must match or be 1
+    // [B,N] x [N] -> [B,N], [B,1] x [1,N] -> [B,N]
+    Shape broadcast_shapes(const Shape& a,
+        const Shape& b);
 
 } // namespace ml::core
@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "ml/core/error.hpp"
+
+namespace ml::core {
+
+    // fixed-capacity vector with inline storage: no heap, copying is a memcpy
+    // of N elements; going past N throws
+    // used for shape metadata, where rank is small and views are created often
+    template <class T, size_t N>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector: T must be trivially copyable");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        SmallVector() = default;
+
+        explicit SmallVector(size_t n, const T& v = T()) { resize(n, v); }
+
+        SmallVector(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+        template <class It, class = std::enable_if_t<!std::is_integral_v<It>>>
+        SmallVector(It first, It last) { assign(first, last); }
+
+        // implicit: existing std::vector call sites keep working
+        SmallVector(const std::vector<T>& v) { assign(v.begin(), v.end()); }
+
+        template <class It>
+        void assign(It first, It last) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            ML_CHECK(n <= N, "SmallVector: capacity exceeded");
+            std::copy(first, last, data_);
+            size_ = n;
+        }
+
+        static constexpr size_t capacity() { return N; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        T* data() { return data_; }
+        const T* data() const { return data_; }
+
+        T& operator[](size_t i) { return data_[i]; }
+        const T& operator[](size_t i) const { return data_[i]; }
+
+        T& front() { return data_[0]; }
+        const T& front() const { return data_[0]; }
+        T& back() { return data_[size_ - 1]; }
+        const T& back() const { return data_[size_ - 1]; }
+
+        iterator begin() { return data_; }
+        iterator end() { return data_ + size_; }
+        const_iterator begin() const { return data_; }
+        const_iterator end() const { return data_ + size_; }
+
+        void push_back(const T& v) {
+            ML_CHECK(size_ < N, "SmallVector: capacity exceeded");
+            data_[size_++] = v;
+        }
+        void pop_back() { --size_; }
+        void clear() { size_ = 0; }
+
+        void resize(size_t n, const T& v = T()) {
+            ML_CHECK(n <= N, "SmallVector: capacity exceeded");
+            for (size_t i = size_; i < n; ++i) data_[i] = v;
+            size_ = n;
+        }
+
+        std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+        friend bool operator==(const SmallVector& a, const SmallVector& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+        friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+
+        friend bool operator==(const SmallVector& a, const std::vector<T>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+        friend bool operator==(const std::vector<T>& a, const SmallVector& b) { return b == a; }
+        friend bool operator!=(const SmallVector& a, const std::vector<T>& b) { return !(a == b); }
+        friend bool operator!=(const std::vector<T>& a, const SmallVector& b) { return !(b == a); }
+
+    private:
+        T data_[N]{};
+        size_t size_{ 0 };
+    };
+
+} // namespace ml::core
@@ -1,27 +1,86 @@
 #pragma once
-#include <vector>
 #include <cstddef>
 
+#include "ml/core/allocator.hpp"
+#include "ml/core/dtype.hpp"
+#include "ml/core/error.hpp"
+
 namespace ml::core {
 
+    // flat typed buffer shared by a tensor and its views
+    // memory comes from the caching allocator, is kAllocAlignment (64 byte)
+    // aligned and is NOT initialized: factories that need values fill it
+    // size() counts elements of dtype(), not bytes
     struct Storage {
-        std::vector<float> data;
+        explicit Storage(size_t n, DType dtype = DType::Float32)
+            : data_(cached_alloc(n * dtype_size(dtype))),
+            size_(n),
+            dtype_(dtype) {
+        }
 
-        explicit Storage(size_t n)
-            : data(n) {
+        // borrowed: wraps memory owned elsewhere (Tensor::from_blob), never freed
+        // here and not necessarily aligned
+        struct Borrowed {};
+        Storage(void* external, size_t n, DType dtype, Borrowed)
+            : data_(external),
+            size_(n),
+            dtype_(dtype),
+            owned_(false) {
         }
 
+        ~Storage() {
+            if (owned_) cached_free(data_, nbytes());
+        }
+
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+
         size_t size() const {
-            return data.size();
+            return size_;
+        }
+
+        size_t nbytes() const {
+            return size_ * dtype_size(dtype_);
+        }
+
+        DType dtype() const {
+            return dtype_;
         }
 
+        void* raw() {
+            return data_;
+        }
+
+        const void* raw() const {
+            return data_;
+        }
+
+        template <class T>
+        T* data() {
+            ML_DCHECK(dtype_ == dtype_v<T>, "Storage: dtype mismatch");
+            return static_cast<T*>(data_);
+        }
+
+        template <class T>
+        const T* data() const {
+            ML_DCHECK(dtype_ == dtype_v<T>, "Storage: dtype mismatch");
+            return static_cast<const T*>(data_);
+        }
+
+        // float32 storage
         float* ptr() {
-            return data.data();
+            return data<float>();
         }
 
         const float* ptr() const {
-            return data.data();
+            return data<float>();
         }
+
+    private:
+        void* data_;
+        size_t size_;
+        DType dtype_;
+        bool owned_{ true };
     };
 
 } // namespace ml::core
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+#include "ml/core/error.hpp"
+#include "ml/core/shape.hpp"
+
+namespace ml::core {
+
+    // walks N operands that share one logical shape, each with its own strides
+    //
+    // adjacent dims are coalesced when every operand is contiguous across them,
+    // so a contiguous tensor becomes one flat row and a [B,N] + [N] broadcast
+    // stays two dims; size-1 dims are dropped
+    // the loop body sees one row at a time: the element offset of each operand
+    // and the row length, with the innermost strides hoisted out
+    //   (inner_stride(k) is the step of operand k inside a row)
+    template <size_t N>
+    class StridedLoop {
+    public:
+        StridedLoop(const Shape& sizes,
+            const std::array<const Shape*, N>& strides) {
+            for (size_t k = 0; k < N; ++k) {
+                ML_DCHECK_EQ(strides[k]->size(), sizes.size(), "StridedLoop: rank mismatch");
+            }
+
+            for (size_t d = 0; d < sizes.size(); ++d) {
+                if (sizes[d] == 1) continue;
+
+                bool merge = !sizes_.empty();
+                for (size_t k = 0; k < N && merge; ++k) {
+                    merge = strides_[k].back() == (*strides[k])[d] * sizes[d];
+                }
+
+                if (merge) {
+                    // previous dim is contiguous over this one: fold them
+                    sizes_.back() *= sizes[d];
+                    for (size_t k = 0; k < N; ++k) strides_[k].back() = (*strides[k])[d];
+                }
+                else {
+                    sizes_.push_back(sizes[d]);
+                    for (size_t k = 0; k < N; ++k) strides_[k].push_back((*strides[k])[d]);
+                }
+            }
+
+            // scalar or all-ones shape: one row of one element
+            if (sizes_.empty()) {
+                sizes_.push_back(1);
+                for (size_t k = 0; k < N; ++k) strides_[k].push_back(0);
+            }
+
+            numel_ = 1;
+            for (size_t s : sizes_) numel_ *= s;
+        }
+
+        size_t ndim() const { return sizes_.size(); }
+        size_t numel() const { return numel_; }
+        size_t inner_size() const { return sizes_.back(); }
+        size_t inner_stride(size_t k) const { return strides_[k].back(); }
+
+        // fn(offsets, n) for the elements [e0, e1) in row-major logical order;
+        // rows are cut at e0/e1 so the range can come from parallel_for
+        template <class F>
+        void for_range(size_t e0, size_t e1, F&& fn) const {
+            if (e0 >= e1) return;
+
+            const size_t nd = sizes_.size();
+            const size_t inner = sizes_[nd - 1];
+
+            // flat index -> outer index + column
+            size_t col = e0 % inner;
+            size_t rest = e0 / inner;
+            std::array<size_t, N> row{};
+            Shape idx(nd, 0);
+            for (size_t d = nd - 1; d-- > 0; ) {
+                idx[d] = rest % sizes_[d];
+                rest /= sizes_[d];
+                for (size_t k = 0; k < N; ++k) row[k] += idx[d] * strides_[k][d];
+            }
+
+            std::array<size_t, N> offs;
+            for (size_t e = e0; e < e1; ) {
+                size_t n = inner - col;
+                if (n > e1 - e) n = e1 - e;
+                for (size_t k = 0; k < N; ++k) offs[k] = row[k] + col * strides_[k][nd - 1];
+
+                fn(offs, n);
+
+                e += n;
+                col = 0;
+
+                // odometer over the outer dims
+                for (size_t d = nd - 1; d-- > 0; ) {
+                    for (size_t k = 0; k < N; ++k) row[k] += strides_[k][d];
+                    if (++idx[d] < sizes_[d]) break;
+                    for (size_t k = 0; k < N; ++k) row[k] -= sizes_[d] * strides_[k][d];
+                    idx[d] = 0;
+                }
+            }
+        }
+
+    private:
+        Shape sizes_;
+        std::array<Shape, N> strides_;
+        size_t numel_{ 1 };
+    };
+
+} // namespace ml::core
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+
+namespace ml::ops {
+
+	// pointwise activation fused into an op's output (see ops::linear)
+	enum class Activation : uint8_t {
+		None,
+		ReLU,
+		GELU,   // tanh approximation: 0.5 x (1 + tanh(sqrt(2/pi) (x + 0.044715 x^3)))
+	};
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// element type conversion into a new contiguous tensor
+	// float32 <-> bfloat16/float16 rows run through SIMD kernels (round to
+	// nearest even); other pairs follow core::convert_value (float -> int
+	// truncates and saturates)
+	// same dtype: returns x.contiguous() (a view when x is contiguous already)
+	Tensor to_dtype(const Tensor& x, DType dtype);
+
+}
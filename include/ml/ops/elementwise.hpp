@@ -3,6 +3,11 @@
 
 namespace ml::ops {
 
+	// NumPy-style broadcasting: [B,N] + [N], [B,1] * [1,N], ...
+	// broadcast inputs are read through zero-stride views, never copied
+	// inputs may be any view (transpose, slice, expand), no contiguous() needed
+	// a and b must share a dtype; float32 rows use SIMD kernels, 16-bit floats
+	// compute in float, integers wrap on overflow
 	Tensor add(const Tensor& a, const Tensor& b);
 	Tensor sub(const Tensor& a, const Tensor& b);
 	Tensor mul(const Tensor& a, const Tensor& b);
@@ -0,0 +1,285 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ml/autograd/graph.hpp"
+#include "ml/core/shape.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+// lazy elementwise expressions: a chain such as
+//     Tensor y = expr::eval(expr::relu(expr::add(expr::mul(a, w), b)));
+// compiles into one loop with one output allocation, instead of one pass
+// and one temporary per op as with ml::ops
+//
+// nodes only hold pointers to their tensors: build and eval the expression
+// in the same statement (or keep the tensors alive until eval)
+// operands broadcast like ml::ops (NumPy rules) and may be any view;
+// expressions are float32 only
+//
+// eval records one graph node for the whole expression when a leaf
+// requires grad: backward walks the expression again per leaf, each node
+// handing down the derivative with respect to that leaf (forward mode)
+
+namespace ml::expr {
+
+    // per-row view of the leaves handed to the nodes: leaf k reads ptr[k][j * stride[k]]
+    template <size_t K>
+    struct RowCtx {
+        std::array<const float*, K> ptr;
+        std::array<size_t, K> stride;
+    };
+
+    // ---- leaves ----
+    struct Leaf {
+        static constexpr size_t kLeaves = 1;
+        const Tensor* t;
+
+        template <size_t B, size_t K>
+        void collect(std::array<const Tensor*, K>& out) const { out[B] = t; }
+
+        // Unit: every leaf is unit-stride in this row (lets the loop vectorize)
+        template <size_t B, bool Unit, size_t K>
+        float at(const RowCtx<K>& c, size_t j) const {
+            return Unit ? c.ptr[B][j] : c.ptr[B][j * c.stride[B]];
+        }
+
+        // d(node)/d(leaf number `leaf`) at element j, leaves numbered as in
+        // collect; only called with a leaf inside the node
+        template <size_t B, bool Unit, size_t K>
+        float grad(const RowCtx<K>&, size_t, size_t leaf) const { return B == leaf ? 1.0f : 0.0f; }
+    };
+
+    struct Const {
+        static constexpr size_t kLeaves = 0;
+        float v;
+
+        template <size_t B, size_t K>
+        void collect(std::array<const Tensor*, K>&) const {}
+
+        template <size_t B, bool Unit, size_t K>
+        float at(const RowCtx<K>&, size_t) const { return v; }
+
+        template <size_t B, bool Unit, size_t K>
+        float grad(const RowCtx<K>&, size_t, size_t) const { return 0.0f; }
+    };
+
+    // ---- inner nodes ----
+    template <class Op, class E>
+    struct Unary {
+        static constexpr size_t kLeaves = E::kLeaves;
+        E e;
+
+        template <size_t B, size_t K>
+        void collect(std::array<const Tensor*, K>& out) const { e.template collect<B>(out); }
+
+        template <size_t B, bool Unit, size_t K>
+        float at(const RowCtx<K>& c, size_t j) const {
+            return Op::apply(e.template at<B, Unit>(c, j));
+        }
+
+        template <size_t B, bool Unit, size_t K>
+        float grad(const RowCtx<K>& c, size_t j, size_t leaf) const {
+            return Op::grad(e.template at<B, Unit>(c, j), e.template grad<B, Unit>(c, j, leaf));
+        }
+    };
+
+    template <class Op, class L, class R>
+    struct Binary {
+        static constexpr size_t kLeaves = L::kLeaves + R::kLeaves;
+        L l;
+        R r;
+
+        // leaves are numbered left to right: l takes [B, B + nl), r the rest
+        template <size_t B, size_t K>
+        void collect(std::array<const Tensor*, K>& out) const {
+            l.template collect<B>(out);
+            r.template collect<B + L::kLeaves>(out);
+        }
+
+        template <size_t B, bool Unit, size_t K>
+        float at(const RowCtx<K>& c, size_t j) const {
+            return Op::apply(l.template at<B, Unit>(c, j), r.template at<B + L::kLeaves, Unit>(c, j));
+        }
+
+        // the leaf sits on one side: the other side's derivative is 0
+        template <size_t B, bool Unit, size_t K>
+        float grad(const RowCtx<K>& c, size_t j, size_t leaf) const {
+            const bool left = leaf < B + L::kLeaves;
+            const float dx = left ? l.template grad<B, Unit>(c, j, leaf) : 0.0f;
+            const float dy = left ? 0.0f : r.template grad<B + L::kLeaves, Unit>(c, j, leaf);
+            return Op::grad(l.template at<B, Unit>(c, j), r.template at<B + L::kLeaves, Unit>(c, j), dx, dy);
+        }
+    };
+
+    // apply: the value; grad: its derivative given the operands' derivatives
+    struct AddOp {
+        static float apply(float x, float y) { return x + y; }
+        static float grad(float, float, float dx, float dy) { return dx + dy; }
+    };
+    struct SubOp {
+        static float apply(float x, float y) { return x - y; }
+        static float grad(float, float, float dx, float dy) { return dx - dy; }
+    };
+    struct MulOp {
+        static float apply(float x, float y) { return x * y; }
+        static float grad(float x, float y, float dx, float dy) { return dx * y + x * dy; }
+    };
+    struct ReluOp {
+        static float apply(float x) { return x > 0.0f ? x : 0.0f; }
+        static float grad(float x, float dx) { return x > 0.0f ? dx : 0.0f; }
+    };
+
+    // ---- operand wrapping: Tensor -> Leaf, float -> Const, nodes as is ----
+    template <class T> struct is_node : std::false_type {};
+    template <> struct is_node<Leaf> : std::true_type {};
+    template <> struct is_node<Const> : std::true_type {};
+    template <class Op, class E> struct is_node<Unary<Op, E>> : std::true_type {};
+    template <class Op, class L, class R> struct is_node<Binary<Op, L, R>> : std::true_type {};
+
+    inline Leaf wrap(const Tensor& t) { return Leaf{ &t }; }
+    inline Const wrap(float v) { return Const{ v }; }
+    template <class E, class = std::enable_if_t<is_node<E>::value>>
+    const E& wrap(const E& e) { return e; }
+
+    template <class T>
+    using node_t = std::decay_t<decltype(wrap(std::declval<const T&>()))>;
+
+    // ---- builders ----
+    template <class A, class B>
+    Binary<AddOp, node_t<A>, node_t<B>> add(const A& a, const B& b) { return { wrap(a), wrap(b) }; }
+
+    template <class A, class B>
+    Binary<SubOp, node_t<A>, node_t<B>> sub(const A& a, const B& b) { return { wrap(a), wrap(b) }; }
+
+    template <class A, class B>
+    Binary<MulOp, node_t<A>, node_t<B>> mul(const A& a, const B& b) { return { wrap(a), wrap(b) }; }
+
+    template <class A>
+    Unary<ReluOp, node_t<A>> relu(const A& a) { return { wrap(a) }; }
+
+    // operators once at least one side is already an expression node
+    template <class A, class B>
+    using if_node = std::enable_if_t<is_node<A>::value || is_node<B>::value, int>;
+
+    template <class A, class B, if_node<A, B> = 0>
+    auto operator+(const A& a, const B& b) { return add(a, b); }
+    template <class A, class B, if_node<A, B> = 0>
+    auto operator-(const A& a, const B& b) { return sub(a, b); }
+    template <class A, class B, if_node<A, B> = 0>
+    auto operator*(const A& a, const B& b) { return mul(a, b); }
+
+    namespace detail {
+
+        // fn(c, o, so, n, unit) for every row of out: c reads the leaves
+        // expanded to out's shape, o is the output row with stride so, unit
+        // says that every stride of the row is 1
+        template <size_t K, class F>
+        void for_rows(Tensor& out, const std::array<const Tensor*, K>& leaves, F&& fn) {
+            const core::Shape& shape = out.sizes();
+
+            // leaves as views with out's shape (stride 0 where broadcast)
+            std::vector<Tensor> views;
+            views.reserve(K);
+            std::array<const core::Shape*, K + 1> strides;
+            strides[0] = &out.strides();
+            for (size_t k = 0; k < K; ++k) {
+                views.push_back(leaves[k]->detach().expand(shape));
+                strides[k + 1] = &views.back().strides();
+            }
+
+            core::StridedLoop<K + 1> loop(shape, strides);
+            bool unit = loop.inner_stride(0) == 1;
+            RowCtx<K> base{};
+            for (size_t k = 0; k < K; ++k) {
+                base.ptr[k] = views[k].data();
+                base.stride[k] = loop.inner_stride(k + 1);
+                unit = unit && base.stride[k] == 1;
+            }
+            const size_t so = loop.inner_stride(0);
+            float* po = out.data();
+
+            parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+                loop.for_range(e0, e1, [&](const std::array<size_t, K + 1>& off, size_t n) {
+                    RowCtx<K> c = base;
+                    for (size_t k = 0; k < K; ++k) c.ptr[k] += off[k + 1];
+                    fn(c, po + off[0], so, n, unit);
+                    });
+                });
+        }
+
+        // the graph node of eval: a copy of the expression (it only reads
+        // through RowCtx, never through the Leaf pointers) over saved views
+        // of the leaves; leaf k gets sum_to(g * de/dleaf_k)
+        // saved: the leaves (detached)
+        template <class X>
+        struct ExprBackward : GradFn {
+            static constexpr size_t K = X::kLeaves;
+            X e;
+
+            ExprBackward(const X& x, const std::array<const Tensor*, K>& leaves) : e(x) {
+                for (const Tensor* t : leaves) saved.push_back(t->detach());
+            }
+
+            void backward(const Tensor& g) override {
+                // g rides along as leaf K, past the expression's own leaves
+                std::array<const Tensor*, K + 1> in;
+                for (size_t k = 0; k < K; ++k) in[k] = &saved[k];
+                in[K] = &g;
+                for (size_t k = 0; k < K; ++k) {
+                    if (!inputs[k]) continue;
+                    Tensor gk = Tensor::empty(g.sizes());
+                    for_rows<K + 1>(gk, in, [&](const RowCtx<K + 1>& c, float* o, size_t so, size_t n, bool unit) {
+                        if (unit) {
+                            for (size_t j = 0; j < n; ++j) o[j] = c.ptr[K][j] * e.template grad<0, true>(c, j, k);
+                        }
+                        else {
+                            for (size_t j = 0; j < n; ++j) {
+                                o[j * so] = c.ptr[K][j * c.stride[K]] * e.template grad<0, false>(c, j, k);
+                            }
+                        }
+                        });
+                    accumulate(k, autograd::sum_to(gk, saved[k].sizes()));
+                }
+            }
+        };
+
+    } // namespace detail
+
+    // ---- evaluation: one pass, one allocation ----
+    template <class E>
+    Tensor eval(const E& expression) {
+        const auto& e = wrap(expression);
+        using X = std::decay_t<decltype(e)>;
+        constexpr size_t K = X::kLeaves;
+
+        std::array<const Tensor*, K> leaves{};
+        e.template collect<0>(leaves);
+
+        core::Shape shape;
+        for (size_t k = 0; k < K; ++k) {
+            ML_CHECK(leaves[k]->dtype() == DType::Float32, "expr::eval: float32 tensors only");
+            shape = core::broadcast_shapes(shape, leaves[k]->sizes());
+        }
+
+        Tensor out = Tensor::empty(shape);
+        detail::for_rows<K>(out, leaves, [&](const RowCtx<K>& c, float* o, size_t so, size_t n, bool unit) {
+            if (unit) {
+                for (size_t j = 0; j < n; ++j) o[j] = e.template at<0, true>(c, j);
+            }
+            else {
+                for (size_t j = 0; j < n; ++j) o[j * so] = e.template at<0, false>(c, j);
+            }
+            });
+
+        if (autograd::needs_grad(leaves)) {
+            autograd::record(out, std::make_shared<detail::ExprBackward<X>>(e, leaves), leaves);
+        }
+        return out;
+    }
+
+} // namespace ml::expr
@@ -0,0 +1,18 @@
+#pragma once
+#include "ml/ops/activation.hpp"
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// y = act(x @ w + bias) + residual as a single GEMM: the micro-kernel
+	// applies bias, activation and residual to each output tile while it is
+	// still in registers, so there is no extra pass over y and no temporaries
+	// x: [..., K], w: [K, N], bias: [N], residual: same shape as y ([..., N])
+	// a PyTorch-style [N, K] weight goes in as w.transpose(0, 1), no copy
+	// float32 only
+	Tensor linear(const Tensor& x, const Tensor& w, const Tensor& bias,
+		Activation act = Activation::None);
+	Tensor linear(const Tensor& x, const Tensor& w, const Tensor& bias,
+		Activation act, const Tensor& residual);
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// mean over rows of -log softmax(logits)[r, targets[r]], as a 0-d tensor
+	// logits: [B, V] float32, targets: [B] int32 class indices in [0, V)
+	// no probabilities are materialized: each row is read once for its
+	// logsumexp (the same online max-and-sum as softmax), and backward
+	// writes softmax - onehot in one more pass per row from the saved
+	// per-row logsumexp; rows run in parallel
+	// records a graph node when logits requires grad
+	Tensor cross_entropy(const Tensor& logits, const Tensor& targets);
+
+}
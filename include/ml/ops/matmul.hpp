@@ -3,6 +3,17 @@
 
 namespace ml::ops {
 
+	// [..., M, K] x [..., K, N] -> [..., M, N], a and b share a dtype
+	// leading (batch) dims broadcast like elementwise ops: [B,H,M,K] x [K,N]
+	// and [B,1,M,K] x [1,H,K,N] both work; 2D is the plain matrix product
+	// inputs are read through their strides, so transpose/slice/expand views
+	// need no copy; small matrices are spread one per task across the batch
+	// float32: packed SIMD GEMM; bfloat16/float16: same GEMM with inputs
+	// widened while packing and float32 accumulation, result rounded once to
+	// the input dtype; float64: plain double loop; integer dtypes throw
 	Tensor matmul(const Tensor& a, const Tensor& b);
 
+	// [B,M,K] x [B,K,N] -> [B,M,N], no broadcasting
+	Tensor bmm(const Tensor& a, const Tensor& b);
+
 }
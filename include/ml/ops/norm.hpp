@@ -0,0 +1,20 @@
+#pragma once
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// normalization over the last dim of x ([..., N]), weight and bias [N]
+	// layer_norm: (x - mean) / sqrt(var + eps) * weight + bias, var biased
+	// rms_norm:   x / sqrt(mean(x^2) + eps) * weight
+	// one read of a row gives its statistics (Welford mean/variance, or the
+	// sum of squares), a second writes the scaled and shifted result; rows
+	// run in parallel
+	// float32; records a graph node when any input requires grad, which
+	// keeps x and weight plus one (mean, 1/std) pair per row
+	Tensor layer_norm(const Tensor& x, const Tensor& weight, const Tensor& bias, float eps = 1e-5f);
+	Tensor layer_norm(const Tensor& x, float eps = 1e-5f);
+
+	Tensor rms_norm(const Tensor& x, const Tensor& weight, float eps = 1e-6f);
+	Tensor rms_norm(const Tensor& x, float eps = 1e-6f);
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <memory>
+
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// affine int8 quantization: q = clamp(round(x / scale) + zero_point),
+	// x ~= scale * (q - zero_point); rounding is half to even
+
+	// params covering the range of x (0 is always exactly representable)
+	// UInt8: asymmetric over [0, 255], or [0, 127] with reduce_range, which
+	//   keeps quantized_matmul on the single-maddubs kernel on CPUs without VNNI
+	// Int8: symmetric over [-127, 127], zero_point 0 (weights)
+	// axis >= 0: one scale/zero_point per index along axis (per-channel)
+	std::shared_ptr<const QuantParams> choose_qparams(const Tensor& x, DType dtype,
+		int axis = -1, bool reduce_range = false);
+
+	// float32 -> int8/uint8 tensor carrying qp (saturates to the dtype range)
+	Tensor quantize(const Tensor& x, DType dtype, std::shared_ptr<const QuantParams> qp);
+
+	// quantized int8/uint8 -> float32
+	Tensor dequantize(const Tensor& q);
+
+	// a: uint8 [M,K], per-tensor params; b: int8 [K,N], per-tensor or
+	// per-channel along dim 1 (output channels); any strides
+	// u8 x s8 products are summed exactly in int32 (VNNI vpdpbusd or AVX2
+	// maddubs), zero points are corrected afterwards, then the result is
+	// scaled to float32
+	Tensor quantized_matmul(const Tensor& a, const Tensor& b);
+
+	// same, requantized to uint8 with the per-tensor out_qp
+	Tensor quantized_matmul(const Tensor& a, const Tensor& b, std::shared_ptr<const QuantParams> out_qp);
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// reductions over one dim, a list of dims, or (no dims) every element
+	// reduced dims are dropped from the result, or kept with size 1 when
+	// keepdim is set; reducing every dim without keepdim gives a 0-d tensor
+	// inputs may be any view, no contiguous() needed; float32 rows go
+	// through SIMD kernels, other dtypes compute in core::compute_t<T>
+	// the result does not depend on the thread count: long reductions are cut
+	// into fixed chunks whose partial results are combined in order
+	// (the kernel table may still change the float32 rounding)
+	//
+	// sum/prod keep the input dtype (integers wrap on overflow), mean is for
+	// floating dtypes only; max/min propagate NaN
+	Tensor sum(const Tensor& x);
+	Tensor sum(const Tensor& x, size_t dim, bool keepdim = false);
+	Tensor sum(const Tensor& x, const std::vector<size_t>& dims, bool keepdim = false);
+
+	Tensor mean(const Tensor& x);
+	Tensor mean(const Tensor& x, size_t dim, bool keepdim = false);
+	Tensor mean(const Tensor& x, const std::vector<size_t>& dims, bool keepdim = false);
+
+	Tensor prod(const Tensor& x);
+	Tensor prod(const Tensor& x, size_t dim, bool keepdim = false);
+	Tensor prod(const Tensor& x, const std::vector<size_t>& dims, bool keepdim = false);
+
+	Tensor max(const Tensor& x);
+	Tensor max(const Tensor& x, size_t dim, bool keepdim = false);
+	Tensor max(const Tensor& x, const std::vector<size_t>& dims, bool keepdim = false);
+
+	Tensor min(const Tensor& x);
+	Tensor min(const Tensor& x, size_t dim, bool keepdim = false);
+	Tensor min(const Tensor& x, const std::vector<size_t>& dims, bool keepdim = false);
+
+	// int32 index of the first largest (smallest) element along dim, or into
+	// the row-major flattened tensor without a dim; a NaN counts as the extreme
+	Tensor argmax(const Tensor& x);
+	Tensor argmax(const Tensor& x, size_t dim, bool keepdim = false);
+
+	Tensor argmin(const Tensor& x);
+	Tensor argmin(const Tensor& x, size_t dim, bool keepdim = false);
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "ml/tensor/tensor.hpp"
+
+namespace ml::ops {
+
+	// along dim, stable for any logits: rows are shifted by their max, so
+	// nothing overflows, and -inf entries get exactly 0 probability
+	// one read of a row finds the max and the sum of exponentials together
+	// (running max, the sum rescaled as it grows), a second writes the
+	// result; rows run in parallel
+	// float32; records a graph node when x requires grad
+	Tensor softmax(const Tensor& x, size_t dim);
+	Tensor log_softmax(const Tensor& x, size_t dim);
+
+	// log(sum(exp(x))) along dim, as max + log(sum(exp(x - max)))
+	Tensor logsumexp(const Tensor& x, size_t dim, bool keepdim = false);
+
+}
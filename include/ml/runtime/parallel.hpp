@@ -0,0 +1,57 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace ml {
+
+    // threads used by parallel ops, caller included
+    // default: ML_NUM_THREADS if set, else std::thread::hardware_concurrency()
+    // may race with parallel work on other threads: calls already running
+    // finish on the old pool, on their own thread; throws inside a
+    // parallel_for range
+    // every call that changes n keeps a stopped pool (a few hundred bytes)
+    // until exit, so it belongs in setup code, not in a loop
+    void set_num_threads(size_t n);
+    size_t get_num_threads();
+
+    // true while the current thread runs inside a parallel_for range
+    // (nested parallel calls from here execute serially)
+    bool in_parallel_region();
+
+    // elements per task for cheap memory-bound loops (add, copy, ...)
+    constexpr size_t kDefaultGrain = 32768;
+
+    // fn(b, e) over [begin, end) split into grain-aligned ranges spread over the
+    // work-stealing pool; blocks until done, rethrows the first exception
+    // with one thread, or from inside another parallel range, fn gets the whole
+    // range inline on the calling thread
+    void parallel_for(size_t begin, size_t end, size_t grain,
+        const std::function<void(size_t, size_t)>& fn);
+
+    // combine(... combine(combine(identity, map(c0)), map(c1)) ..., map(cn))
+    // over the chunks ci = [begin + i*grain, begin + (i+1)*grain)
+    // chunks are fixed by grain and combined in order, so the result is the
+    // same for every thread count (bit-exact for floating point too)
+    template <class T, class Map, class Combine>
+    T parallel_reduce(size_t begin, size_t end, size_t grain, T identity,
+        Map map, Combine combine) {
+        if (begin >= end) return identity;
+        grain = std::max<size_t>(grain, 1);
+
+        size_t chunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partial(chunks, identity);
+        parallel_for(0, chunks, 1, [&](size_t c0, size_t c1) {
+            for (size_t c = c0; c < c1; ++c) {
+                size_t b = begin + c * grain;
+                partial[c] = map(b, std::min(end, b + grain));
+            }
+            });
+
+        T acc = identity;
+        for (auto& p : partial) acc = combine(acc, p);
+        return acc;
+    }
+
+} // namespace ml
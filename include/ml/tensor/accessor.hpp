@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "ml/core/error.hpp"
+
+namespace ml {
+
+    // unchecked, rank-fixed view of a tensor's elements
+    //
+    // holds the base pointer (offset applied) plus a copy of sizes/strides,
+    // so indexing is N multiply-adds with no bounds checks and no allocation:
+    //     auto A = t.accessor<2>();
+    //     for (i) for (j) s += A(i, j);      // or A[i][j]
+    // out-of-range indices are undefined behavior (ML_DCHECKed in debug builds)
+    // the accessor does not keep the storage alive: the tensor must outlive it
+    template <class T, size_t N>
+    class TensorAccessor {
+        static_assert(N > 0, "TensorAccessor: rank must be > 0");
+
+    public:
+        TensorAccessor(T* data, const size_t* sizes, const size_t* strides)
+            : data_(data) {
+            for (size_t d = 0; d < N; ++d) {
+                sizes_[d] = sizes[d];
+                strides_[d] = strides[d];
+            }
+        }
+
+        template <class... I>
+        T& operator()(I... idx) const {
+            static_assert(sizeof...(I) == N, "TensorAccessor: wrong number of indices");
+            const size_t ix[N] = { static_cast<size_t>(idx)... };
+            size_t off = 0;
+            for (size_t d = 0; d < N; ++d) {
+                ML_DCHECK_LT(ix[d], sizes_[d], "accessor: index out of range");
+                off += ix[d] * strides_[d];
+            }
+            return data_[off];
+        }
+
+        // a[i] on rank 1 is the element, otherwise a rank N-1 sub-accessor
+        decltype(auto) operator[](size_t i) const {
+            ML_DCHECK_LT(i, sizes_[0], "accessor: index out of range");
+            if constexpr (N == 1) {
+                return static_cast<T&>(data_[i * strides_[0]]);
+            }
+            else {
+                return TensorAccessor<T, N - 1>(data_ + i * strides_[0], sizes_.data() + 1, strides_.data() + 1);
+            }
+        }
+
+        size_t size(size_t d) const { return sizes_[d]; }
+        size_t stride(size_t d) const { return strides_[d]; }
+        T* data() const { return data_; }
+
+    private:
+        T* data_;
+        std::array<size_t, N> sizes_;
+        std::array<size_t, N> strides_;
+    };
+
+} // namespace ml
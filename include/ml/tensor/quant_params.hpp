@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace ml {
+
+    // affine quantization of an int8/uint8 tensor: real = scale * (q - zero_point)
+    // per-tensor: one scale/zero_point, axis = -1
+    // per-channel: one pair per index along `axis` (e.g. output channels of a weight)
+    struct QuantParams {
+        std::vector<float> scale;
+        std::vector<int32_t> zero_point;
+        int axis{ -1 };
+
+        bool per_channel() const { return axis >= 0; }
+        float scale_at(size_t c) const { return scale[per_channel() ? c : 0]; }
+        int32_t zero_point_at(size_t c) const { return zero_point[per_channel() ? c : 0]; }
+    };
+
+} // namespace ml
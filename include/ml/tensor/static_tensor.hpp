@@ -0,0 +1,231 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "ml/core/error.hpp"
+#include "ml/core/shape.hpp"
+#include "ml/tensor/tensor.hpp"
+
+// the unrolled bodies below are one lambda call per element; past ~4x4 GCC
+// stops inlining them on its own and the kernels turn into call chains
+#if defined(__GNUC__) || defined(__clang__)
+#define ML_UNROLL_INLINE __attribute__((always_inline))
+#else
+#define ML_UNROLL_INLINE
+#endif
+
+namespace ml {
+
+    namespace detail {
+
+        // f(std::integral_constant<size_t, I>{}) for I = 0 .. N-1, expanded at
+        // compile time: every iteration is its own statement, no loop remains
+        template <class F, size_t... I>
+        ML_UNROLL_INLINE constexpr void static_for_impl(F&& f, std::index_sequence<I...>) {
+            (f(std::integral_constant<size_t, I>{}), ...);
+        }
+
+        template <size_t N, class F>
+        ML_UNROLL_INLINE constexpr void static_for(F&& f) {
+            static_for_impl(f, std::make_index_sequence<N>{});
+        }
+
+    } // namespace detail
+
+    // fixed-shape tensor with its elements inline (row-major), for tiny
+    // matrices (3x3 / 4x4 transforms, 8x8 heads) where Tensor's shared
+    // storage, runtime shapes and checks cost more than the math
+    //
+    // shapes are template arguments: mismatched operands do not compile, and
+    // the kernels below are unrolled completely at compile time
+    //     StaticTensor<float, 3, 3> R = ...;
+    //     StaticTensor<float, 3> p{ 1.0f, 2.0f, 3.0f };
+    //     auto q = matmul(R, p);                    // StaticTensor<float, 3>
+    // a copyable value type, usable in constexpr code; no autograd
+    template <class T, size_t... Dims>
+    class StaticTensor {
+        static_assert(sizeof...(Dims) > 0, "StaticTensor: rank must be > 0");
+        static_assert(((Dims > 0) && ...), "StaticTensor: dims must be > 0");
+        static_assert(sizeof...(Dims) <= core::kMaxDims, "StaticTensor: rank above core::kMaxDims");
+
+        static constexpr std::array<size_t, sizeof...(Dims)> make_strides() {
+            constexpr std::array<size_t, sizeof...(Dims)> dims{ Dims... };
+            std::array<size_t, sizeof...(Dims)> s{};
+            size_t acc = 1;
+            for (size_t d = dims.size(); d-- > 0;) {
+                s[d] = acc;
+                acc *= dims[d];
+            }
+            return s;
+        }
+
+    public:
+        using value_type = T;
+        static constexpr size_t rank = sizeof...(Dims);
+        static constexpr size_t numel = (Dims * ...);
+        static constexpr std::array<size_t, rank> shape{ Dims... };
+        static constexpr std::array<size_t, rank> strides = make_strides();
+
+        // zero-filled
+        constexpr StaticTensor() = default;
+
+        // exactly numel values in row-major order (a wrong count does not compile)
+        template <class... V, class = std::enable_if_t<sizeof...(V) == numel && (std::is_arithmetic_v<V> && ...)>>
+        constexpr StaticTensor(V... values) : data_{ static_cast<T>(values)... } {}
+
+        static constexpr StaticTensor filled(T v) {
+            StaticTensor t;
+            for (size_t i = 0; i < numel; ++i) t.data_[i] = v;
+            return t;
+        }
+
+        static constexpr StaticTensor identity() {
+            static_assert(rank == 2 && shape[0] == shape[1], "StaticTensor::identity: square matrices only");
+            StaticTensor t;
+            for (size_t i = 0; i < shape[0]; ++i) t.data_[i * shape[0] + i] = T(1);
+            return t;
+        }
+
+        // copy of a tensor with exactly this shape and dtype (any strides)
+        static StaticTensor from_tensor(const Tensor& t) {
+            ML_CHECK(t.dtype() == core::dtype_v<T>, "StaticTensor::from_tensor: dtype mismatch");
+            ML_CHECK(t.ndim() == rank, "StaticTensor::from_tensor: rank mismatch");
+            for (size_t d = 0; d < rank; ++d) {
+                ML_CHECK_EQ(t.sizes()[d], shape[d], "StaticTensor::from_tensor: shape mismatch");
+            }
+            StaticTensor out;
+            const T* src = t.data_as<T>();
+            for (size_t i = 0; i < numel; ++i) {
+                size_t off = 0;
+                for (size_t d = 0; d < rank; ++d) off += (i / strides[d] % shape[d]) * t.strides()[d];
+                out.data_[i] = src[off];
+            }
+            return out;
+        }
+
+        // contiguous Tensor over these elements, no copy: results of ops on it
+        // are ordinary tensors, writes through it land here
+        // borrowed memory: the tensor (and its views) must not outlive *this
+        Tensor as_tensor() {
+            return Tensor::from_blob(data_, Shape{ Dims... }, core::dtype_v<T>);
+        }
+
+        template <class... I>
+        constexpr T& operator()(I... idx) {
+            return data_[offset(idx...)];
+        }
+
+        template <class... I>
+        constexpr const T& operator()(I... idx) const {
+            return data_[offset(idx...)];
+        }
+
+        // flat row-major element
+        constexpr T& operator[](size_t i) { return data_[i]; }
+        constexpr const T& operator[](size_t i) const { return data_[i]; }
+
+        constexpr T* data() { return data_; }
+        constexpr const T* data() const { return data_; }
+        constexpr T* begin() { return data_; }
+        constexpr T* end() { return data_ + numel; }
+        constexpr const T* begin() const { return data_; }
+        constexpr const T* end() const { return data_ + numel; }
+
+        friend constexpr bool operator==(const StaticTensor& a, const StaticTensor& b) {
+            for (size_t i = 0; i < numel; ++i) {
+                if (!(a.data_[i] == b.data_[i])) return false;
+            }
+            return true;
+        }
+
+        friend constexpr bool operator!=(const StaticTensor& a, const StaticTensor& b) {
+            return !(a == b);
+        }
+
+    private:
+        template <class... I>
+        static constexpr size_t offset(I... idx) {
+            static_assert(sizeof...(I) == rank, "StaticTensor: wrong number of indices");
+            const size_t ix[rank] = { static_cast<size_t>(idx)... };
+            size_t off = 0;
+            for (size_t d = 0; d < rank; ++d) {
+                ML_DCHECK_LT(ix[d], shape[d], "StaticTensor: index out of range");
+                off += ix[d] * strides[d];
+            }
+            return off;
+        }
+
+        T data_[numel]{};
+    };
+
+    // ---- fixed-size kernels, unrolled through detail::static_for ----
+
+    // [M,K] x [K,N] -> [M,N]: C row i accumulates a(i,k) * (row k of B), so
+    // each row update is N independent multiply-adds the compiler vectorizes
+    template <class T, size_t M, size_t K, size_t N>
+    constexpr StaticTensor<T, M, N> matmul(const StaticTensor<T, M, K>& a, const StaticTensor<T, K, N>& b) {
+        StaticTensor<T, M, N> c;
+        detail::static_for<M>([&](auto i) ML_UNROLL_INLINE {
+            T row[N]{};
+            detail::static_for<K>([&](auto k) ML_UNROLL_INLINE {
+                const T aik = a[i * K + k];
+                detail::static_for<N>([&](auto j) ML_UNROLL_INLINE { row[j] += aik * b[k * N + j]; });
+            });
+            detail::static_for<N>([&](auto j) ML_UNROLL_INLINE { c[i * N + j] = row[j]; });
+        });
+        return c;
+    }
+
+    // [M,K] x [K] -> [M]
+    template <class T, size_t M, size_t K>
+    constexpr StaticTensor<T, M> matmul(const StaticTensor<T, M, K>& a, const StaticTensor<T, K>& x) {
+        StaticTensor<T, M> y;
+        detail::static_for<M>([&](auto i) ML_UNROLL_INLINE {
+            T s{};
+            detail::static_for<K>([&](auto k) ML_UNROLL_INLINE { s += a[i * K + k] * x[k]; });
+            y[i] = s;
+        });
+        return y;
+    }
+
+    template <class T, size_t M, size_t N>
+    constexpr StaticTensor<T, N, M> transpose(const StaticTensor<T, M, N>& a) {
+        StaticTensor<T, N, M> t;
+        detail::static_for<M>([&](auto i) ML_UNROLL_INLINE {
+            detail::static_for<N>([&](auto j) ML_UNROLL_INLINE { t[j * M + i] = a[i * N + j]; });
+        });
+        return t;
+    }
+
+    // elementwise, same shape only (no broadcasting)
+    template <class T, size_t... D>
+    constexpr StaticTensor<T, D...> operator+(const StaticTensor<T, D...>& a, const StaticTensor<T, D...>& b) {
+        StaticTensor<T, D...> r;
+        detail::static_for<StaticTensor<T, D...>::numel>([&](auto i) ML_UNROLL_INLINE { r[i] = a[i] + b[i]; });
+        return r;
+    }
+
+    template <class T, size_t... D>
+    constexpr StaticTensor<T, D...> operator-(const StaticTensor<T, D...>& a, const StaticTensor<T, D...>& b) {
+        StaticTensor<T, D...> r;
+        detail::static_for<StaticTensor<T, D...>::numel>([&](auto i) ML_UNROLL_INLINE { r[i] = a[i] - b[i]; });
+        return r;
+    }
+
+    template <class T, size_t... D>
+    constexpr StaticTensor<T, D...> operator*(const StaticTensor<T, D...>& a, const StaticTensor<T, D...>& b) {
+        StaticTensor<T, D...> r;
+        detail::static_for<StaticTensor<T, D...>::numel>([&](auto i) ML_UNROLL_INLINE { r[i] = a[i] * b[i]; });
+        return r;
+    }
+
+    template <class T, size_t... D>
+    constexpr StaticTensor<T, D...> operator*(T s, const StaticTensor<T, D...>& a) {
+        StaticTensor<T, D...> r;
+        detail::static_for<StaticTensor<T, D...>::numel>([&](auto i) ML_UNROLL_INLINE { r[i] = s * a[i]; });
+        return r;
+    }
+
+} // namespace ml
@@ -7,63 +7,145 @@
 #include "ml/autograd/grad_fn.hpp"
 #include "ml/core/storage.hpp"
 #include "ml/core/shape.hpp"
+#include "ml/tensor/accessor.hpp"
+#include "ml/tensor/quant_params.hpp"
 
 namespace ml {
 
+    using core::DType;
+    using core::Shape;
+    using core::Storage;
+
     class Tensor {
     public:
+        // sizes/strides are inline (core::Shape, up to core::kMaxDims dims):
+        // creating a view copies a few words and never touches the heap
+
+        // move-only: sharing elements is always explicit (a view, detach())
+        Tensor(Tensor&&) noexcept = default;
+        Tensor& operator=(Tensor&&) noexcept = default;
+        Tensor(const Tensor&) = delete;
+        Tensor& operator=(const Tensor&) = delete;
+
+        // every tensor has one element type (dtype), shared with its views;
+        // float32 is the default and the only type with autograd
+
         // --- factories ---
-        static Tensor empty(const std::vector<size_t>& sizes);
-        static Tensor zeros(const std::vector<size_t>& sizes);
-        static Tensor ones(const std::vector<size_t>& sizes);
+        // empty(): 64-byte aligned, contents are uninitialized
+        static Tensor empty(const Shape& sizes, DType dtype = DType::Float32);
+        static Tensor zeros(const Shape& sizes, DType dtype = DType::Float32);
+        static Tensor ones(const Shape& sizes, DType dtype = DType::Float32);
         static Tensor arange(size_t n);
         static Tensor from_vector(const std::vector<float>& v,
-            const std::vector<size_t>& sizes);
+            const Shape& sizes);
+        // contiguous tensor over memory owned by the caller (no copy); the
+        // memory must outlive the tensor and all of its views
+        static Tensor from_blob(void* data, const Shape& sizes, DType dtype = DType::Float32);
 
         // --- info ---
         size_t ndim() const;
         size_t numel() const;
-        const std::vector<size_t>& sizes() const;
-        const std::vector<size_t>& strides() const;
+        const Shape& sizes() const;
+        const Shape& strides() const;
         bool is_contiguous() const;
+        DType dtype() const;
+        size_t element_size() const;
 
         // --- raw data ---
+        // data(): float32 tensors only, data_as<T>(): T must match dtype()
         float* data();
         const float* data() const;
 
-        // --- indexing ---
+        template <class T>
+        T* data_as() {
+            ML_CHECK(dtype() == core::dtype_v<T>, "data_as(): dtype mismatch");
+            return storage_->data<T>() + offset_;
+        }
+
+        template <class T>
+        const T* data_as() const {
+            ML_CHECK(dtype() == core::dtype_v<T>, "data_as(): dtype mismatch");
+            return storage_->data<T>() + offset_;
+        }
+
+        // first element (offset applied), any dtype
+        void* raw_data();
+        const void* raw_data() const;
+
+        // --- indexing (float32) ---
         float& at(std::initializer_list<size_t> idx);
         float  at(std::initializer_list<size_t> idx) const;
 
-        // --- autograd flags ---
+        // unchecked fast path for kernels: rank and dtype are checked once here,
+        // element access through the accessor is not checked at all
+        template <size_t N, class T = float>
+        TensorAccessor<T, N> accessor() {
+            ML_CHECK_EQ(ndim(), N, "accessor(): rank mismatch");
+            return TensorAccessor<T, N>(data_as<T>(), sizes_.data(), strides_.data());
+        }
+
+        template <size_t N, class T = float>
+        TensorAccessor<const T, N> accessor() const {
+            ML_CHECK_EQ(ndim(), N, "accessor(): rank mismatch");
+            return TensorAccessor<const T, N>(data_as<T>(), sizes_.data(), strides_.data());
+        }
+
+        // --- quantization (int8/uint8 tensors) ---
+        // shared by views; transpose/slice/expand keep per-channel params on
+        // the right dim, reshape of a per-channel tensor throws
+        bool is_quantized() const { return (bool)qparams_; }
+        const std::shared_ptr<const QuantParams>& qparams() const { return qparams_; }
+        void set_qparams(std::shared_ptr<const QuantParams> qp);
+
+        // --- autograd (float32) ---
+        // the grad, and the node that produced a non-leaf tensor, live in an
+        // AutogradMeta shared with the graph; views (and contiguous/clone)
+        // of a tensor that requires grad are graph nodes too, detach() is not
+        // (see autograd/grad_mode.hpp for turning recording off)
         bool requires_grad() const { return requires_grad_; }
-        void set_requires_grad(bool v) { requires_grad_ = v; }
+        void set_requires_grad(bool v);     // throws on inference tensors
+
+        // created under InferenceMode, or a view of such a tensor
+        bool is_inference() const { return inference_; }
 
         // grad can not exist
-        bool has_grad() const { return (bool)grad_; }
+        bool has_grad() const { return autograd_ && autograd_->grad; }
         const Tensor& grad() const;     // throw if none
         Tensor& grad_mut();             // throw if none
         void zero_grad();               // if grad exists - fill with zeros
 
-        // start backward as loss
-        // (scalar loss)
-        void backward();                // easy v1
+        // dL/dt for every leaf that requires grad and feeds this scalar
+        // loss; leaf grads accumulate over calls, non-leaf grads are
+        // released as soon as their node has run, and so are the tensors
+        // the node saved unless retain_graph is set (without it, a second
+        // backward through the same graph throws)
+        void backward(bool retain_graph = false);
 
-        // internal: set graph node
-        void set_grad_fn(std::shared_ptr<GradFn> fn) { grad_fn_ = std::move(fn); }
-        std::shared_ptr<GradFn> grad_fn() const { return grad_fn_; }
+        // internal: set graph node (the tensor then requires grad)
+        void set_grad_fn(std::shared_ptr<GradFn> fn);
+        std::shared_ptr<GradFn> grad_fn() const { return autograd_ ? autograd_->grad_fn : nullptr; }
+        // null unless the tensor requires grad
+        const std::shared_ptr<AutogradMeta>& autograd_meta() const { return autograd_; }
 
         // factories that help autograd
         static Tensor zeros_like(const Tensor& t);
         static Tensor ones_like(const Tensor& t);
 
+        // same elements, no autograd state: what graph nodes save
+        Tensor detach() const;
+
         // --- views ---
-        Tensor reshape(const std::vector<size_t>& new_sizes) const;
+        Tensor reshape(const Shape& new_sizes) const;
         Tensor transpose(size_t dim0, size_t dim1) const;
         Tensor slice(size_t dim, size_t start, size_t length) const;
+        // broadcast view: new leading dims and size-1 dims get stride 0,
+        // so every index along them reads the same element (no copy)
+        Tensor expand(const Shape& new_sizes) const;
 
         // --- materialize ---
         Tensor contiguous() const;
+        // contiguous copy, always a new buffer
+        Tensor clone() const;
 
         // for tests/debug: do two tensors share the same buffer?
         const std::shared_ptr<Storage>& storage_ptr() const;
@@ -72,23 +154,26 @@ namespace ml {
         // internal constructor (used for views)
         Tensor(std::shared_ptr<Storage> storage,
             size_t offset,
-            std::vector<size_t> sizes,
-            std::vector<size_t> strides);
+            Shape sizes,
+            Shape strides);
+
+        size_t checked_offset_(std::initializer_list<size_t> idx) const;
 
-        float  at_vec_(const std::vector<size_t>& idx) const;
-        float& at_vec_(const std::vector<size_t>& idx);
-        static bool next_index_(std::vector<size_t>& idx, const std::vector<size_t>& sizes);
+        // for a fresh view of *this: passes the inference flag on and says
+        // whether the view has to become a graph node
+        bool view_needs_grad_(Tensor& view) const;
 
 
         std::shared_ptr<Storage> storage_;
         size_t offset_{ 0 };
-        std::vector<size_t> sizes_;
-        std::vector<size_t> strides_;
+        Shape sizes_;
+        Shape strides_;
+        std::shared_ptr<const QuantParams> qparams_;   // null: not quantized
 
         // --- autograd metadata ---
         bool requires_grad_{ false };
-        std::unique_ptr<Tensor> grad_;           // alocate if needed
-        std::shared_ptr<GradFn> grad_fn_;        // can be null 
+        bool inference_{ false };
+        std::shared_ptr<AutogradMeta> autograd_;   // null until requires_grad
     };
 
 } // namespace ml
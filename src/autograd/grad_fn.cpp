@@ -0,0 +1,71 @@
+#include "ml/autograd/grad_fn.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/ops/reduce.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <array>
+#include <vector>
+
+namespace ml {
+
+    // out of line: Tensor is incomplete in the header
+    AutogradMeta::AutogradMeta() = default;
+    AutogradMeta::~AutogradMeta() = default;
+    GradFn::GradFn() = default;
+    GradFn::~GradFn() = default;
+
+    void GradFn::release() {
+        saved.clear();
+        saved.shrink_to_fit();
+        released_ = true;
+    }
+
+    void GradFn::accumulate(size_t i, Tensor g) {
+        ML_DCHECK_LT(i, inputs.size(), "GradFn::accumulate: input index out of range");
+        AutogradMeta* meta = inputs[i].get();
+        if (!meta) return;
+
+        if (!meta->grad) {
+            // kept as the grad unless it shares memory (a view of grad_out,
+            // an input, ...): later gradients are added into it in place
+            if (!g.is_contiguous() || g.storage_ptr().use_count() > 1) g = g.clone();
+            meta->grad = std::make_unique<Tensor>(std::move(g));
+            return;
+        }
+
+        Tensor& dst = *meta->grad;
+        ML_CHECK(dst.sizes() == g.sizes(), "backward: gradient shape mismatch");
+        core::StridedLoop<2> loop(dst.sizes(), { &dst.strides(), &g.strides() });
+        const size_t gs = loop.inner_stride(1);
+        float* pd = dst.data();
+        const float* pg = g.data();
+        auto add = ops::kernels::table().add;
+        parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+            loop.for_range(e0, e1, [&](const std::array<size_t, 2>& off, size_t n) {
+                float* d = pd + off[0];
+                const float* s = pg + off[1];
+                if (gs == 1) {
+                    add(d, s, d, n);
+                }
+                else {
+                    for (size_t j = 0; j < n; ++j) d[j] += s[j * gs];
+                }
+                });
+            });
+    }
+
+    Tensor autograd::sum_to(const Tensor& g, const Shape& sizes) {
+        ML_CHECK(g.ndim() >= sizes.size(), "sum_to: gradient has fewer dims than the input");
+        const size_t lead = g.ndim() - sizes.size();
+        std::vector<size_t> dims;
+        for (size_t d = 0; d < g.ndim(); ++d) {
+            if (d < lead || (sizes[d - lead] == 1 && g.sizes()[d] != 1)) dims.push_back(d);
+        }
+        if (dims.empty()) return g.detach();
+        return ops::sum(g, dims, true).reshape(sizes);
+    }
+
+} // namespace ml
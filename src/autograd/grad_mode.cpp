@@ -0,0 +1,38 @@
+#include "ml/autograd/grad_mode.hpp"
+
+namespace ml {
+
+    namespace {
+        thread_local bool t_grad_enabled = true;
+        thread_local bool t_inference = false;
+    }
+
+    bool grad_enabled() { return t_grad_enabled; }
+    bool inference_mode_enabled() { return t_inference; }
+
+    detail::GradModeState detail::grad_mode_state() { return { t_grad_enabled, t_inference }; }
+
+    detail::GradModeScope::GradModeScope(GradModeState state) : prev_{ t_grad_enabled, t_inference } {
+        t_grad_enabled = state.grad;
+        t_inference = state.inference;
+    }
+
+    detail::GradModeScope::~GradModeScope() {
+        t_grad_enabled = prev_.grad;
+        t_inference = prev_.inference;
+    }
+
+    NoGradGuard::NoGradGuard() : prev_(t_grad_enabled) { t_grad_enabled = false; }
+    NoGradGuard::~NoGradGuard() { t_grad_enabled = prev_; }
+
+    InferenceMode::InferenceMode() : prev_grad_(t_grad_enabled), prev_inference_(t_inference) {
+        t_grad_enabled = false;
+        t_inference = true;
+    }
+
+    InferenceMode::~InferenceMode() {
+        t_grad_enabled = prev_grad_;
+        t_inference = prev_inference_;
+    }
+
+} // namespace ml
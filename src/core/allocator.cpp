@@ -0,0 +1,187 @@
+#include "ml/core/allocator.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace ml::core {
+
+    namespace {
+
+        constexpr size_t kMinBlock = 64;
+        constexpr size_t kNumClasses = 256;
+
+        // class index and rounded size for a request
+        // <= 64 bytes -> class 0, then 4 steps per power of two:
+        // (64, 128] -> 80, 96, 112, 128; (128, 256] -> 160, 192, 224, 256; ...
+        size_t size_class(size_t bytes, size_t& rounded) {
+            if (bytes <= kMinBlock) {
+                rounded = kMinBlock;
+                return 0;
+            }
+            size_t e = 6;
+            while ((size_t(1) << (e + 1)) < bytes) ++e;   // 2^e < bytes <= 2^(e+1)
+            size_t base = size_t(1) << e;
+            size_t step = base >> 2;
+            size_t k = (bytes - base + step - 1) / step;  // 1..4
+            rounded = base + k * step;
+            return (e - 6) * 4 + k;
+        }
+
+        size_t default_limit() {
+            if (const char* env = std::getenv("ML_ALLOC_CACHE_LIMIT")) {
+                return static_cast<size_t>(std::strtoull(env, nullptr, 10));
+            }
+            return size_t(1) << 30;
+        }
+
+        void* system_alloc(size_t bytes) {
+            return ::operator new(bytes, std::align_val_t{ kAllocAlignment });
+        }
+
+        void system_free(void* p) {
+            ::operator delete(p, std::align_val_t{ kAllocAlignment });
+        }
+
+        struct Global {
+            std::atomic<size_t> hits{ 0 };
+            std::atomic<size_t> misses{ 0 };
+            std::atomic<size_t> bytes_cached{ 0 };
+            std::atomic<size_t> bytes_in_use{ 0 };
+            std::atomic<size_t> limit{ default_limit() };
+
+            // blocks left behind by exited threads
+            std::mutex mu;
+            std::vector<void*> pool[kNumClasses];
+        };
+
+        // never destroyed: Storage freed during static destruction still lands here
+        Global& global() {
+            static Global* g = new Global();
+            return *g;
+        }
+
+        struct ThreadCache;
+
+        // 0 = not created yet, 1 = alive, 2 = destroyed (thread is exiting)
+        thread_local int t_cache_state = 0;
+
+        struct ThreadCache {
+            std::vector<void*> free[kNumClasses];
+
+            ThreadCache() { t_cache_state = 1; }
+
+            // hand everything to the shared pool so other threads can reuse it
+            ~ThreadCache() {
+                Global& g = global();
+                std::lock_guard<std::mutex> lock(g.mu);
+                for (size_t c = 0; c < kNumClasses; ++c) {
+                    g.pool[c].insert(g.pool[c].end(), free[c].begin(), free[c].end());
+                }
+                t_cache_state = 2;
+            }
+        };
+
+        ThreadCache* thread_cache() {
+            if (t_cache_state == 2) return nullptr;
+            thread_local ThreadCache cache;
+            return &cache;
+        }
+
+        void release_all(std::vector<void*>& blocks, size_t rounded) {
+            for (void* p : blocks) system_free(p);
+            global().bytes_cached.fetch_sub(blocks.size() * rounded, std::memory_order_relaxed);
+            blocks.clear();
+        }
+
+        size_t class_size(size_t c) {
+            if (c == 0) return kMinBlock;
+            size_t e = 6 + (c - 1) / 4;
+            size_t k = (c - 1) % 4 + 1;
+            return (size_t(1) << e) + k * ((size_t(1) << e) >> 2);
+        }
+
+    } // namespace
+
+    void* cached_alloc(size_t bytes) {
+        size_t rounded;
+        size_t c = size_class(bytes, rounded);
+        Global& g = global();
+
+        void* p = nullptr;
+        if (ThreadCache* tc = thread_cache(); tc && !tc->free[c].empty()) {
+            p = tc->free[c].back();
+            tc->free[c].pop_back();
+        }
+        else {
+            std::lock_guard<std::mutex> lock(g.mu);
+            if (!g.pool[c].empty()) {
+                p = g.pool[c].back();
+                g.pool[c].pop_back();
+            }
+        }
+
+        if (p) {
+            g.hits.fetch_add(1, std::memory_order_relaxed);
+            g.bytes_cached.fetch_sub(rounded, std::memory_order_relaxed);
+        }
+        else {
+            p = system_alloc(rounded);
+            g.misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        g.bytes_in_use.fetch_add(rounded, std::memory_order_relaxed);
+        return p;
+    }
+
+    void cached_free(void* p, size_t bytes) {
+        if (!p) return;
+        size_t rounded;
+        size_t c = size_class(bytes, rounded);
+        Global& g = global();
+        g.bytes_in_use.fetch_sub(rounded, std::memory_order_relaxed);
+
+        ThreadCache* tc = thread_cache();
+        size_t cached = g.bytes_cached.load(std::memory_order_relaxed);
+        if (!tc || cached + rounded > g.limit.load(std::memory_order_relaxed)) {
+            system_free(p);
+            return;
+        }
+        tc->free[c].push_back(p);
+        g.bytes_cached.fetch_add(rounded, std::memory_order_relaxed);
+    }
+
+    AllocatorStats allocator_stats() {
+        Global& g = global();
+        return AllocatorStats{
+            g.hits.load(std::memory_order_relaxed),
+            g.misses.load(std::memory_order_relaxed),
+            g.bytes_cached.load(std::memory_order_relaxed),
+            g.bytes_in_use.load(std::memory_order_relaxed),
+        };
+    }
+
+    void reset_allocator_stats() {
+        Global& g = global();
+        g.hits.store(0, std::memory_order_relaxed);
+        g.misses.store(0, std::memory_order_relaxed);
+    }
+
+    void empty_allocator_cache() {
+        Global& g = global();
+        if (ThreadCache* tc = thread_cache()) {
+            for (size_t c = 0; c < kNumClasses; ++c) release_all(tc->free[c], class_size(c));
+        }
+        std::lock_guard<std::mutex> lock(g.mu);
+        for (size_t c = 0; c < kNumClasses; ++c) release_all(g.pool[c], class_size(c));
+    }
+
+    void set_allocator_cache_limit(size_t bytes) {
+        global().limit.store(bytes, std::memory_order_relaxed);
+    }
+
+    size_t allocator_cache_limit() {
+        return global().limit.load(std::memory_order_relaxed);
+    }
+
+} // namespace ml::core
@@ -0,0 +1,112 @@
+#include "ml/core/cpu.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ML_X86_64 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace ml::core {
+
+    namespace {
+
+#if defined(ML_X86_64)
+        void cpuid(unsigned leaf, unsigned sub, unsigned r[4]) {
+#if defined(_MSC_VER)
+            int regs[4];
+            __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(sub));
+            for (int i = 0; i < 4; ++i) r[i] = static_cast<unsigned>(regs[i]);
+#else
+            __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+        }
+
+        unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            unsigned lo, hi;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+        }
+
+        CpuLevel detect() {
+            unsigned r[4];
+            cpuid(0, 0, r);
+            unsigned max_leaf = r[0];
+            if (max_leaf < 7) return CpuLevel::Scalar;
+
+            cpuid(1, 0, r);
+            bool osxsave = (r[2] >> 27) & 1;
+            bool avx = (r[2] >> 28) & 1;
+            bool fma = (r[2] >> 12) & 1;
+            bool f16c = (r[2] >> 29) & 1;
+            if (!osxsave || !avx || !fma || !f16c) return CpuLevel::Scalar;
+
+            // OS must save the YMM (and for AVX-512 the opmask/ZMM) state
+            unsigned long long xcr0 = xgetbv0();
+            bool ymm_os = (xcr0 & 0x6) == 0x6;
+            bool zmm_os = (xcr0 & 0xe6) == 0xe6;
+            if (!ymm_os) return CpuLevel::Scalar;
+
+            cpuid(7, 0, r);
+            bool avx2 = (r[1] >> 5) & 1;
+            bool avx512f = (r[1] >> 16) & 1;
+            bool avx512bw = (r[1] >> 30) & 1;
+            bool avx512vl = (r[1] >> 31) & 1;
+            bool avx512vnni = (r[2] >> 11) & 1;
+
+            if (avx2 && avx512f && avx512bw && avx512vl && avx512vnni && zmm_os) return CpuLevel::AVX512VNNI;
+            if (avx2 && avx512f && zmm_os) return CpuLevel::AVX512;
+            if (avx2) return CpuLevel::AVX2;
+            return CpuLevel::Scalar;
+        }
+#else
+        CpuLevel detect() { return CpuLevel::Scalar; }
+#endif
+
+        CpuLevel from_env(CpuLevel detected) {
+            const char* env = std::getenv("ML_CPU_LEVEL");
+            if (!env) return detected;
+
+            CpuLevel wanted = detected;
+            if (std::strcmp(env, "scalar") == 0) wanted = CpuLevel::Scalar;
+            else if (std::strcmp(env, "avx2") == 0) wanted = CpuLevel::AVX2;
+            else if (std::strcmp(env, "avx512") == 0) wanted = CpuLevel::AVX512;
+            else if (std::strcmp(env, "avx512vnni") == 0) wanted = CpuLevel::AVX512VNNI;
+
+            // forcing a level the CPU lacks would crash with SIGILL
+            return wanted < detected ? wanted : detected;
+        }
+
+    } // namespace
+
+    CpuLevel detected_cpu_level() {
+        static const CpuLevel level = detect();
+        return level;
+    }
+
+    CpuLevel cpu_level() {
+        static const CpuLevel level = from_env(detected_cpu_level());
+        return level;
+    }
+
+    const char* cpu_level_name(CpuLevel level) {
+        switch (level) {
+        case CpuLevel::Scalar: return "scalar";
+        case CpuLevel::AVX2:   return "avx2";
+        case CpuLevel::AVX512: return "avx512";
+        case CpuLevel::AVX512VNNI: return "avx512vnni";
+        }
+        return "unknown";
+    }
+
+} // namespace ml::core
@@ -0,0 +1,31 @@
+#include "ml/core/dtype.hpp"
+
+namespace ml::core {
+
+    size_t dtype_size(DType dt) {
+        switch (dt) {
+        case DType::Float32:  return 4;
+        case DType::Float64:  return 8;
+        case DType::Float16:  return 2;
+        case DType::BFloat16: return 2;
+        case DType::Int32:    return 4;
+        case DType::Int8:     return 1;
+        case DType::UInt8:    return 1;
+        }
+        fail("dtype_size: unknown dtype", __FILE__, __LINE__);
+    }
+
+    const char* dtype_name(DType dt) {
+        switch (dt) {
+        case DType::Float32:  return "float32";
+        case DType::Float64:  return "float64";
+        case DType::Float16:  return "float16";
+        case DType::BFloat16: return "bfloat16";
+        case DType::Int32:    return "int32";
+        case DType::Int8:     return "int8";
+        case DType::UInt8:    return "uint8";
+        }
+        return "unknown";
+    }
+
+} // namespace ml::core
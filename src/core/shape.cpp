@@ -1,9 +1,11 @@
 #include "ml/core/shape.hpp"
 #include "ml/core/error.hpp"
 
+#include <algorithm>
+
 namespace ml::core {
 
-    size_t numel(const std::vector<size_t>& sizes) {
+    size_t numel(const Shape& sizes) {
         size_t els = 1;
         for (size_t s : sizes) {
             ML_CHECK(s > 0, "numel(): dimension must be > 0 (v1 restriction)");
@@ -12,8 +14,8 @@ namespace ml::core {
         return els;
     }
 
-    std::vector<size_t> contiguous_strides(const std::vector<size_t>& sizes) {
-        std::vector<size_t> strides(sizes.size(), 0);
+    Shape contiguous_strides(const Shape& sizes) {
+        Shape strides(sizes.size(), 0);
         if (sizes.empty()) {
             return strides; // scalar: no dims
         }
@@ -26,15 +28,15 @@ namespace ml::core {
         return strides;
     }
 
-    bool is_contiguous(const std::vector<size_t>& sizes,
-        const std::vector<size_t>& strides) {
+    bool is_contiguous(const Shape& sizes,
+        const Shape& strides) {
         if (sizes.size() != strides.size()) return false;
         return contiguous_strides(sizes) == strides;
     }
 
     size_t linear_index(size_t offset,
-        const std::vector<size_t>& strides,
-        const std::vector<size_t>& indices) {
+        const Shape& strides,
+        const Shape& indices) {
         ML_CHECK_EQ(strides.size(), indices.size(), "linear_index(): rank mismatch");
         size_t idx = offset;
         for (size_t d = 0; d < indices.size(); ++d) {
@@ -43,4 +45,18 @@ namespace ml::core {
         return idx;
     }
 
+    Shape broadcast_shapes(const Shape& a,
+        const Shape& b) {
+        const size_t nd = std::max(a.size(), b.size());
+        Shape out(nd, 1);
+        for (size_t i = 0; i < nd; ++i) {
+            // walk from the last dim, missing leading dims count as 1
+            size_t da = i < a.size() ? a[a.size() - 1 - i] : 1;
+            size_t db = i < b.size() ? b[b.size() - 1 - i] : 1;
+            ML_CHECK(da == db || da == 1 || db == 1, "broadcast_shapes(): shapes are not broadcastable");
+            out[nd - 1 - i] = da == 1 ? db : da;
+        }
+        return out;
+    }
+
 } // namespace ml::core
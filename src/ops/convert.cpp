@@ -0,0 +1,64 @@
+#include "ml/ops/convert.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <array>
+#include <type_traits>
+
+namespace ml::ops{
+
+	namespace {
+
+		// SIMD kernel for a unit-stride row From -> To, or nullptr
+		template <class To, class From>
+		auto row_kernel() {
+			const kernels::KernelTable& k = kernels::table();
+			if constexpr (std::is_same_v<From, float> && std::is_same_v<To, core::BFloat16>) return k.f32_to_bf16;
+			else if constexpr (std::is_same_v<From, float> && std::is_same_v<To, core::Half>) return k.f32_to_f16;
+			else if constexpr (std::is_same_v<From, core::BFloat16> && std::is_same_v<To, float>) return k.bf16_to_f32;
+			else if constexpr (std::is_same_v<From, core::Half> && std::is_same_v<To, float>) return k.f16_to_f32;
+			else return nullptr;
+		}
+
+		template <class From, class To>
+		void convert_rows(const Tensor& x, Tensor& out) {
+			core::StridedLoop<2> loop(x.sizes(), { &out.strides(), &x.strides() });
+			const size_t sx = loop.inner_stride(1);
+			To* po = out.data_as<To>();
+			const From* px = x.data_as<From>();
+			auto fn = row_kernel<To, From>();
+
+			parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+				loop.for_range(e0, e1, [&](const std::array<size_t, 2>& off, size_t n) {
+					To* ro = po + off[0];
+					const From* rx = px + off[1];
+					if constexpr (!std::is_same_v<decltype(fn), std::nullptr_t>) {
+						if (sx == 1) {
+							// Half/BFloat16 are a bare uint16_t bit pattern
+							using InT = std::conditional_t<std::is_same_v<From, float>, float, uint16_t>;
+							using OutT = std::conditional_t<std::is_same_v<To, float>, float, uint16_t>;
+							fn(reinterpret_cast<const InT*>(rx), reinterpret_cast<OutT*>(ro), n);
+							return;
+						}
+					}
+					for (size_t j = 0; j < n; ++j) ro[j] = core::convert_value<To>(rx[j * sx]);
+					});
+				});
+		}
+
+	} // namespace
+
+	Tensor to_dtype(const Tensor& x, DType dtype) {
+		if (x.dtype() == dtype) return x.contiguous();
+
+		Tensor out = Tensor::empty(x.sizes(), dtype);
+		core::dispatch_dtype(x.dtype(), [&](auto from) {
+			core::dispatch_dtype(dtype, [&](auto to) {
+				convert_rows<typename decltype(from)::type, typename decltype(to)::type>(x, out);
+				});
+			});
+		return out;
+	}
+
+}
@@ -1,51 +1,167 @@
 #include "ml/ops/elementwise.hpp"
-#include "ml/core/error.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <array>
+#include <memory>
+#include <type_traits>
 
 namespace ml::ops{
 
-	static void check_same_shape(const Tensor& a, const Tensor& b) {
-		ML_CHECK(a.sizes() == b.sizes(), "elementwise: shape mismatch");
+	// out = op(a, b) over any strides: a and b are expanded to out's shape
+	// (stride 0 on broadcast dims), coalesced, and each row either goes to the
+	// SIMD kernel (float32, all three unit-stride) or to a strided loop
+	// other dtypes compute in core::compute_t<T> (float for the 16-bit floats)
+	// fn may be null: float32 then takes the loop too
+	template <class Op>
+	static Tensor binary_op(const Tensor& a, const Tensor& b, kernels::BinaryFn fn, Op op) {
+		ML_CHECK(a.dtype() == b.dtype(), "elementwise: dtype mismatch");
+		auto out_sizes = core::broadcast_shapes(a.sizes(), b.sizes());
+		Tensor out = Tensor::empty(out_sizes, a.dtype());
+		// detached: internal views, not graph nodes
+		Tensor ae = a.detach().expand(out_sizes);
+		Tensor be = b.detach().expand(out_sizes);
+
+		core::StridedLoop<3> loop(out_sizes, { &out.strides(), &ae.strides(), &be.strides() });
+		const size_t so = loop.inner_stride(0);
+		const size_t sa = loop.inner_stride(1);
+		const size_t sb = loop.inner_stride(2);
+
+		core::dispatch_dtype(a.dtype(), [&](auto tag) {
+			using T = typename decltype(tag)::type;
+			using C = core::compute_t<T>;
+			T* po = out.data_as<T>();
+			const T* pa = ae.data_as<T>();
+			const T* pb = be.data_as<T>();
+
+			parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+				loop.for_range(e0, e1, [&](const std::array<size_t, 3>& off, size_t n) {
+					T* ro = po + off[0];
+					const T* ra = pa + off[1];
+					const T* rb = pb + off[2];
+					if constexpr (std::is_same_v<T, float>) {
+						if (fn && so == 1 && sa == 1 && sb == 1) {
+							fn(ra, rb, ro, n);
+							return;
+						}
+					}
+					for (size_t j = 0; j < n; ++j) {
+						ro[j * so] = static_cast<T>(op(static_cast<C>(ra[j * sa]), static_cast<C>(rb[j * sb])));
+					}
+					});
+				});
+			});
+		return out;
 	}
 
-	Tensor add(const Tensor& a, const Tensor& b) {
-		check_same_shape(a, b);
+	// fn may be null, as for binary_op
+	template <class Op>
+	static Tensor unary_op(const Tensor& x, kernels::UnaryFn fn, Op op) {
+		Tensor out = Tensor::empty(x.sizes(), x.dtype());
+
+		core::StridedLoop<2> loop(x.sizes(), { &out.strides(), &x.strides() });
+		const size_t so = loop.inner_stride(0);
+		const size_t sx = loop.inner_stride(1);
+
+		core::dispatch_dtype(x.dtype(), [&](auto tag) {
+			using T = typename decltype(tag)::type;
+			using C = core::compute_t<T>;
+			T* po = out.data_as<T>();
+			const T* px = x.data_as<T>();
+
+			parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+				loop.for_range(e0, e1, [&](const std::array<size_t, 2>& off, size_t n) {
+					T* ro = po + off[0];
+					const T* rx = px + off[1];
+					if constexpr (std::is_same_v<T, float>) {
+						if (fn && so == 1 && sx == 1) {
+							fn(rx, ro, n);
+							return;
+						}
+					}
+					for (size_t j = 0; j < n; ++j) ro[j * so] = static_cast<T>(op(static_cast<C>(rx[j * sx])));
+					});
+				});
+			});
+		return out;
+	}
+
+	namespace {
 
-		Tensor out = Tensor::empty(a.sizes());
+		// a +- b: the gradient as is (negated for b of sub), summed back over
+		// the dims broadcasting added
+		struct AddBackward : GradFn {
+			Shape a_sizes, b_sizes;
+			bool negate_b;
 
-		for (size_t i = 0; i < out.numel(); ++i) {
-			out.data()[i] = a.data()[i] + b.data()[i];
+			AddBackward(Shape a, Shape b, bool neg) : a_sizes(std::move(a)), b_sizes(std::move(b)), negate_b(neg) {}
+
+			void backward(const Tensor& g) override {
+				if (inputs[0]) accumulate(0, autograd::sum_to(g, a_sizes));
+				if (inputs[1]) {
+					Tensor gb = autograd::sum_to(g, b_sizes);
+					if (negate_b) gb = unary_op(gb, nullptr, [](float x) { return -x; });
+					accumulate(1, std::move(gb));
+				}
+			}
+		};
+
+		// saved: a, b (whichever the other side's gradient needs)
+		struct MulBackward : GradFn {
+			MulBackward(Tensor a, Tensor b) {
+				saved.push_back(std::move(a));
+				saved.push_back(std::move(b));
+			}
+
+			void backward(const Tensor& g) override {
+				if (inputs[0]) accumulate(0, autograd::sum_to(mul(g, saved[1]), saved[0].sizes()));
+				if (inputs[1]) accumulate(1, autograd::sum_to(mul(g, saved[0]), saved[1].sizes()));
+			}
+		};
+
+		// saved: y; the gradient passes where y > 0
+		struct ReluBackward : GradFn {
+			explicit ReluBackward(Tensor y) { saved.push_back(std::move(y)); }
+
+			void backward(const Tensor& g) override {
+				accumulate(0, binary_op(g, saved[0], nullptr, [](float d, float y) { return y > 0.0f ? d : 0.0f; }));
+			}
+		};
+
+	} // namespace
+
+	Tensor add(const Tensor& a, const Tensor& b) {
+		Tensor out = binary_op(a, b, kernels::table().add, [](auto x, auto y) { return x + y; });
+		if (autograd::needs_grad({ &a, &b })) {
+			autograd::record(out, std::make_shared<AddBackward>(a.sizes(), b.sizes(), false), { &a, &b });
 		}
 		return out;
 	}
 
 	Tensor sub(const Tensor& a, const Tensor& b) {
-		check_same_shape(a, b);
-		Tensor out = Tensor::empty(a.sizes());
-
-		for (size_t i = 0; i < out.numel(); ++i) {
-			out.data()[i] = a.data()[i] - b.data()[i];
+		Tensor out = binary_op(a, b, kernels::table().sub, [](auto x, auto y) { return x - y; });
+		if (autograd::needs_grad({ &a, &b })) {
+			autograd::record(out, std::make_shared<AddBackward>(a.sizes(), b.sizes(), true), { &a, &b });
 		}
 		return out;
 	}
 
 	Tensor mul(const Tensor& a, const Tensor& b) {
-		check_same_shape(a, b);
-		Tensor out = Tensor::empty(a.sizes());
-
-		for (size_t i = 0; i < out.numel(); ++i) {
-			out.data()[i] = a.data()[i] * b.data()[i];
+		Tensor out = binary_op(a, b, kernels::table().mul, [](auto x, auto y) { return x * y; });
+		if (autograd::needs_grad({ &a, &b })) {
+			autograd::record(out, std::make_shared<MulBackward>(a.detach(), b.detach()), { &a, &b });
 		}
 		return out;
 	}
 
 	Tensor relu(const Tensor& x) {
-		Tensor out = Tensor::empty(x.sizes());
-
-		for (size_t i = 0; i < out.numel(); ++i) {
-			float v = x.data()[i];
-			out.data()[i] = (v > 0.0f) ? v : 0.0f;
+		Tensor out = unary_op(x, kernels::table().relu, [](auto v) { return (v > decltype(v)(0)) ? v : decltype(v)(0); });
+		if (autograd::needs_grad({ &x })) {
+			autograd::record(out, std::make_shared<ReluBackward>(out.detach()), { &x });
 		}
 		return out;
 	}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,298 @@
+#include "ops/gemm.hpp"
+#include "ops/gemv.hpp"
+#include "ml/core/allocator.hpp"
+#include "ml/core/dtype.hpp"
+#include "ops/kernels/kernels.hpp"
+#include "ml/runtime/parallel.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace ml::ops::detail {
+
+    namespace {
+
+        // n values src[0], src[stride], ... -> float
+        // 16-bit floats are widened here, so the micro-kernels only see float32
+        // and accumulate in it; unit-stride runs use the SIMD converters
+        template <class T>
+        inline void load_run(const T* src, size_t stride, size_t n, float* out) {
+            if constexpr (std::is_same_v<T, float>) {
+                for (size_t i = 0; i < n; ++i) out[i] = src[i * stride];
+            }
+            else {
+                if (stride == 1) {
+                    const kernels::KernelTable& k = kernels::table();
+                    auto cvt = std::is_same_v<T, core::BFloat16> ? k.bf16_to_f32 : k.f16_to_f32;
+                    cvt(reinterpret_cast<const uint16_t*>(src), out, n);
+                }
+                else {
+                    for (size_t i = 0; i < n; ++i) out[i] = static_cast<float>(src[i * stride]);
+                }
+            }
+        }
+
+        // R panel lines (rows of A, columns of B) that are contiguous along k:
+        // out[p * R + i] = line i, value p; lines past `lines` are zero
+        // float goes through the SIMD transposing copy, 16-bit floats are
+        // widened 64 values per line into a stack buffer first
+        template <class T>
+        void load_lines(const T* src, size_t ld, size_t lines, size_t kc, size_t R, float* out) {
+            const kernels::KernelTable& k = kernels::table();
+            if constexpr (std::is_same_v<T, float>) {
+                k.pack_t(src, ld, lines, kc, out, R);
+            }
+            else {
+                constexpr size_t kChunk = 64;
+                float buf[std::max(kernels::kMaxMR, kernels::kMaxNR) * kChunk];
+                for (size_t p0 = 0; p0 < kc; p0 += kChunk) {
+                    size_t n = std::min(kChunk, kc - p0);
+                    for (size_t i = 0; i < lines; ++i) load_run(src + i * ld + p0, 1, n, buf + i * kChunk);
+                    k.pack_t(buf, kChunk, lines, n, out + p0 * R, R);
+                }
+            }
+            if (lines < R) {
+                for (size_t p = 0; p < kc; ++p) {
+                    for (size_t i = lines; i < R; ++i) out[p * R + i] = 0.0f;
+                }
+            }
+        }
+
+        // A block [mc x kc] -> panels of mr rows
+        // panel layout: for each p in kc, mr consecutive values (column of the panel)
+        // rows past mc are zero padded so the micro-kernel never branches
+        // row-major A (unit stride along k) is transposed line by line; any
+        // other layout (column-major: unit stride along m) is read per column
+        template <class T>
+        void pack_a(size_t mc, size_t kc,
+            const T* a, size_t rsa, size_t csa,
+            size_t MR, float* out) {
+            const bool k_major = csa == 1 && rsa != 1;
+            for (size_t ir = 0; ir < mc; ir += MR) {
+                size_t mr = std::min(MR, mc - ir);
+                if (k_major) {
+                    load_lines(a + ir * rsa, rsa, mr, kc, MR, out);
+                    out += MR * kc;
+                    continue;
+                }
+                for (size_t p = 0; p < kc; ++p) {
+                    load_run(a + ir * rsa + p * csa, rsa, mr, out);
+                    for (size_t i = mr; i < MR; ++i) out[i] = 0.0f;
+                    out += MR;
+                }
+            }
+        }
+
+        // B block [kc x nc] -> panels of nr columns
+        // panel layout: for each p in kc, nr consecutive values (row of the panel)
+        // column-major B (w.transpose(0, 1): unit stride along k) is
+        // transposed line by line, row-major B is copied row by row
+        template <class T>
+        void pack_b(size_t kc, size_t nc,
+            const T* b, size_t rsb, size_t csb,
+            size_t NR, float* out) {
+            const bool k_major = rsb == 1 && csb != 1;
+            for (size_t jr = 0; jr < nc; jr += NR) {
+                size_t nr = std::min(NR, nc - jr);
+                if (k_major) {
+                    load_lines(b + jr * csb, csb, nr, kc, NR, out);
+                    out += NR * kc;
+                    continue;
+                }
+                for (size_t p = 0; p < kc; ++p) {
+                    load_run(b + p * rsb + jr * csb, csb, nr, out);
+                    for (size_t j = nr; j < NR; ++j) out[j] = 0.0f;
+                    out += NR;
+                }
+            }
+        }
+
+        // partial tile at the M/N edge: run the full kernel into a scratch tile
+        // and copy back only the valid m x n part (the epilogue runs here, its
+        // bias/residual would be read past the edge by the kernel)
+        void edge_kernel(const kernels::GemmKernel& k,
+            size_t m, size_t n, size_t kc,
+            const float* a, const float* b,
+            float* c, size_t ldc, bool accumulate,
+            const kernels::GemmEpilogue* ep) {
+            float tile[kernels::kMaxMR * kernels::kMaxNR];
+            k.fn(kc, a, b, tile, k.nr, false, nullptr);
+
+            for (size_t i = 0; i < m; ++i) {
+                float* row = c + i * ldc;
+                const float* t = tile + i * k.nr;
+                for (size_t j = 0; j < n; ++j) {
+                    float v = accumulate ? row[j] + t[j] : t[j];
+                    row[j] = ep ? kernels::apply_epilogue(v, *ep, i, j) : v;
+                }
+            }
+        }
+
+        // ep moved to the tile at (i, j) of the block it was set up for
+        kernels::GemmEpilogue offset_epilogue(const kernels::GemmEpilogue& ep, size_t i, size_t j) {
+            kernels::GemmEpilogue t = ep;
+            if (t.bias) t.bias += j;
+            if (t.residual) t.residual += i * t.ldr + j;
+            return t;
+        }
+
+        size_t round_up(size_t x, size_t m) { return (x + m - 1) / m * m; }
+
+        // C block [mc x (panels jr0..jr1)] from packed A and B
+        void macro_kernel(const kernels::GemmKernel& k,
+            size_t mc, size_t nc, size_t kc,
+            size_t jr_begin, size_t jr_end,
+            const float* a_packed, const float* b_packed,
+            float* c, size_t ldc, bool accumulate,
+            const kernels::GemmEpilogue* ep) {
+            const size_t MR = k.mr;
+            const size_t NR = k.nr;
+
+            for (size_t jr = jr_begin; jr < jr_end; jr += NR) {
+                size_t nr = std::min(NR, nc - jr);
+                const float* bp = b_packed + jr * kc;
+
+                for (size_t ir = 0; ir < mc; ir += MR) {
+                    size_t mr = std::min(MR, mc - ir);
+                    const float* ap = a_packed + ir * kc;
+                    float* cp = c + ir * ldc + jr;
+
+                    kernels::GemmEpilogue tile_ep;
+                    if (ep) tile_ep = offset_epilogue(*ep, ir, jr);
+                    const kernels::GemmEpilogue* tep = ep ? &tile_ep : nullptr;
+
+                    if (mr == MR && nr == NR) {
+                        k.fn(kc, ap, bp, cp, ldc, accumulate, tep);
+                    }
+                    else {
+                        edge_kernel(k, mr, nr, kc, ap, bp, cp, ldc, accumulate, tep);
+                    }
+                }
+            }
+        }
+
+    } // namespace
+
+    template <class T>
+    void gemm(size_t M, size_t N, size_t K,
+        const T* a, size_t rsa, size_t csa,
+        const T* b, size_t rsb, size_t csb,
+        float* c, size_t ldc,
+        const kernels::GemmEpilogue* ep) {
+        // matrix-vector and skinny shapes: packing would copy the big operand
+        // for a handful of rows, stream it instead (epilogue as a second pass
+        // over the small output)
+        if constexpr (std::is_same_v<T, float>) {
+            if ((M < kSkinnyMax || N < kSkinnyMax) && gemm_skinny(M, N, K, a, rsa, csa, b, rsb, csb, c, ldc)) {
+                if (ep) {
+                    for (size_t i = 0; i < M; ++i) {
+                        for (size_t j = 0; j < N; ++j) c[i * ldc + j] = kernels::apply_epilogue(c[i * ldc + j], *ep, i, j);
+                    }
+                }
+                return;
+            }
+        }
+
+        const kernels::GemmKernel& k = kernels::table().gemm;
+        const size_t MR = k.mr;
+        const size_t NR = k.nr;
+
+        // MC must be a multiple of MR so A panels never straddle blocks
+        const size_t MC = std::max(MR, kGemmMC / MR * MR);
+        const size_t KC = kGemmKC;
+        const size_t NC = std::max(NR, kGemmNC / NR * NR);
+
+        // small products are not worth waking the pool, and inside another
+        // parallel range the pool is busy already (nested calls run inline)
+        const bool parallel = M * N * K >= kGemmParallelThreshold && !in_parallel_region();
+        const size_t n_threads = parallel ? get_num_threads() : 1;
+
+        // B block is shared by all tasks, A blocks are packed per task
+        // packing buffers are reused across calls on the same thread and are
+        // cache-line aligned (caching allocator)
+        thread_local std::vector<float, core::CachingAllocator<float>> b_buf;
+        b_buf.resize(std::max(b_buf.size(), round_up(std::min(N, NC), NR) * std::min(K, KC)));
+        const size_t a_size = round_up(std::min(M, MC), MR) * std::min(K, KC);
+
+        const size_t m_blocks = (M + MC - 1) / MC;
+
+        for (size_t jc = 0; jc < N; jc += NC) {
+            size_t nc = std::min(NC, N - jc);
+            size_t n_panels = (nc + NR - 1) / NR;
+
+            // split N into panel groups when there are too few M blocks to keep
+            // every thread busy; each group repacks its A block
+            size_t n_groups = 1;
+            if (n_threads > 1) {
+                n_groups = std::min(n_panels, (2 * n_threads + m_blocks - 1) / m_blocks);
+                n_groups = std::max<size_t>(n_groups, 1);
+            }
+            size_t group_panels = (n_panels + n_groups - 1) / n_groups;
+            n_groups = (n_panels + group_panels - 1) / group_panels;
+
+            for (size_t pc = 0; pc < K; pc += KC) {
+                size_t kc = std::min(KC, K - pc);
+                // first K block overwrites C, later ones accumulate, the last
+                // one applies the epilogue
+                bool accumulate = pc != 0;
+                bool last = pc + kc == K;
+                const T* b_block = b + pc * rsb + jc * csb;
+                float* b_packed = b_buf.data();
+
+                if (n_threads > 1) {
+                    size_t chunks = std::min(n_threads, n_panels);
+                    size_t chunk_panels = (n_panels + chunks - 1) / chunks;
+                    parallel_for(0, chunks, 1, [&](size_t t0, size_t t1) {
+                        size_t j0 = t0 * chunk_panels * NR;
+                        size_t j1 = std::min(nc, t1 * chunk_panels * NR);
+                        if (j0 < j1) {
+                            pack_b(kc, j1 - j0, b_block + j0 * csb, rsb, csb, NR, b_packed + j0 * kc);
+                        }
+                        });
+                }
+                else {
+                    pack_b(kc, nc, b_block, rsb, csb, NR, b_packed);
+                }
+
+                auto tile_task = [&](size_t t) {
+                    size_t ic = (t / n_groups) * MC;
+                    size_t jr0 = (t % n_groups) * group_panels * NR;
+                    size_t jr1 = std::min(nc, jr0 + group_panels * NR);
+                    size_t mc = std::min(MC, M - ic);
+
+                    thread_local std::vector<float, core::CachingAllocator<float>> a_buf;
+                    if (a_buf.size() < a_size) a_buf.resize(a_size);
+
+                    kernels::GemmEpilogue block_ep;
+                    if (ep && last) block_ep = offset_epilogue(*ep, ic, jc);
+
+                    pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, MR, a_buf.data());
+                    macro_kernel(k, mc, nc, kc, jr0, jr1, a_buf.data(), b_packed,
+                        c + ic * ldc + jc, ldc, accumulate, ep && last ? &block_ep : nullptr);
+                };
+
+                size_t n_tasks = m_blocks * n_groups;
+                if (n_threads > 1) {
+                    parallel_for(0, n_tasks, 1, [&](size_t t0, size_t t1) {
+                        for (size_t t = t0; t < t1; ++t) tile_task(t);
+                        });
+                }
+                else {
+                    for (size_t t = 0; t < n_tasks; ++t) tile_task(t);
+                }
+            }
+        }
+    }
+
+    template void gemm<float>(size_t, size_t, size_t,
+        const float*, size_t, size_t, const float*, size_t, size_t, float*, size_t,
+        const kernels::GemmEpilogue*);
+    template void gemm<core::BFloat16>(size_t, size_t, size_t,
+        const core::BFloat16*, size_t, size_t, const core::BFloat16*, size_t, size_t, float*, size_t,
+        const kernels::GemmEpilogue*);
+    template void gemm<core::Half>(size_t, size_t, size_t,
+        const core::Half*, size_t, size_t, const core::Half*, size_t, size_t, float*, size_t,
+        const kernels::GemmEpilogue*);
+
+} // namespace ml::ops::detail
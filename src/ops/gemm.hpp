@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+
+// internal GEMM engine used by ops::matmul (not part of the public headers)
+
+namespace ml::ops::kernels {
+    struct GemmEpilogue;
+}
+
+namespace ml::ops::detail {
+
+    // cache blocking parameters (in elements)
+    // KC x NR panel of B lives in L1, MC x KC block of A in L2,
+    // KC x NC block of B in L3
+    constexpr size_t kGemmMC = 120;
+    constexpr size_t kGemmKC = 256;
+    constexpr size_t kGemmNC = 4096;
+
+    // M*N*K below this runs on the calling thread (~96^3 multiply-adds)
+    constexpr size_t kGemmParallelThreshold = 96 * 96 * 96;
+
+    // C[M,N] = A[M,K] * B[K,N]
+    // A and B are read through (row stride, col stride) so any 2D view works
+    // C is row-major with leading dimension ldc and is fully overwritten
+    // T is float, core::BFloat16 or core::Half: 16-bit inputs are widened
+    // while packing, so products and sums are always float32
+    // large products split the output into MC x (NR panel group) tiles on the
+    // shared pool; every C element is owned by one task, so results do not
+    // depend on the thread count
+    // ep (bias over N, residual over [M,N], activation) is applied by the
+    // micro-kernels during the last K block, while each tile is in registers
+    template <class T>
+    void gemm(size_t M, size_t N, size_t K,
+        const T* a, size_t rsa, size_t csa,
+        const T* b, size_t rsb, size_t csb,
+        float* c, size_t ldc,
+        const kernels::GemmEpilogue* ep = nullptr);
+
+} // namespace ml::ops::detail
@@ -0,0 +1,110 @@
+#include "ops/gemv.hpp"
+#include "ml/core/allocator.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace ml::ops::detail {
+
+    namespace {
+
+        using Buffer = std::vector<float, core::CachingAllocator<float>>;
+
+        // weight bytes a task keeps hot while it reuses them for every small vector
+        constexpr size_t kSkinnyBlock = 64 * 1024 / sizeof(float);
+
+        // S small vectors x_s (k stride xk) against L big lines w_l (k stride wk,
+        // line stride wl); C(s, l) = c[s * cs + l * cl]
+        struct Skinny {
+            size_t S, L, K;
+            const float* x;
+            size_t xs, xk;
+            const float* w;
+            size_t wl, wk;
+            float* c;
+            size_t cs, cl;
+        };
+
+        // w contiguous along k: each output is one dot product
+        // tasks own line ranges; inside, blocks of lines small enough to stay
+        // in L2 are reused by all S vectors
+        void run_dot(const Skinny& p, const float* x, size_t ldx) {
+            const kernels::KernelTable& k = kernels::table();
+            const size_t block = std::max<size_t>(4, kSkinnyBlock / p.K / 4 * 4);
+            const size_t grain = std::max(block, kDefaultGrain / p.K);
+            parallel_for(0, p.L, grain, [&](size_t l0, size_t l1) {
+                for (size_t lb = l0; lb < l1; lb += block) {
+                    size_t n = std::min(block, l1 - lb);
+                    for (size_t s = 0; s < p.S; ++s) {
+                        k.dot_rows(p.w + lb * p.wl, p.wl, n, x + s * ldx, p.K,
+                            p.c + s * p.cs + lb * p.cl, p.cl);
+                    }
+                }
+                });
+        }
+
+        // w contiguous along the lines: each k adds x_s[k] * (row k of w) to the
+        // output row; tasks own column ranges, K is walked in blocks that stay
+        // in L2 across the S vectors
+        void run_axpy(const Skinny& p, const float* x, size_t ldx) {
+            const kernels::KernelTable& k = kernels::table();
+            const size_t grain = std::max<size_t>(64, kDefaultGrain / p.K / 16 * 16);
+            parallel_for(0, p.L, grain, [&](size_t l0, size_t l1) {
+                const size_t n = l1 - l0;
+                const size_t kb = std::max<size_t>(4, kSkinnyBlock / n / 4 * 4);
+                // output lines with a stride go through a contiguous scratch row
+                thread_local Buffer scratch;
+                const bool direct = p.cl == 1;
+                if (!direct && scratch.size() < p.S * n) scratch.resize(p.S * n);
+
+                for (size_t k0 = 0; k0 < p.K; k0 += kb) {
+                    size_t kn = std::min(kb, p.K - k0);
+                    for (size_t s = 0; s < p.S; ++s) {
+                        float* y = direct ? p.c + s * p.cs + l0 : scratch.data() + s * n;
+                        k.axpy_rows(p.w + k0 * p.wk + l0, p.wk, kn, x + s * ldx + k0, y, n, k0 != 0);
+                    }
+                }
+                if (!direct) {
+                    for (size_t s = 0; s < p.S; ++s) {
+                        for (size_t l = 0; l < n; ++l) p.c[s * p.cs + (l0 + l) * p.cl] = scratch[s * n + l];
+                    }
+                }
+                });
+        }
+
+    } // namespace
+
+    bool gemm_skinny(size_t M, size_t N, size_t K,
+        const float* a, size_t rsa, size_t csa,
+        const float* b, size_t rsb, size_t csb,
+        float* c, size_t ldc) {
+        // M small: rows of A against the columns of B (C row s = x_s * B)
+        // N small: columns of B against the rows of A (C column s = A * x_s)
+        Skinny p = M <= N
+            ? Skinny{ M, N, K, a, rsa, csa, b, csb, rsb, c, ldc, 1 }
+            : Skinny{ N, M, K, b, csb, rsb, a, rsa, csa, c, 1, ldc };
+
+        const bool dot = p.wk == 1;
+        if (!dot && p.wl != 1) return false;
+
+        // the kernels want each small vector contiguous along k
+        const float* x = p.x;
+        size_t ldx = p.xs;
+        thread_local Buffer x_buf;
+        if (p.xk != 1 && p.K > 1) {
+            x_buf.resize(p.S * p.K);
+            for (size_t s = 0; s < p.S; ++s) {
+                for (size_t kk = 0; kk < p.K; ++kk) x_buf[s * p.K + kk] = p.x[s * p.xs + kk * p.xk];
+            }
+            x = x_buf.data();
+            ldx = p.K;
+        }
+
+        if (dot) run_dot(p, x, ldx);
+        else run_axpy(p, x, ldx);
+        return true;
+    }
+
+} // namespace ml::ops::detail
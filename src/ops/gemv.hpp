@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+// matrix-vector and skinny products for ops::detail::gemm (internal)
+
+namespace ml::ops::detail {
+
+    // the packed GEMM is used while both M and N are at least this
+    constexpr size_t kSkinnyMax = 16;
+
+    // C[M,N] = A[M,K] * B[K,N] for M or N < kSkinnyMax, float32, same
+    // operand/output conventions as gemm()
+    // the big operand is streamed once (dot products along its rows when it is
+    // contiguous along K, axpy over its rows when it is contiguous along the
+    // output), the few small vectors are reused from cache, and output lines
+    // are split over the pool
+    // returns false (nothing written) when the big operand is contiguous along
+    // neither dimension; gemm() then packs as usual
+    bool gemm_skinny(size_t M, size_t N, size_t K,
+        const float* a, size_t rsa, size_t csa,
+        const float* b, size_t rsb, size_t csb,
+        float* c, size_t ldc);
+
+} // namespace ml::ops::detail
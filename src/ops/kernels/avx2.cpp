@@ -0,0 +1,628 @@
+#include "ops/kernels/kernels.hpp"
+#include "ml/core/dtype.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <limits>
+
+// AVX2 + FMA kernels, this file is compiled with -mavx2 -mfma (/arch:AVX2)
+// and only reached when core::cpu_level() >= AVX2
+
+namespace ml::ops::kernels {
+
+    namespace {
+
+        constexpr size_t kMR = 6;
+        constexpr size_t kNR = 16;
+
+        // e^x: x = n ln2 + r with |r| <= ln2 / 2, e^r by the Cephes expf
+        // polynomial, 2^n built in the exponent field; x is clamped so 2^n
+        // stays normal (a few ulp); x < -87.3 (and -inf) gives 0, NaN stays
+        // NaN (min/max return their second operand for NaN)
+        inline __m256 exp_ps(__m256 x) {
+            const __m256 tiny = _mm256_cmp_ps(x, _mm256_set1_ps(-87.3f), _CMP_LT_OQ);
+            x = _mm256_min_ps(_mm256_set1_ps(88.3f), _mm256_max_ps(_mm256_set1_ps(-87.3f), x));
+            const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+            r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+            __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507e-3f));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073e-3f));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894e-2f));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459e-1f));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201e-1f));
+            p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+            const __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+            return _mm256_andnot_ps(tiny, _mm256_mul_ps(p, _mm256_castsi256_ps(e)));
+        }
+
+        inline __m256 activate(__m256 v, Activation act) {
+            if (act == Activation::ReLU) return _mm256_max_ps(v, _mm256_setzero_ps());
+            if (act == Activation::GELU) {
+                // x / (1 + e^(-2u)), see kernels::gelu
+                const __m256 v3 = _mm256_mul_ps(_mm256_mul_ps(v, v), v);
+                const __m256 u = _mm256_mul_ps(_mm256_set1_ps(0.7978845608f),
+                    _mm256_fmadd_ps(_mm256_set1_ps(0.044715f), v3, v));
+                const __m256 e = exp_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), u));
+                return _mm256_div_ps(v, _mm256_add_ps(_mm256_set1_ps(1.0f), e));
+            }
+            return v;
+        }
+
+        // 6x16 tile = 12 ymm accumulators, 2 ymm for the B row, 1 for the A broadcast
+        void gemm_6x16(size_t kc, const float* a, const float* b,
+            float* c, size_t ldc, bool accumulate, const GemmEpilogue* ep) {
+            __m256 acc[kMR][2];
+            for (size_t i = 0; i < kMR; ++i) {
+                acc[i][0] = _mm256_setzero_ps();
+                acc[i][1] = _mm256_setzero_ps();
+            }
+
+            for (size_t p = 0; p < kc; ++p) {
+                __m256 b0 = _mm256_loadu_ps(b);
+                __m256 b1 = _mm256_loadu_ps(b + 8);
+                for (size_t i = 0; i < kMR; ++i) {
+                    __m256 ai = _mm256_broadcast_ss(a + i);
+                    acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+                    acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+                }
+                a += kMR;
+                b += kNR;
+            }
+
+            __m256 bias0 = _mm256_setzero_ps(), bias1 = _mm256_setzero_ps();
+            if (ep && ep->bias) {
+                bias0 = _mm256_loadu_ps(ep->bias);
+                bias1 = _mm256_loadu_ps(ep->bias + 8);
+            }
+            for (size_t i = 0; i < kMR; ++i) {
+                float* row = c + i * ldc;
+                if (accumulate) {
+                    acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(row));
+                    acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(row + 8));
+                }
+                if (ep) {
+                    acc[i][0] = activate(_mm256_add_ps(acc[i][0], bias0), ep->act);
+                    acc[i][1] = activate(_mm256_add_ps(acc[i][1], bias1), ep->act);
+                    if (ep->residual) {
+                        const float* res = ep->residual + i * ep->ldr;
+                        acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(res));
+                        acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(res + 8));
+                    }
+                }
+                _mm256_storeu_ps(row, acc[i][0]);
+                _mm256_storeu_ps(row + 8, acc[i][1]);
+            }
+        }
+
+        constexpr size_t kQMR = 4;
+        constexpr size_t kQNR = 16;
+
+        // 4x16 int32 tile, per k group two B vectors (8 columns x 4 k each)
+        // maddubs multiplies u8 * s8 and adds neighbours into s16 pairs,
+        // madd with 1 adds the two pairs of a column into its s32 lane
+        // a pair saturates above 32767 once a > 127, so Split runs a as
+        // lo7 + 128 * hi1 through two maddubs (both exact) for full-range u8
+        template <bool Split>
+        void qgemm_4x16(size_t kg, const uint8_t* a, const int8_t* b,
+            int32_t* c, size_t ldc, bool accumulate) {
+            const __m256i ones = _mm256_set1_epi16(1);
+            const __m256i k128 = _mm256_set1_epi16(128);
+            __m256i acc[kQMR][2];
+            for (size_t i = 0; i < kQMR; ++i) {
+                acc[i][0] = _mm256_setzero_si256();
+                acc[i][1] = _mm256_setzero_si256();
+            }
+
+            for (size_t g = 0; g < kg; ++g) {
+                __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+                __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 32));
+                for (size_t i = 0; i < kQMR; ++i) {
+                    uint32_t w;
+                    std::memcpy(&w, a + i * 4, sizeof(w));
+                    if constexpr (Split) {
+                        __m256i lo = _mm256_set1_epi32(static_cast<int>(w & 0x7f7f7f7fu));
+                        __m256i hi = _mm256_set1_epi32(static_cast<int>((w >> 7) & 0x01010101u));
+                        __m256i s0 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(lo, b0), ones),
+                            _mm256_madd_epi16(_mm256_maddubs_epi16(hi, b0), k128));
+                        __m256i s1 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(lo, b1), ones),
+                            _mm256_madd_epi16(_mm256_maddubs_epi16(hi, b1), k128));
+                        acc[i][0] = _mm256_add_epi32(acc[i][0], s0);
+                        acc[i][1] = _mm256_add_epi32(acc[i][1], s1);
+                    }
+                    else {
+                        __m256i ai = _mm256_set1_epi32(static_cast<int>(w));
+                        acc[i][0] = _mm256_add_epi32(acc[i][0], _mm256_madd_epi16(_mm256_maddubs_epi16(ai, b0), ones));
+                        acc[i][1] = _mm256_add_epi32(acc[i][1], _mm256_madd_epi16(_mm256_maddubs_epi16(ai, b1), ones));
+                    }
+                }
+                a += kQMR * 4;
+                b += kQNR * 4;
+            }
+
+            for (size_t i = 0; i < kQMR; ++i) {
+                __m256i* row = reinterpret_cast<__m256i*>(c + i * ldc);
+                if (accumulate) {
+                    acc[i][0] = _mm256_add_epi32(acc[i][0], _mm256_loadu_si256(row));
+                    acc[i][1] = _mm256_add_epi32(acc[i][1], _mm256_loadu_si256(row + 1));
+                }
+                _mm256_storeu_si256(row, acc[i][0]);
+                _mm256_storeu_si256(row + 1, acc[i][1]);
+            }
+        }
+
+        // 32 floats per iteration, then 8-wide, then a scalar tail
+        template <class VecOp, class ScalarOp>
+        inline void binary_loop(const float* a, const float* b, float* out, size_t n,
+            VecOp vop, ScalarOp sop) {
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256 r0 = vop(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+                __m256 r1 = vop(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+                __m256 r2 = vop(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16));
+                __m256 r3 = vop(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24));
+                _mm256_storeu_ps(out + i, r0);
+                _mm256_storeu_ps(out + i + 8, r1);
+                _mm256_storeu_ps(out + i + 16, r2);
+                _mm256_storeu_ps(out + i + 24, r3);
+            }
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(out + i, vop(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            }
+            for (; i < n; ++i) out[i] = sop(a[i], b[i]);
+        }
+
+        // in-register 8x8 transpose: r[q] holds row q, afterwards column q
+        inline void transpose8x8(__m256 r[8]) {
+            __m256 t[8], u[8];
+            for (int q = 0; q < 8; q += 2) {
+                t[q] = _mm256_unpacklo_ps(r[q], r[q + 1]);
+                t[q + 1] = _mm256_unpackhi_ps(r[q], r[q + 1]);
+            }
+            for (int q = 0; q < 8; q += 4) {
+                u[q] = _mm256_shuffle_ps(t[q], t[q + 2], 0x44);
+                u[q + 1] = _mm256_shuffle_ps(t[q], t[q + 2], 0xee);
+                u[q + 2] = _mm256_shuffle_ps(t[q + 1], t[q + 3], 0x44);
+                u[q + 3] = _mm256_shuffle_ps(t[q + 1], t[q + 3], 0xee);
+            }
+            for (int q = 0; q < 4; ++q) {
+                r[q] = _mm256_permute2f128_ps(u[q], u[q + 4], 0x20);
+                r[q + 4] = _mm256_permute2f128_ps(u[q], u[q + 4], 0x31);
+            }
+        }
+
+        // 8 source lines at a time through 8x8 register transposes
+        void pack_t(const float* src, size_t ld, size_t rows, size_t n, float* out, size_t ldo) {
+            size_t i = 0;
+            for (; i + 8 <= rows; i += 8) {
+                const float* s = src + i * ld;
+                size_t p = 0;
+                for (; p + 8 <= n; p += 8) {
+                    __m256 r[8];
+                    for (int q = 0; q < 8; ++q) r[q] = _mm256_loadu_ps(s + q * ld + p);
+                    transpose8x8(r);
+                    for (int q = 0; q < 8; ++q) _mm256_storeu_ps(out + (p + q) * ldo + i, r[q]);
+                }
+                for (; p < n; ++p) {
+                    for (size_t q = 0; q < 8; ++q) out[p * ldo + i + q] = s[q * ld + p];
+                }
+            }
+            for (; i < rows; ++i) {
+                for (size_t p = 0; p < n; ++p) out[p * ldo + i] = src[i * ld + p];
+            }
+        }
+
+        inline float hsum(__m256 v) {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_add_ss(s, _mm_movehdup_ps(s));
+            return _mm_cvtss_f32(s);
+        }
+
+        // 4 rows x 2 accumulators share every x load, then single rows
+        void dot_rows(const float* w, size_t ldw, size_t rows, const float* x, size_t n, float* out, size_t ldo) {
+            size_t r = 0;
+            for (; r + 4 <= rows; r += 4) {
+                const float* w0 = w + r * ldw;
+                __m256 acc[4][2];
+                for (int t = 0; t < 4; ++t) acc[t][0] = acc[t][1] = _mm256_setzero_ps();
+                size_t p = 0;
+                for (; p + 16 <= n; p += 16) {
+                    __m256 x0 = _mm256_loadu_ps(x + p);
+                    __m256 x1 = _mm256_loadu_ps(x + p + 8);
+                    for (int t = 0; t < 4; ++t) {
+                        acc[t][0] = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + t * ldw + p), x0, acc[t][0]);
+                        acc[t][1] = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + t * ldw + p + 8), x1, acc[t][1]);
+                    }
+                }
+                for (int t = 0; t < 4; ++t) {
+                    float sum = hsum(_mm256_add_ps(acc[t][0], acc[t][1]));
+                    for (size_t q = p; q < n; ++q) sum += w0[t * ldw + q] * x[q];
+                    out[(r + t) * ldo] = sum;
+                }
+            }
+            for (; r < rows; ++r) {
+                const float* wr = w + r * ldw;
+                __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+                size_t p = 0;
+                for (; p + 16 <= n; p += 16) {
+                    a0 = _mm256_fmadd_ps(_mm256_loadu_ps(wr + p), _mm256_loadu_ps(x + p), a0);
+                    a1 = _mm256_fmadd_ps(_mm256_loadu_ps(wr + p + 8), _mm256_loadu_ps(x + p + 8), a1);
+                }
+                float sum = hsum(_mm256_add_ps(a0, a1));
+                for (; p < n; ++p) sum += wr[p] * x[p];
+                out[r * ldo] = sum;
+            }
+        }
+
+        // 4 weight rows per pass over y
+        void axpy_rows(const float* w, size_t ldw, size_t k, const float* x, float* y, size_t n, bool accumulate) {
+            if (!accumulate) std::memset(y, 0, n * sizeof(float));
+            size_t p = 0;
+            for (; p + 4 <= k; p += 4) {
+                const float* w0 = w + p * ldw;
+                const __m256 x0 = _mm256_set1_ps(x[p]), x1 = _mm256_set1_ps(x[p + 1]);
+                const __m256 x2 = _mm256_set1_ps(x[p + 2]), x3 = _mm256_set1_ps(x[p + 3]);
+                size_t j = 0;
+                for (; j + 8 <= n; j += 8) {
+                    __m256 v = _mm256_loadu_ps(y + j);
+                    v = _mm256_fmadd_ps(x0, _mm256_loadu_ps(w0 + j), v);
+                    v = _mm256_fmadd_ps(x1, _mm256_loadu_ps(w0 + ldw + j), v);
+                    v = _mm256_fmadd_ps(x2, _mm256_loadu_ps(w0 + 2 * ldw + j), v);
+                    v = _mm256_fmadd_ps(x3, _mm256_loadu_ps(w0 + 3 * ldw + j), v);
+                    _mm256_storeu_ps(y + j, v);
+                }
+                for (; j < n; ++j) {
+                    y[j] += x[p] * w0[j] + x[p + 1] * w0[ldw + j] + x[p + 2] * w0[2 * ldw + j] + x[p + 3] * w0[3 * ldw + j];
+                }
+            }
+            for (; p < k; ++p) {
+                const float* wp = w + p * ldw;
+                const __m256 xp = _mm256_set1_ps(x[p]);
+                size_t j = 0;
+                for (; j + 8 <= n; j += 8) {
+                    _mm256_storeu_ps(y + j, _mm256_fmadd_ps(xp, _mm256_loadu_ps(wp + j), _mm256_loadu_ps(y + j)));
+                }
+                for (; j < n; ++j) y[j] += x[p] * wp[j];
+            }
+        }
+
+        void add(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n,
+                [](__m256 x, __m256 y) { return _mm256_add_ps(x, y); },
+                [](float x, float y) { return x + y; });
+        }
+
+        void sub(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n,
+                [](__m256 x, __m256 y) { return _mm256_sub_ps(x, y); },
+                [](float x, float y) { return x - y; });
+        }
+
+        void mul(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n,
+                [](__m256 x, __m256 y) { return _mm256_mul_ps(x, y); },
+                [](float x, float y) { return x * y; });
+        }
+
+        void relu(const float* x, float* out, size_t n) {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256 r0 = _mm256_max_ps(_mm256_loadu_ps(x + i), zero);
+                __m256 r1 = _mm256_max_ps(_mm256_loadu_ps(x + i + 8), zero);
+                __m256 r2 = _mm256_max_ps(_mm256_loadu_ps(x + i + 16), zero);
+                __m256 r3 = _mm256_max_ps(_mm256_loadu_ps(x + i + 24), zero);
+                _mm256_storeu_ps(out + i, r0);
+                _mm256_storeu_ps(out + i + 8, r1);
+                _mm256_storeu_ps(out + i + 16, r2);
+                _mm256_storeu_ps(out + i + 24, r3);
+            }
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_loadu_ps(x + i), zero));
+            }
+            for (; i < n; ++i) out[i] = (x[i] > 0.0f) ? x[i] : 0.0f;
+        }
+
+        // scalar head up to a 32-byte boundary, then aligned stores
+        void fill(float* out, float v, size_t n) {
+            size_t i = 0;
+            for (; i < n && (reinterpret_cast<uintptr_t>(out + i) & 31) != 0; ++i) out[i] = v;
+            const __m256 x = _mm256_set1_ps(v);
+            for (; i + 32 <= n; i += 32) {
+                _mm256_store_ps(out + i, x);
+                _mm256_store_ps(out + i + 8, x);
+                _mm256_store_ps(out + i + 16, x);
+                _mm256_store_ps(out + i + 24, x);
+            }
+            for (; i + 8 <= n; i += 8) _mm256_store_ps(out + i, x);
+            for (; i < n; ++i) out[i] = v;
+        }
+
+        // max_ps returns its second operand when either is NaN: passing a
+        // second keeps a NaN from a, the blend restores one from b
+        void maximum(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n,
+                [](__m256 x, __m256 y) {
+                    return _mm256_blendv_ps(_mm256_max_ps(y, x), y, _mm256_cmp_ps(y, y, _CMP_UNORD_Q));
+                },
+                [](float x, float y) { return (x > y || x != x) ? x : y; });
+        }
+
+        void minimum(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n,
+                [](__m256 x, __m256 y) {
+                    return _mm256_blendv_ps(_mm256_min_ps(y, x), y, _mm256_cmp_ps(y, y, _CMP_UNORD_Q));
+                },
+                [](float x, float y) { return (x < y || x != x) ? x : y; });
+        }
+
+        // 4 independent accumulators hide the add latency
+        float reduce_sum(const float* x, size_t n) {
+            __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+            __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                s0 = _mm256_add_ps(s0, _mm256_loadu_ps(x + i));
+                s1 = _mm256_add_ps(s1, _mm256_loadu_ps(x + i + 8));
+                s2 = _mm256_add_ps(s2, _mm256_loadu_ps(x + i + 16));
+                s3 = _mm256_add_ps(s3, _mm256_loadu_ps(x + i + 24));
+            }
+            for (; i + 8 <= n; i += 8) s0 = _mm256_add_ps(s0, _mm256_loadu_ps(x + i));
+            float s = hsum(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+            for (; i < n; ++i) s += x[i];
+            return s;
+        }
+
+        // max/min over 4 accumulators; NaNs are tracked in a separate mask
+        // because max_ps drops a NaN in its first operand
+        template <bool Max>
+        float reduce_extreme(const float* x, size_t n) {
+            auto op = [](__m256 a, __m256 b) { return Max ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b); };
+            auto sop = [](float a, float b) { return (Max ? a > b : a < b) ? a : b; };
+            const __m256 first = _mm256_set1_ps(x[0]);
+            __m256 m0 = first, m1 = first, m2 = first, m3 = first;
+            __m256 nan = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+                __m256 v2 = _mm256_loadu_ps(x + i + 16), v3 = _mm256_loadu_ps(x + i + 24);
+                m0 = op(v0, m0);
+                m1 = op(v1, m1);
+                m2 = op(v2, m2);
+                m3 = op(v3, m3);
+                nan = _mm256_or_ps(nan, _mm256_or_ps(_mm256_cmp_ps(v0, v1, _CMP_UNORD_Q), _mm256_cmp_ps(v2, v3, _CMP_UNORD_Q)));
+            }
+            for (; i + 8 <= n; i += 8) {
+                __m256 v = _mm256_loadu_ps(x + i);
+                m0 = op(v, m0);
+                nan = _mm256_or_ps(nan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+            }
+            __m256 m = op(op(m0, m1), op(m2, m3));
+            __m128 h = Max ? _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1))
+                : _mm_min_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, h);
+            float r = sop(sop(lanes[0], lanes[1]), sop(lanes[2], lanes[3]));
+            bool has_nan = _mm256_movemask_ps(nan) != 0;
+            for (; i < n; ++i) {
+                r = sop(x[i], r);
+                has_nan |= x[i] != x[i];
+            }
+            return has_nan ? std::numeric_limits<float>::quiet_NaN() : r;
+        }
+
+        float reduce_max(const float* x, size_t n) {
+            return reduce_extreme<true>(x, n);
+        }
+
+        float reduce_min(const float* x, size_t n) {
+            return reduce_extreme<false>(x, n);
+        }
+
+        // per-lane running max; the lane sums are rescaled once per 4 vectors
+        // (by e^(old max - new max)), then the lanes and the scalar tail are
+        // merged the same way
+        void softmax_stats(const float* x, size_t n, float* max, float* sum) {
+            __m256 m = _mm256_set1_ps(-std::numeric_limits<float>::max());
+            __m256 s = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+                __m256 v2 = _mm256_loadu_ps(x + i + 16), v3 = _mm256_loadu_ps(x + i + 24);
+                __m256 bm = _mm256_max_ps(_mm256_max_ps(_mm256_max_ps(v0, v1), _mm256_max_ps(v2, v3)), m);
+                __m256 e = _mm256_add_ps(
+                    _mm256_add_ps(exp_ps(_mm256_sub_ps(v0, bm)), exp_ps(_mm256_sub_ps(v1, bm))),
+                    _mm256_add_ps(exp_ps(_mm256_sub_ps(v2, bm)), exp_ps(_mm256_sub_ps(v3, bm))));
+                s = _mm256_fmadd_ps(s, exp_ps(_mm256_sub_ps(m, bm)), e);
+                m = bm;
+            }
+            for (; i + 8 <= n; i += 8) {
+                __m256 v = _mm256_loadu_ps(x + i);
+                __m256 bm = _mm256_max_ps(v, m);
+                s = _mm256_fmadd_ps(s, exp_ps(_mm256_sub_ps(m, bm)), exp_ps(_mm256_sub_ps(v, bm)));
+                m = bm;
+            }
+            alignas(32) float lm[8], ls[8];
+            _mm256_store_ps(lm, m);
+            _mm256_store_ps(ls, s);
+            float M = lm[0];
+            for (int l = 1; l < 8; ++l) M = lm[l] > M ? lm[l] : M;
+            float S = 0.0f;
+            for (int l = 0; l < 8; ++l) S += ls[l] * std::exp(lm[l] - M);
+            for (; i < n; ++i) {
+                if (x[i] > M) {
+                    S = S * std::exp(M - x[i]) + 1.0f;
+                    M = x[i];
+                }
+                else {
+                    S += std::exp(x[i] - M);
+                }
+            }
+            *max = M;
+            *sum = S;
+        }
+
+        void exp_scale(const float* x, float shift, float scale, float* out, size_t n) {
+            const __m256 sh = _mm256_set1_ps(shift), sc = _mm256_set1_ps(scale);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(exp_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), sh)), sc));
+            }
+            for (; i < n; ++i) out[i] = std::exp(x[i] - shift) * scale;
+        }
+
+        // (mean, m2) of two lane sets that have seen the same count c each
+        inline void merge_moments(__m256& mu, __m256& q, __m256 mu2, __m256 q2, float c) {
+            const __m256 d = _mm256_sub_ps(mu2, mu);
+            mu = _mm256_mul_ps(_mm256_add_ps(mu, mu2), _mm256_set1_ps(0.5f));
+            q = _mm256_fmadd_ps(_mm256_mul_ps(d, d), _mm256_set1_ps(0.5f * c), _mm256_add_ps(q, q2));
+        }
+
+        // Welford per lane in 4 accumulators (all lanes share the count, so
+        // the update needs one scalar reciprocal per step), merged pairwise,
+        // then the lanes merged and the scalar tail continued
+        void row_moments(const float* x, size_t n, float* mean, float* m2) {
+            __m256 mu0 = _mm256_setzero_ps(), mu1 = mu0, mu2 = mu0, mu3 = mu0;
+            __m256 q0 = mu0, q1 = mu0, q2 = mu0, q3 = mu0;
+            auto step = [](__m256& mu, __m256& q, __m256 v, __m256 r) {
+                const __m256 d = _mm256_sub_ps(v, mu);
+                mu = _mm256_fmadd_ps(d, r, mu);
+                q = _mm256_fmadd_ps(d, _mm256_sub_ps(v, mu), q);
+            };
+            float c = 0.0f;
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                c += 1.0f;
+                const __m256 r = _mm256_set1_ps(1.0f / c);
+                step(mu0, q0, _mm256_loadu_ps(x + i), r);
+                step(mu1, q1, _mm256_loadu_ps(x + i + 8), r);
+                step(mu2, q2, _mm256_loadu_ps(x + i + 16), r);
+                step(mu3, q3, _mm256_loadu_ps(x + i + 24), r);
+            }
+            merge_moments(mu0, q0, mu1, q1, c);
+            merge_moments(mu2, q2, mu3, q3, c);
+            merge_moments(mu0, q0, mu2, q2, 2.0f * c);
+            c *= 4.0f;
+            for (; i + 8 <= n; i += 8) {
+                c += 1.0f;
+                step(mu0, q0, _mm256_loadu_ps(x + i), _mm256_set1_ps(1.0f / c));
+            }
+            alignas(32) float lm[8], lq[8];
+            _mm256_store_ps(lm, mu0);
+            _mm256_store_ps(lq, q0);
+            float M = 0.0f, Q = 0.0f;
+            for (int l = 0; l < 8; ++l) M += lm[l];
+            M *= 0.125f;
+            for (int l = 0; l < 8; ++l) Q += lq[l] + c * (lm[l] - M) * (lm[l] - M);
+            float N = 8.0f * c;
+            for (; i < n; ++i) {
+                N += 1.0f;
+                const float d = x[i] - M;
+                M += d / N;
+                Q += d * (x[i] - M);
+            }
+            *mean = M;
+            *m2 = Q;
+        }
+
+        template <bool W, bool B>
+        void norm_apply_impl(const float* x, float mean, float rstd, const float* w, const float* b, float* out, size_t n) {
+            const __m256 mu = _mm256_set1_ps(mean), rs = _mm256_set1_ps(rstd);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), mu), rs);
+                if (W && B) t = _mm256_fmadd_ps(t, _mm256_loadu_ps(w + i), _mm256_loadu_ps(b + i));
+                else if (W) t = _mm256_mul_ps(t, _mm256_loadu_ps(w + i));
+                else if (B) t = _mm256_add_ps(t, _mm256_loadu_ps(b + i));
+                _mm256_storeu_ps(out + i, t);
+            }
+            for (; i < n; ++i) {
+                float t = (x[i] - mean) * rstd;
+                if (W) t *= w[i];
+                if (B) t += b[i];
+                out[i] = t;
+            }
+        }
+
+        void norm_apply(const float* x, float mean, float rstd, const float* w, const float* b, float* out, size_t n) {
+            if (w && b) norm_apply_impl<true, true>(x, mean, rstd, w, b, out, n);
+            else if (w) norm_apply_impl<true, false>(x, mean, rstd, w, b, out, n);
+            else if (b) norm_apply_impl<false, true>(x, mean, rstd, w, b, out, n);
+            else norm_apply_impl<false, false>(x, mean, rstd, w, b, out, n);
+        }
+
+        // bf16 = float bits rounded to nearest even at bit 16; NaNs are
+        // quieted instead of rounded (rounding could carry into the sign)
+        inline __m128i cvt_bf16(__m256 v) {
+            const __m256i x = _mm256_castps_si256(v);
+            const __m256i abs = _mm256_and_si256(x, _mm256_set1_epi32(0x7fffffff));
+            const __m256i nan = _mm256_cmpgt_epi32(abs, _mm256_set1_epi32(0x7f800000));
+            const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+            const __m256i rounded = _mm256_add_epi32(x, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff)));
+            const __m256i quiet = _mm256_or_si256(x, _mm256_set1_epi32(0x400000));
+            const __m256i r = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, nan), 16);
+            // packus works per 128-bit lane: take qwords 0 and 2
+            const __m256i p = _mm256_packus_epi32(r, r);
+            return _mm256_castsi256_si128(_mm256_permute4x64_epi64(p, 0x08));
+        }
+
+        void f32_to_bf16(const float* x, uint16_t* out, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), cvt_bf16(_mm256_loadu_ps(x + i)));
+            }
+            for (; i < n; ++i) out[i] = core::float_to_bf16_bits(x[i]);
+        }
+
+        void bf16_to_f32(const uint16_t* x, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+                _mm256_storeu_ps(out + i, _mm256_castsi256_ps(_mm256_slli_epi32(w, 16)));
+            }
+            for (; i < n; ++i) out[i] = core::bf16_bits_to_float(x[i]);
+        }
+
+        // IEEE half through F16C
+        void f32_to_f16(const float* x, uint16_t* out, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(x + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+            }
+            for (; i < n; ++i) out[i] = core::float_to_half_bits(x[i]);
+        }
+
+        void f16_to_f32(const uint16_t* x, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+                _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+            }
+            for (; i < n; ++i) out[i] = core::half_bits_to_float(x[i]);
+        }
+
+    } // namespace
+
+    const KernelTable& avx2_table() {
+        static const KernelTable t{
+            "avx2",
+            { kMR, kNR, gemm_6x16 },
+            { kQMR, kQNR, qgemm_4x16<false>, qgemm_4x16<true> },
+            pack_t,
+            dot_rows, axpy_rows,
+            add, sub, mul, relu,
+            maximum, minimum,
+            fill,
+            reduce_sum, reduce_max, reduce_min,
+            softmax_stats, exp_scale,
+            row_moments, norm_apply,
+            f32_to_bf16, bf16_to_f32, f32_to_f16, f16_to_f32,
+        };
+        return t;
+    }
+
+} // namespace ml::ops::kernels
@@ -0,0 +1,525 @@
+#include "ops/kernels/kernels.hpp"
+#include "ml/core/dtype.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include <limits>
+
+// AVX-512F kernels, this file is compiled with -mavx512f (/arch:AVX512)
+// and only reached when core::cpu_level() >= AVX512
+
+namespace ml::ops::kernels {
+
+    namespace {
+
+        constexpr size_t kMR = 8;
+        constexpr size_t kNR = 32;
+
+        // e^x, same reduction and polynomial as the AVX2 exp_ps
+        inline __m512 exp_ps(__m512 x) {
+            const __mmask16 keep = _mm512_cmp_ps_mask(x, _mm512_set1_ps(-87.3f), _CMP_NLT_UQ);
+            x = _mm512_min_ps(_mm512_set1_ps(88.3f), _mm512_max_ps(_mm512_set1_ps(-87.3f), x));
+            const __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504f)),
+                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+            r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+            __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.3981999507e-3f));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(8.3334519073e-3f));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(4.1665795894e-2f));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.6666665459e-1f));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(5.0000001201e-1f));
+            p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+            const __m512i e = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+            return _mm512_maskz_mul_ps(keep, p, _mm512_castsi512_ps(e));
+        }
+
+        inline __m512 activate(__m512 v, Activation act) {
+            if (act == Activation::ReLU) return _mm512_max_ps(v, _mm512_setzero_ps());
+            if (act == Activation::GELU) {
+                const __m512 v3 = _mm512_mul_ps(_mm512_mul_ps(v, v), v);
+                const __m512 u = _mm512_mul_ps(_mm512_set1_ps(0.7978845608f),
+                    _mm512_fmadd_ps(_mm512_set1_ps(0.044715f), v3, v));
+                const __m512 e = exp_ps(_mm512_mul_ps(_mm512_set1_ps(-2.0f), u));
+                return _mm512_div_ps(v, _mm512_add_ps(_mm512_set1_ps(1.0f), e));
+            }
+            return v;
+        }
+
+        // 8x32 tile = 16 zmm accumulators out of 32 registers
+        void gemm_8x32(size_t kc, const float* a, const float* b,
+            float* c, size_t ldc, bool accumulate, const GemmEpilogue* ep) {
+            __m512 acc[kMR][2];
+            for (size_t i = 0; i < kMR; ++i) {
+                acc[i][0] = _mm512_setzero_ps();
+                acc[i][1] = _mm512_setzero_ps();
+            }
+
+            for (size_t p = 0; p < kc; ++p) {
+                __m512 b0 = _mm512_loadu_ps(b);
+                __m512 b1 = _mm512_loadu_ps(b + 16);
+                for (size_t i = 0; i < kMR; ++i) {
+                    __m512 ai = _mm512_set1_ps(a[i]);
+                    acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+                    acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+                }
+                a += kMR;
+                b += kNR;
+            }
+
+            __m512 bias0 = _mm512_setzero_ps(), bias1 = _mm512_setzero_ps();
+            if (ep && ep->bias) {
+                bias0 = _mm512_loadu_ps(ep->bias);
+                bias1 = _mm512_loadu_ps(ep->bias + 16);
+            }
+            for (size_t i = 0; i < kMR; ++i) {
+                float* row = c + i * ldc;
+                if (accumulate) {
+                    acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(row));
+                    acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(row + 16));
+                }
+                if (ep) {
+                    acc[i][0] = activate(_mm512_add_ps(acc[i][0], bias0), ep->act);
+                    acc[i][1] = activate(_mm512_add_ps(acc[i][1], bias1), ep->act);
+                    if (ep->residual) {
+                        const float* res = ep->residual + i * ep->ldr;
+                        acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(res));
+                        acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(res + 16));
+                    }
+                }
+                _mm512_storeu_ps(row, acc[i][0]);
+                _mm512_storeu_ps(row + 16, acc[i][1]);
+            }
+        }
+
+        // lanes [0, n) of a 16-wide vector
+        inline __mmask16 tail_mask(size_t n) {
+            return static_cast<__mmask16>((1u << n) - 1u);
+        }
+
+        // 64 floats per iteration, 16-wide, then one masked tail
+        template <class VecOp>
+        inline void binary_loop(const float* a, const float* b, float* out, size_t n, VecOp vop) {
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                __m512 r0 = vop(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+                __m512 r1 = vop(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+                __m512 r2 = vop(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32));
+                __m512 r3 = vop(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48));
+                _mm512_storeu_ps(out + i, r0);
+                _mm512_storeu_ps(out + i + 16, r1);
+                _mm512_storeu_ps(out + i + 32, r2);
+                _mm512_storeu_ps(out + i + 48, r3);
+            }
+            for (; i + 16 <= n; i += 16) {
+                _mm512_storeu_ps(out + i, vop(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+            }
+            if (i < n) {
+                __mmask16 m = tail_mask(n - i);
+                __m512 r = vop(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i));
+                _mm512_mask_storeu_ps(out + i, m, r);
+            }
+        }
+
+        // 4 rows x 2 accumulators share every x load, masked tail, then single rows
+        void dot_rows(const float* w, size_t ldw, size_t rows, const float* x, size_t n, float* out, size_t ldo) {
+            const size_t n32 = n / 32 * 32;
+            const size_t rem = n - n32;
+            const __mmask16 m0 = tail_mask(rem < 16 ? rem : 16);
+            const __mmask16 m1 = tail_mask(rem > 16 ? rem - 16 : 0);
+            size_t r = 0;
+            for (; r + 4 <= rows; r += 4) {
+                const float* w0 = w + r * ldw;
+                __m512 acc[4][2];
+                for (int t = 0; t < 4; ++t) acc[t][0] = acc[t][1] = _mm512_setzero_ps();
+                for (size_t p = 0; p < n32; p += 32) {
+                    __m512 x0 = _mm512_loadu_ps(x + p);
+                    __m512 x1 = _mm512_loadu_ps(x + p + 16);
+                    for (int t = 0; t < 4; ++t) {
+                        acc[t][0] = _mm512_fmadd_ps(_mm512_loadu_ps(w0 + t * ldw + p), x0, acc[t][0]);
+                        acc[t][1] = _mm512_fmadd_ps(_mm512_loadu_ps(w0 + t * ldw + p + 16), x1, acc[t][1]);
+                    }
+                }
+                if (rem) {
+                    __m512 x0 = _mm512_maskz_loadu_ps(m0, x + n32);
+                    __m512 x1 = _mm512_maskz_loadu_ps(m1, x + n32 + 16);
+                    for (int t = 0; t < 4; ++t) {
+                        acc[t][0] = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m0, w0 + t * ldw + n32), x0, acc[t][0]);
+                        acc[t][1] = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m1, w0 + t * ldw + n32 + 16), x1, acc[t][1]);
+                    }
+                }
+                for (int t = 0; t < 4; ++t) out[(r + t) * ldo] = _mm512_reduce_add_ps(_mm512_add_ps(acc[t][0], acc[t][1]));
+            }
+            for (; r < rows; ++r) {
+                const float* wr = w + r * ldw;
+                __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+                for (size_t p = 0; p < n32; p += 32) {
+                    a0 = _mm512_fmadd_ps(_mm512_loadu_ps(wr + p), _mm512_loadu_ps(x + p), a0);
+                    a1 = _mm512_fmadd_ps(_mm512_loadu_ps(wr + p + 16), _mm512_loadu_ps(x + p + 16), a1);
+                }
+                if (rem) {
+                    a0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m0, wr + n32), _mm512_maskz_loadu_ps(m0, x + n32), a0);
+                    a1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m1, wr + n32 + 16), _mm512_maskz_loadu_ps(m1, x + n32 + 16), a1);
+                }
+                out[r * ldo] = _mm512_reduce_add_ps(_mm512_add_ps(a0, a1));
+            }
+        }
+
+        // 4 weight rows per pass over y, masked tail
+        void axpy_rows(const float* w, size_t ldw, size_t k, const float* x, float* y, size_t n, bool accumulate) {
+            if (!accumulate) std::memset(y, 0, n * sizeof(float));
+            const size_t n16 = n / 16 * 16;
+            const __mmask16 mt = tail_mask(n - n16);
+            size_t p = 0;
+            for (; p + 4 <= k; p += 4) {
+                const float* w0 = w + p * ldw;
+                const __m512 x0 = _mm512_set1_ps(x[p]), x1 = _mm512_set1_ps(x[p + 1]);
+                const __m512 x2 = _mm512_set1_ps(x[p + 2]), x3 = _mm512_set1_ps(x[p + 3]);
+                for (size_t j = 0; j < n16; j += 16) {
+                    __m512 v = _mm512_loadu_ps(y + j);
+                    v = _mm512_fmadd_ps(x0, _mm512_loadu_ps(w0 + j), v);
+                    v = _mm512_fmadd_ps(x1, _mm512_loadu_ps(w0 + ldw + j), v);
+                    v = _mm512_fmadd_ps(x2, _mm512_loadu_ps(w0 + 2 * ldw + j), v);
+                    v = _mm512_fmadd_ps(x3, _mm512_loadu_ps(w0 + 3 * ldw + j), v);
+                    _mm512_storeu_ps(y + j, v);
+                }
+                if (mt) {
+                    __m512 v = _mm512_maskz_loadu_ps(mt, y + n16);
+                    v = _mm512_fmadd_ps(x0, _mm512_maskz_loadu_ps(mt, w0 + n16), v);
+                    v = _mm512_fmadd_ps(x1, _mm512_maskz_loadu_ps(mt, w0 + ldw + n16), v);
+                    v = _mm512_fmadd_ps(x2, _mm512_maskz_loadu_ps(mt, w0 + 2 * ldw + n16), v);
+                    v = _mm512_fmadd_ps(x3, _mm512_maskz_loadu_ps(mt, w0 + 3 * ldw + n16), v);
+                    _mm512_mask_storeu_ps(y + n16, mt, v);
+                }
+            }
+            for (; p < k; ++p) {
+                const float* wp = w + p * ldw;
+                const __m512 xp = _mm512_set1_ps(x[p]);
+                for (size_t j = 0; j < n16; j += 16) {
+                    _mm512_storeu_ps(y + j, _mm512_fmadd_ps(xp, _mm512_loadu_ps(wp + j), _mm512_loadu_ps(y + j)));
+                }
+                if (mt) {
+                    __m512 v = _mm512_fmadd_ps(xp, _mm512_maskz_loadu_ps(mt, wp + n16), _mm512_maskz_loadu_ps(mt, y + n16));
+                    _mm512_mask_storeu_ps(y + n16, mt, v);
+                }
+            }
+        }
+
+        void add(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n, [](__m512 x, __m512 y) { return _mm512_add_ps(x, y); });
+        }
+
+        void sub(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n, [](__m512 x, __m512 y) { return _mm512_sub_ps(x, y); });
+        }
+
+        void mul(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n, [](__m512 x, __m512 y) { return _mm512_mul_ps(x, y); });
+        }
+
+        // max_ps returns its second operand when either is NaN: passing a
+        // second keeps a NaN from a, the blend restores one from b
+        void maximum(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n, [](__m512 x, __m512 y) {
+                return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(y, y, _CMP_UNORD_Q), _mm512_max_ps(y, x), y);
+                });
+        }
+
+        void minimum(const float* a, const float* b, float* out, size_t n) {
+            binary_loop(a, b, out, n, [](__m512 x, __m512 y) {
+                return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(y, y, _CMP_UNORD_Q), _mm512_min_ps(y, x), y);
+                });
+        }
+
+        // 4 independent accumulators, the tail is a masked load of zeros
+        float reduce_sum(const float* x, size_t n) {
+            __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+            __m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                s0 = _mm512_add_ps(s0, _mm512_loadu_ps(x + i));
+                s1 = _mm512_add_ps(s1, _mm512_loadu_ps(x + i + 16));
+                s2 = _mm512_add_ps(s2, _mm512_loadu_ps(x + i + 32));
+                s3 = _mm512_add_ps(s3, _mm512_loadu_ps(x + i + 48));
+            }
+            for (; i + 16 <= n; i += 16) s0 = _mm512_add_ps(s0, _mm512_loadu_ps(x + i));
+            if (i < n) s1 = _mm512_add_ps(s1, _mm512_maskz_loadu_ps(tail_mask(n - i), x + i));
+            return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+        }
+
+        // max/min over 4 accumulators, NaNs collected in a mask (max_ps
+        // drops a NaN in its first operand); masked-off tail lanes keep m0
+        template <bool Max>
+        float reduce_extreme(const float* x, size_t n) {
+            auto op = [](__m512 a, __m512 b) { return Max ? _mm512_max_ps(a, b) : _mm512_min_ps(a, b); };
+            const __m512 first = _mm512_set1_ps(x[0]);
+            __m512 m0 = first, m1 = first, m2 = first, m3 = first;
+            __mmask16 nan = 0;
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                __m512 v0 = _mm512_loadu_ps(x + i), v1 = _mm512_loadu_ps(x + i + 16);
+                __m512 v2 = _mm512_loadu_ps(x + i + 32), v3 = _mm512_loadu_ps(x + i + 48);
+                m0 = op(v0, m0);
+                m1 = op(v1, m1);
+                m2 = op(v2, m2);
+                m3 = op(v3, m3);
+                nan |= _mm512_cmp_ps_mask(v0, v1, _CMP_UNORD_Q) | _mm512_cmp_ps_mask(v2, v3, _CMP_UNORD_Q);
+            }
+            for (; i + 16 <= n; i += 16) {
+                __m512 v = _mm512_loadu_ps(x + i);
+                m0 = op(v, m0);
+                nan |= _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+            }
+            if (i < n) {
+                const __mmask16 mt = tail_mask(n - i);
+                __m512 v = _mm512_maskz_loadu_ps(mt, x + i);
+                m0 = Max ? _mm512_mask_max_ps(m0, mt, v, m0) : _mm512_mask_min_ps(m0, mt, v, m0);
+                nan |= _mm512_mask_cmp_ps_mask(mt, v, v, _CMP_UNORD_Q);
+            }
+            if (nan) return std::numeric_limits<float>::quiet_NaN();
+            __m512 m = op(op(m0, m1), op(m2, m3));
+            return Max ? _mm512_reduce_max_ps(m) : _mm512_reduce_min_ps(m);
+        }
+
+        float reduce_max(const float* x, size_t n) {
+            return reduce_extreme<true>(x, n);
+        }
+
+        float reduce_min(const float* x, size_t n) {
+            return reduce_extreme<false>(x, n);
+        }
+
+        // per-lane running max, lane sums rescaled once per 4 vectors, see
+        // the AVX2 kernel; the tail lanes are masked out of the sum
+        void softmax_stats(const float* x, size_t n, float* max, float* sum) {
+            __m512 m = _mm512_set1_ps(-std::numeric_limits<float>::max());
+            __m512 s = _mm512_setzero_ps();
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                __m512 v0 = _mm512_loadu_ps(x + i), v1 = _mm512_loadu_ps(x + i + 16);
+                __m512 v2 = _mm512_loadu_ps(x + i + 32), v3 = _mm512_loadu_ps(x + i + 48);
+                __m512 bm = _mm512_max_ps(_mm512_max_ps(_mm512_max_ps(v0, v1), _mm512_max_ps(v2, v3)), m);
+                __m512 e = _mm512_add_ps(
+                    _mm512_add_ps(exp_ps(_mm512_sub_ps(v0, bm)), exp_ps(_mm512_sub_ps(v1, bm))),
+                    _mm512_add_ps(exp_ps(_mm512_sub_ps(v2, bm)), exp_ps(_mm512_sub_ps(v3, bm))));
+                s = _mm512_fmadd_ps(s, exp_ps(_mm512_sub_ps(m, bm)), e);
+                m = bm;
+            }
+            for (; i + 16 <= n; i += 16) {
+                __m512 v = _mm512_loadu_ps(x + i);
+                __m512 bm = _mm512_max_ps(v, m);
+                s = _mm512_fmadd_ps(s, exp_ps(_mm512_sub_ps(m, bm)), exp_ps(_mm512_sub_ps(v, bm)));
+                m = bm;
+            }
+            if (i < n) {
+                const __mmask16 mt = tail_mask(n - i);
+                __m512 v = _mm512_mask_loadu_ps(m, mt, x + i);   // masked-off lanes hold m: max unchanged
+                __m512 bm = _mm512_max_ps(v, m);
+                s = _mm512_mul_ps(s, exp_ps(_mm512_sub_ps(m, bm)));
+                s = _mm512_mask_add_ps(s, mt, s, exp_ps(_mm512_sub_ps(v, bm)));
+                m = bm;
+            }
+            const float M = _mm512_reduce_max_ps(m);
+            *max = M;
+            *sum = _mm512_reduce_add_ps(_mm512_mul_ps(s, exp_ps(_mm512_sub_ps(m, _mm512_set1_ps(M)))));
+        }
+
+        void exp_scale(const float* x, float shift, float scale, float* out, size_t n) {
+            const __m512 sh = _mm512_set1_ps(shift), sc = _mm512_set1_ps(scale);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(exp_ps(_mm512_sub_ps(_mm512_loadu_ps(x + i), sh)), sc));
+            }
+            if (i < n) {
+                const __mmask16 mt = tail_mask(n - i);
+                _mm512_mask_storeu_ps(out + i, mt, _mm512_mul_ps(exp_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(mt, x + i), sh)), sc));
+            }
+        }
+
+        inline void merge_moments(__m512& mu, __m512& q, __m512 mu2, __m512 q2, float c) {
+            const __m512 d = _mm512_sub_ps(mu2, mu);
+            mu = _mm512_mul_ps(_mm512_add_ps(mu, mu2), _mm512_set1_ps(0.5f));
+            q = _mm512_fmadd_ps(_mm512_mul_ps(d, d), _mm512_set1_ps(0.5f * c), _mm512_add_ps(q, q2));
+        }
+
+        // per-lane Welford in 4 accumulators, see the AVX2 kernel
+        void row_moments(const float* x, size_t n, float* mean, float* m2) {
+            __m512 mu0 = _mm512_setzero_ps(), mu1 = mu0, mu2 = mu0, mu3 = mu0;
+            __m512 q0 = mu0, q1 = mu0, q2 = mu0, q3 = mu0;
+            auto step = [](__m512& mu, __m512& q, __m512 v, __m512 r) {
+                const __m512 d = _mm512_sub_ps(v, mu);
+                mu = _mm512_fmadd_ps(d, r, mu);
+                q = _mm512_fmadd_ps(d, _mm512_sub_ps(v, mu), q);
+            };
+            float c = 0.0f;
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                c += 1.0f;
+                const __m512 r = _mm512_set1_ps(1.0f / c);
+                step(mu0, q0, _mm512_loadu_ps(x + i), r);
+                step(mu1, q1, _mm512_loadu_ps(x + i + 16), r);
+                step(mu2, q2, _mm512_loadu_ps(x + i + 32), r);
+                step(mu3, q3, _mm512_loadu_ps(x + i + 48), r);
+            }
+            merge_moments(mu0, q0, mu1, q1, c);
+            merge_moments(mu2, q2, mu3, q3, c);
+            merge_moments(mu0, q0, mu2, q2, 2.0f * c);
+            c *= 4.0f;
+            for (; i + 16 <= n; i += 16) {
+                c += 1.0f;
+                step(mu0, q0, _mm512_loadu_ps(x + i), _mm512_set1_ps(1.0f / c));
+            }
+            float M = _mm512_reduce_add_ps(mu0) * (1.0f / 16.0f);
+            const __m512 d = _mm512_sub_ps(mu0, _mm512_set1_ps(M));
+            float Q = _mm512_reduce_add_ps(_mm512_fmadd_ps(_mm512_mul_ps(d, d), _mm512_set1_ps(c), q0));
+            float N = 16.0f * c;
+            for (; i < n; ++i) {
+                N += 1.0f;
+                const float e = x[i] - M;
+                M += e / N;
+                Q += e * (x[i] - M);
+            }
+            *mean = M;
+            *m2 = Q;
+        }
+
+        template <bool W, bool B>
+        void norm_apply_impl(const float* x, float mean, float rstd, const float* w, const float* b, float* out, size_t n) {
+            const __m512 mu = _mm512_set1_ps(mean), rs = _mm512_set1_ps(rstd);
+            auto body = [&](__m512 v, size_t i, __mmask16 mt) {
+                __m512 t = _mm512_mul_ps(_mm512_sub_ps(v, mu), rs);
+                if (W && B) t = _mm512_fmadd_ps(t, _mm512_maskz_loadu_ps(mt, w + i), _mm512_maskz_loadu_ps(mt, b + i));
+                else if (W) t = _mm512_mul_ps(t, _mm512_maskz_loadu_ps(mt, w + i));
+                else if (B) t = _mm512_add_ps(t, _mm512_maskz_loadu_ps(mt, b + i));
+                return t;
+            };
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                _mm512_storeu_ps(out + i, body(_mm512_loadu_ps(x + i), i, 0xffff));
+            }
+            if (i < n) {
+                const __mmask16 mt = tail_mask(n - i);
+                _mm512_mask_storeu_ps(out + i, mt, body(_mm512_maskz_loadu_ps(mt, x + i), i, mt));
+            }
+        }
+
+        void norm_apply(const float* x, float mean, float rstd, const float* w, const float* b, float* out, size_t n) {
+            if (w && b) norm_apply_impl<true, true>(x, mean, rstd, w, b, out, n);
+            else if (w) norm_apply_impl<true, false>(x, mean, rstd, w, b, out, n);
+            else if (b) norm_apply_impl<false, true>(x, mean, rstd, w, b, out, n);
+            else norm_apply_impl<false, false>(x, mean, rstd, w, b, out, n);
+        }
+
+        void relu(const float* x, float* out, size_t n) {
+            const __m512 zero = _mm512_setzero_ps();
+            size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                __m512 r0 = _mm512_max_ps(_mm512_loadu_ps(x + i), zero);
+                __m512 r1 = _mm512_max_ps(_mm512_loadu_ps(x + i + 16), zero);
+                __m512 r2 = _mm512_max_ps(_mm512_loadu_ps(x + i + 32), zero);
+                __m512 r3 = _mm512_max_ps(_mm512_loadu_ps(x + i + 48), zero);
+                _mm512_storeu_ps(out + i, r0);
+                _mm512_storeu_ps(out + i + 16, r1);
+                _mm512_storeu_ps(out + i + 32, r2);
+                _mm512_storeu_ps(out + i + 48, r3);
+            }
+            for (; i + 16 <= n; i += 16) {
+                _mm512_storeu_ps(out + i, _mm512_max_ps(_mm512_loadu_ps(x + i), zero));
+            }
+            if (i < n) {
+                __mmask16 m = tail_mask(n - i);
+                _mm512_mask_storeu_ps(out + i, m, _mm512_max_ps(_mm512_maskz_loadu_ps(m, x + i), zero));
+            }
+        }
+
+        // masked head up to a 64-byte boundary, then aligned stores
+        // (Storage blocks are 64-byte aligned, so usually there is no head)
+        void fill(float* out, float v, size_t n) {
+            const __m512 x = _mm512_set1_ps(v);
+            size_t i = 0;
+            size_t mis = (reinterpret_cast<uintptr_t>(out) & 63) / sizeof(float);
+            if (mis != 0) {
+                size_t head = 16 - mis < n ? 16 - mis : n;
+                _mm512_mask_storeu_ps(out, tail_mask(head), x);
+                i = head;
+            }
+            for (; i + 64 <= n; i += 64) {
+                _mm512_store_ps(out + i, x);
+                _mm512_store_ps(out + i + 16, x);
+                _mm512_store_ps(out + i + 32, x);
+                _mm512_store_ps(out + i + 48, x);
+            }
+            for (; i + 16 <= n; i += 16) _mm512_store_ps(out + i, x);
+            if (i < n) _mm512_mask_storeu_ps(out + i, tail_mask(n - i), x);
+        }
+
+        // same rounding as the AVX2 version; the 16-bit tails would need
+        // AVX-512BW masked loads/stores, so they use the scalar conversion
+        inline __m256i cvt_bf16(__m512 v) {
+            const __m512i x = _mm512_castps_si512(v);
+            const __m512i abs = _mm512_and_si512(x, _mm512_set1_epi32(0x7fffffff));
+            const __mmask16 nan = _mm512_cmpgt_epi32_mask(abs, _mm512_set1_epi32(0x7f800000));
+            const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(x, 16), _mm512_set1_epi32(1));
+            const __m512i rounded = _mm512_add_epi32(x, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+            const __m512i quiet = _mm512_or_si512(x, _mm512_set1_epi32(0x400000));
+            const __m512i r = _mm512_srli_epi32(_mm512_mask_blend_epi32(nan, rounded, quiet), 16);
+            return _mm512_cvtepi32_epi16(r);
+        }
+
+        void f32_to_bf16(const float* x, uint16_t* out, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), cvt_bf16(_mm512_loadu_ps(x + i)));
+            }
+            for (; i < n; ++i) out[i] = core::float_to_bf16_bits(x[i]);
+        }
+
+        void bf16_to_f32(const uint16_t* x, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m512i w = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)));
+                _mm512_storeu_ps(out + i, _mm512_castsi512_ps(_mm512_slli_epi32(w, 16)));
+            }
+            for (; i < n; ++i) out[i] = core::bf16_bits_to_float(x[i]);
+        }
+
+        void f32_to_f16(const float* x, uint16_t* out, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(x + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), h);
+            }
+            for (; i < n; ++i) out[i] = core::float_to_half_bits(x[i]);
+        }
+
+        void f16_to_f32(const uint16_t* x, float* out, size_t n) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                _mm512_storeu_ps(out + i, _mm512_cvtph_ps(h));
+            }
+            for (; i < n; ++i) out[i] = core::half_bits_to_float(x[i]);
+        }
+
+    } // namespace
+
+    const KernelTable& avx512_table() {
+        static const KernelTable t{
+            "avx512",
+            { kMR, kNR, gemm_8x32 },
+            avx2_table().qgemm,   // u8 x s8 needs AVX-512BW (or VNNI) at 512 bits
+            avx2_table().pack_t,
+            dot_rows, axpy_rows,
+            add, sub, mul, relu,
+            maximum, minimum,
+            fill,
+            reduce_sum, reduce_max, reduce_min,
+            softmax_stats, exp_scale,
+            row_moments, norm_apply,
+            f32_to_bf16, bf16_to_f32, f32_to_f16, f16_to_f32,
+        };
+        return t;
+    }
+
+} // namespace ml::ops::kernels
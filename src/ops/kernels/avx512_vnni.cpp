@@ -0,0 +1,66 @@
+#include "ops/kernels/kernels.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// AVX-512 VNNI kernels, this file is compiled with -mavx512f -mavx512bw
+// -mavx512vl -mavx512vnni and only reached when core::cpu_level() == AVX512VNNI
+// everything but the int8 GEMM comes from the AVX-512F table
+
+namespace ml::ops::kernels {
+
+    namespace {
+
+        constexpr size_t kQMR = 8;
+        constexpr size_t kQNR = 32;
+
+        // 8x32 int32 tile = 16 zmm accumulators; vpdpbusd multiplies 4 (u8, s8)
+        // pairs per lane and adds them straight into int32, no s16 step, so
+        // any u8 value is exact
+        void qgemm_8x32(size_t kg, const uint8_t* a, const int8_t* b,
+            int32_t* c, size_t ldc, bool accumulate) {
+            __m512i acc[kQMR][2];
+            for (size_t i = 0; i < kQMR; ++i) {
+                acc[i][0] = _mm512_setzero_si512();
+                acc[i][1] = _mm512_setzero_si512();
+            }
+
+            for (size_t g = 0; g < kg; ++g) {
+                __m512i b0 = _mm512_loadu_si512(b);
+                __m512i b1 = _mm512_loadu_si512(b + 64);
+                for (size_t i = 0; i < kQMR; ++i) {
+                    uint32_t w;
+                    std::memcpy(&w, a + i * 4, sizeof(w));
+                    __m512i ai = _mm512_set1_epi32(static_cast<int>(w));
+                    acc[i][0] = _mm512_dpbusd_epi32(acc[i][0], ai, b0);
+                    acc[i][1] = _mm512_dpbusd_epi32(acc[i][1], ai, b1);
+                }
+                a += kQMR * 4;
+                b += kQNR * 4;
+            }
+
+            for (size_t i = 0; i < kQMR; ++i) {
+                int32_t* row = c + i * ldc;
+                if (accumulate) {
+                    acc[i][0] = _mm512_add_epi32(acc[i][0], _mm512_loadu_si512(row));
+                    acc[i][1] = _mm512_add_epi32(acc[i][1], _mm512_loadu_si512(row + 16));
+                }
+                _mm512_storeu_si512(row, acc[i][0]);
+                _mm512_storeu_si512(row + 16, acc[i][1]);
+            }
+        }
+
+    } // namespace
+
+    const KernelTable& avx512_vnni_table() {
+        static const KernelTable t = [] {
+            KernelTable k = avx512_table();
+            k.name = "avx512vnni";
+            k.qgemm = { kQMR, kQNR, qgemm_8x32, qgemm_8x32 };
+            return k;
+        }();
+        return t;
+    }
+
+} // namespace ml::ops::kernels
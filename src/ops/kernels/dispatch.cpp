@@ -0,0 +1,27 @@
+#include "ops/kernels/kernels.hpp"
+#include "ml/core/cpu.hpp"
+
+namespace ml::ops::kernels {
+
+    namespace {
+
+        const KernelTable& select() {
+#if defined(MLCPP_X86_KERNELS)
+            switch (core::cpu_level()) {
+            case core::CpuLevel::AVX512VNNI: return avx512_vnni_table();
+            case core::CpuLevel::AVX512: return avx512_table();
+            case core::CpuLevel::AVX2:   return avx2_table();
+            case core::CpuLevel::Scalar: break;
+            }
+#endif
+            return scalar_table();
+        }
+
+    } // namespace
+
+    const KernelTable& table() {
+        static const KernelTable& t = select();
+        return t;
+    }
+
+} // namespace ml::ops::kernels
@@ -0,0 +1,184 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/ops/activation.hpp"
+
+// internal per-ISA kernel table, picked once from core::cpu_level()
+
+namespace ml::ops::kernels {
+
+    // largest register block of any GEMM micro-kernel (sizes edge scratch tiles)
+    constexpr size_t kMaxMR = 16;
+    constexpr size_t kMaxNR = 32;
+    constexpr size_t kMaxQMR = 16;
+    constexpr size_t kMaxQNR = 32;
+
+    // applied by the micro-kernel to the finished tile before it is stored:
+    // c = act(c + bias[j]) + residual[i * ldr + j]
+    // pointers are relative to the tile (the driver offsets them), either may be null
+    struct GemmEpilogue {
+        const float* bias;
+        const float* residual;
+        size_t ldr;
+        Activation act;
+    };
+
+    // GELU (tanh form) rewritten as x * sigmoid(2u), which is what the SIMD
+    // kernels evaluate: u = sqrt(2/pi) (x + 0.044715 x^3)
+    inline float gelu(float x) {
+        const float u = 0.7978845608f * (x + 0.044715f * x * x * x);
+        return x / (1.0f + std::exp(-2.0f * u));
+    }
+
+    // d gelu / dx for the same form: s + 2 x s (1 - s) u', s = sigmoid(2u)
+    inline float gelu_grad(float x) {
+        const float u = 0.7978845608f * (x + 0.044715f * x * x * x);
+        const float du = 0.7978845608f * (1.0f + 3.0f * 0.044715f * x * x);
+        const float s = 1.0f / (1.0f + std::exp(-2.0f * u));
+        return s + 2.0f * x * s * (1.0f - s) * du;
+    }
+
+    inline float apply_epilogue(float v, const GemmEpilogue& ep, size_t i, size_t j) {
+        if (ep.bias) v += ep.bias[j];
+        if (ep.act == Activation::ReLU) v = v > 0.0f ? v : 0.0f;
+        else if (ep.act == Activation::GELU) v = gelu(v);
+        if (ep.residual) v += ep.residual[i * ep.ldr + j];
+        return v;
+    }
+
+    // c[mr x nr] (= or +=) a_panel * b_panel, then the epilogue if ep != null
+    // a_panel: kc columns of mr values, b_panel: kc rows of nr values
+    using GemmFn = void (*)(size_t kc, const float* a, const float* b,
+        float* c, size_t ldc, bool accumulate, const GemmEpilogue* ep);
+
+    struct GemmKernel {
+        size_t mr;
+        size_t nr;
+        GemmFn fn;
+    };
+
+    // int8 GEMM: c[mr x nr] (= or +=) a_panel * b_panel in int32
+    // k is packed in groups of 4 (zero padded): per group, a_panel holds mr
+    // words of 4 u8 (one per row) and b_panel nr words of 4 s8 (one per
+    // column), so one 32-bit lane multiplies 4 (u8, s8) pairs at once
+    using QGemmFn = void (*)(size_t kg, const uint8_t* a, const int8_t* b,
+        int32_t* c, size_t ldc, bool accumulate);
+
+    struct QGemmKernel {
+        size_t mr;
+        size_t nr;
+        QGemmFn fn;      // exact for a <= 127 (maddubs pairs cannot saturate)
+        QGemmFn fn_u8;   // exact for any u8 a (== fn where the ISA has no limit)
+    };
+
+    // reference int8 micro-kernel for any tile shape, used where there is no SIMD one
+    template <size_t MR, size_t NR>
+    void qgemm_generic(size_t kg, const uint8_t* a, const int8_t* b,
+        int32_t* c, size_t ldc, bool accumulate) {
+        int32_t acc[MR][NR] = {};
+        for (size_t g = 0; g < kg; ++g) {
+            for (size_t i = 0; i < MR; ++i) {
+                for (size_t j = 0; j < NR; ++j) {
+                    int32_t s = 0;
+                    for (size_t t = 0; t < 4; ++t) s += int32_t(a[i * 4 + t]) * int32_t(b[j * 4 + t]);
+                    acc[i][j] += s;
+                }
+            }
+            a += MR * 4;
+            b += NR * 4;
+        }
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < NR; ++j) {
+                c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+            }
+        }
+    }
+
+    // transposing copy: out[p * ldo + i] = src[i * ld + p] for i < rows, p < n
+    // packs GEMM panels from operands that are contiguous along k (row-major
+    // A, column-major B such as w.transpose(0, 1)) without a strided gather
+    using PackTFn = void (*)(const float* src, size_t ld, size_t rows, size_t n,
+        float* out, size_t ldo);
+
+    // matrix-vector building blocks for skinny products (ops::detail::gemm_skinny)
+    // dot_rows: out[r * ldo] = sum_p w[r * ldw + p] * x[p], r < rows, p < n
+    //   (weight lines contiguous along k, several rows share each x load)
+    // axpy_rows: y[j] (= or +=) sum_p x[p] * w[p * ldw + j], p < k, j < n
+    //   (weight rows contiguous along the output, y stays in L1)
+    using DotRowsFn = void (*)(const float* w, size_t ldw, size_t rows,
+        const float* x, size_t n, float* out, size_t ldo);
+    using AxpyRowsFn = void (*)(const float* w, size_t ldw, size_t k,
+        const float* x, float* y, size_t n, bool accumulate);
+
+    // contiguous 1D loops: out[i] = a[i] op b[i]
+    using BinaryFn = void (*)(const float* a, const float* b, float* out, size_t n);
+    using UnaryFn = void (*)(const float* x, float* out, size_t n);
+    using FillFn = void (*)(float* out, float v, size_t n);
+
+    // horizontal reduction of a contiguous row, several accumulators wide
+    // (the summation order is fixed per table, not per call); max/min need
+    // n >= 1 and return NaN if the row has one
+    using ReduceFn = float (*)(const float* x, size_t n);
+
+    // softmax building blocks over a contiguous row
+    // softmax_stats: *max = max(x) and *sum = sum e^(x[i] - *max); the SIMD
+    //   kernels read x once (per-lane running max, the sums rescaled when it
+    //   grows); *max is at least -FLT_MAX, so -inf entries add exactly 0
+    // exp_scale: out[i] = e^(x[i] - shift) * scale
+    using SoftmaxStatsFn = void (*)(const float* x, size_t n, float* max, float* sum);
+    using ExpScaleFn = void (*)(const float* x, float shift, float scale, float* out, size_t n);
+
+    // normalization building blocks over a contiguous row
+    // row_moments: *mean = mean(x) and *m2 = sum (x[i] - *mean)^2 in one read
+    //   of x (Welford per lane, lanes merged pairwise), n >= 1
+    // norm_apply: out[i] = (x[i] - mean) * rstd * w[i] + b[i]; w and b may be
+    //   null (no scale, no shift)
+    using RowMomentsFn = void (*)(const float* x, size_t n, float* mean, float* m2);
+    using NormApplyFn = void (*)(const float* x, float mean, float rstd,
+        const float* w, const float* b, float* out, size_t n);
+
+    // float32 <-> 16-bit float bit patterns (bf16 or IEEE half), round to
+    // nearest even; must match the scalar core:: conversions bit for bit
+    using ToHalfFn = void (*)(const float* x, uint16_t* out, size_t n);
+    using FromHalfFn = void (*)(const uint16_t* x, float* out, size_t n);
+
+    struct KernelTable {
+        const char* name;
+        GemmKernel gemm;
+        QGemmKernel qgemm;
+        PackTFn pack_t;
+        DotRowsFn dot_rows;
+        AxpyRowsFn axpy_rows;
+        BinaryFn add;
+        BinaryFn sub;
+        BinaryFn mul;
+        UnaryFn relu;
+        BinaryFn maximum;   // NaN in either operand gives NaN
+        BinaryFn minimum;
+        FillFn fill;
+        ReduceFn reduce_sum;
+        ReduceFn reduce_max;
+        ReduceFn reduce_min;
+        SoftmaxStatsFn softmax_stats;
+        ExpScaleFn exp_scale;
+        RowMomentsFn row_moments;
+        NormApplyFn norm_apply;
+        ToHalfFn f32_to_bf16;
+        FromHalfFn bf16_to_f32;
+        ToHalfFn f32_to_f16;
+        FromHalfFn f16_to_f32;
+    };
+
+    const KernelTable& scalar_table();
+#if defined(MLCPP_X86_KERNELS)
+    const KernelTable& avx2_table();
+    const KernelTable& avx512_table();
+    const KernelTable& avx512_vnni_table();
+#endif
+
+    // table for core::cpu_level()
+    const KernelTable& table();
+
+} // namespace ml::ops::kernels
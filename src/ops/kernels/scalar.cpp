@@ -0,0 +1,210 @@
+#include "ops/kernels/kernels.hpp"
+#include "ml/core/dtype.hpp"
+
+#include <limits>
+
+// portable fallback kernels, plain loops the compiler may auto-vectorize
+
+namespace ml::ops::kernels {
+
+    namespace {
+
+        constexpr size_t kMR = 4;
+        constexpr size_t kNR = 8;
+
+        // accumulators stay in a local block so the compiler keeps them in registers
+        void gemm_4x8(size_t kc, const float* a, const float* b,
+            float* c, size_t ldc, bool accumulate, const GemmEpilogue* ep) {
+            float acc[kMR][kNR] = {};
+
+            for (size_t p = 0; p < kc; ++p) {
+                for (size_t i = 0; i < kMR; ++i) {
+                    float ai = a[i];
+                    for (size_t j = 0; j < kNR; ++j) {
+                        acc[i][j] += ai * b[j];
+                    }
+                }
+                a += kMR;
+                b += kNR;
+            }
+
+            for (size_t i = 0; i < kMR; ++i) {
+                float* row = c + i * ldc;
+                if (accumulate) {
+                    for (size_t j = 0; j < kNR; ++j) acc[i][j] += row[j];
+                }
+                if (ep) {
+                    for (size_t j = 0; j < kNR; ++j) acc[i][j] = apply_epilogue(acc[i][j], *ep, i, j);
+                }
+                for (size_t j = 0; j < kNR; ++j) row[j] = acc[i][j];
+            }
+        }
+
+        // blocks of 8 values along p keep the written lines of out in cache
+        void pack_t(const float* src, size_t ld, size_t rows, size_t n, float* out, size_t ldo) {
+            for (size_t p0 = 0; p0 < n; p0 += 8) {
+                size_t p1 = p0 + 8 < n ? p0 + 8 : n;
+                for (size_t i = 0; i < rows; ++i) {
+                    for (size_t p = p0; p < p1; ++p) out[p * ldo + i] = src[i * ld + p];
+                }
+            }
+        }
+
+        // four partial sums per row so the compiler can vectorize the reduction
+        void dot_rows(const float* w, size_t ldw, size_t rows, const float* x, size_t n, float* out, size_t ldo) {
+            for (size_t r = 0; r < rows; ++r) {
+                const float* wr = w + r * ldw;
+                float s[4] = {};
+                size_t p = 0;
+                for (; p + 4 <= n; p += 4) {
+                    for (size_t t = 0; t < 4; ++t) s[t] += wr[p + t] * x[p + t];
+                }
+                for (; p < n; ++p) s[0] += wr[p] * x[p];
+                out[r * ldo] = (s[0] + s[1]) + (s[2] + s[3]);
+            }
+        }
+
+        void axpy_rows(const float* w, size_t ldw, size_t k, const float* x, float* y, size_t n, bool accumulate) {
+            if (!accumulate) {
+                for (size_t j = 0; j < n; ++j) y[j] = 0.0f;
+            }
+            for (size_t p = 0; p < k; ++p) {
+                const float xp = x[p];
+                const float* wp = w + p * ldw;
+                for (size_t j = 0; j < n; ++j) y[j] += xp * wp[j];
+            }
+        }
+
+        void add(const float* a, const float* b, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+        }
+
+        void sub(const float* a, const float* b, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+        }
+
+        void mul(const float* a, const float* b, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+        }
+
+        void relu(const float* x, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                float v = x[i];
+                out[i] = (v > 0.0f) ? v : 0.0f;
+            }
+        }
+
+        void maximum(const float* a, const float* b, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = (a[i] > b[i] || a[i] != a[i]) ? a[i] : b[i];
+        }
+
+        void minimum(const float* a, const float* b, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = (a[i] < b[i] || a[i] != a[i]) ? a[i] : b[i];
+        }
+
+        void fill(float* out, float v, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = v;
+        }
+
+        // four partial sums, same shape as dot_rows
+        float reduce_sum(const float* x, size_t n) {
+            float s[4] = {};
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                for (size_t t = 0; t < 4; ++t) s[t] += x[i + t];
+            }
+            for (; i < n; ++i) s[0] += x[i];
+            return (s[0] + s[1]) + (s[2] + s[3]);
+        }
+
+        // NaNs are only counted in the loop; the comparisons stay branch-free
+        float reduce_max(const float* x, size_t n) {
+            float m = x[0];
+            bool nan = false;
+            for (size_t i = 0; i < n; ++i) {
+                m = x[i] > m ? x[i] : m;
+                nan |= x[i] != x[i];
+            }
+            return nan ? std::numeric_limits<float>::quiet_NaN() : m;
+        }
+
+        float reduce_min(const float* x, size_t n) {
+            float m = x[0];
+            bool nan = false;
+            for (size_t i = 0; i < n; ++i) {
+                m = x[i] < m ? x[i] : m;
+                nan |= x[i] != x[i];
+            }
+            return nan ? std::numeric_limits<float>::quiet_NaN() : m;
+        }
+
+        // two passes: max, then the sum
+        void softmax_stats(const float* x, size_t n, float* max, float* sum) {
+            float m = -std::numeric_limits<float>::max();
+            for (size_t i = 0; i < n; ++i) m = x[i] > m ? x[i] : m;
+            float s = 0.0f;
+            for (size_t i = 0; i < n; ++i) s += std::exp(x[i] - m);
+            *max = m;
+            *sum = s;
+        }
+
+        void exp_scale(const float* x, float shift, float scale, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = std::exp(x[i] - shift) * scale;
+        }
+
+        // textbook Welford, one division per element
+        void row_moments(const float* x, size_t n, float* mean, float* m2) {
+            float mu = 0.0f, q = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                const float d = x[i] - mu;
+                mu += d / float(i + 1);
+                q += d * (x[i] - mu);
+            }
+            *mean = mu;
+            *m2 = q;
+        }
+
+        void norm_apply(const float* x, float mean, float rstd, const float* w, const float* b, float* out, size_t n) {
+            if (w && b) for (size_t i = 0; i < n; ++i) out[i] = (x[i] - mean) * rstd * w[i] + b[i];
+            else if (w) for (size_t i = 0; i < n; ++i) out[i] = (x[i] - mean) * rstd * w[i];
+            else if (b) for (size_t i = 0; i < n; ++i) out[i] = (x[i] - mean) * rstd + b[i];
+            else for (size_t i = 0; i < n; ++i) out[i] = (x[i] - mean) * rstd;
+        }
+
+        void f32_to_bf16(const float* x, uint16_t* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = core::float_to_bf16_bits(x[i]);
+        }
+
+        void bf16_to_f32(const uint16_t* x, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = core::bf16_bits_to_float(x[i]);
+        }
+
+        void f32_to_f16(const float* x, uint16_t* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = core::float_to_half_bits(x[i]);
+        }
+
+        void f16_to_f32(const uint16_t* x, float* out, size_t n) {
+            for (size_t i = 0; i < n; ++i) out[i] = core::half_bits_to_float(x[i]);
+        }
+
+    } // namespace
+
+    const KernelTable& scalar_table() {
+        static const KernelTable t{
+            "scalar",
+            { kMR, kNR, gemm_4x8 },
+            { 4, 8, qgemm_generic<4, 8>, qgemm_generic<4, 8> },
+            pack_t,
+            dot_rows, axpy_rows,
+            add, sub, mul, relu,
+            maximum, minimum,
+            fill,
+            reduce_sum, reduce_max, reduce_min,
+            softmax_stats, exp_scale,
+            row_moments, norm_apply,
+            f32_to_bf16, bf16_to_f32, f32_to_f16, f16_to_f32,
+        };
+        return t;
+    }
+
+} // namespace ml::ops::kernels
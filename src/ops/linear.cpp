@@ -0,0 +1,141 @@
+#include "ml/ops/linear.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/ops/reduce.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/gemm.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ml::ops{
+
+	namespace {
+
+		// a tensor read as a 2D [rows, cols] matrix through (row, col) strides
+		// 2D views are used in place, higher ranks are flattened through a
+		// contiguous copy (kept alive in `holder`) when needed
+		struct Matrix {
+			const float* data;
+			size_t rs;
+			size_t cs;
+		};
+
+		Matrix as_matrix(const Tensor& t, size_t cols, std::optional<Tensor>& holder) {
+			if (t.ndim() == 2) return { t.data(), t.strides()[0], t.strides()[1] };
+			holder.emplace(t.detach().contiguous());
+			return { holder->data(), cols, 1 };
+		}
+
+		// y = act(z) + residual, z = x w + bias; with dz = dy * act'(z):
+		//   dx = dz w^T, dw = x^T dz, dbias = column sums of dz, dresidual = dy
+		// act' comes from y for a plain ReLU (z > 0 exactly where y > 0);
+		// GELU, and ReLU with a residual (y - residual can cancel to 0 for a
+		// small z > 0), recompute z with one more GEMM instead
+		// saved: x, w, and y (ReLU without residual) or bias (z recomputed)
+		struct LinearBackward : GradFn {
+			Activation act;
+			bool from_y;
+
+			LinearBackward(Tensor x, Tensor w, Activation act_, std::optional<Tensor> aux, bool from_y_)
+				: act(act_), from_y(from_y_) {
+				saved.push_back(std::move(x));
+				saved.push_back(std::move(w));
+				if (aux) saved.push_back(std::move(*aux));
+			}
+
+			void backward(const Tensor& g) override {
+				const Tensor& x = saved[0];
+				const Tensor& w = saved[1];
+				const size_t K = w.sizes()[0], N = w.sizes()[1];
+				const size_t M = g.numel() / N;
+
+				Tensor dz = g.contiguous().reshape({ M, N });
+				if (act != Activation::None) {
+					// act'(z) from y (plain ReLU) or z itself
+					Tensor ref = from_y ? saved[2].detach() : linear(x, w, saved[2], Activation::None);
+					Tensor scaled = Tensor::empty({ M, N });
+					const float* pg = dz.data();
+					const float* pr = ref.contiguous().data();
+					float* ps = scaled.data();
+					const bool relu = act == Activation::ReLU;
+					parallel_for(0, M * N, kDefaultGrain, [&](size_t e0, size_t e1) {
+						for (size_t e = e0; e < e1; ++e) {
+							ps[e] = relu ? (pr[e] > 0.0f ? pg[e] : 0.0f) : pg[e] * kernels::gelu_grad(pr[e]);
+						}
+						});
+					dz = std::move(scaled);
+				}
+
+				if (inputs[0]) {
+					Tensor dx = matmul(dz, w.transpose(0, 1));
+					accumulate(0, x.ndim() == 2 ? std::move(dx) : dx.reshape(x.sizes()));
+				}
+				if (inputs[1]) {
+					Tensor x2 = x.ndim() == 2 ? x.detach() : x.contiguous().reshape({ M, K });
+					accumulate(1, matmul(x2.transpose(0, 1), dz));
+				}
+				if (inputs[2]) accumulate(2, sum(dz, 0));
+				if (inputs.size() > 3 && inputs[3]) accumulate(3, g.detach());
+			}
+		};
+
+		Tensor linear_impl(const Tensor& x, const Tensor& w, const Tensor& bias,
+			Activation act, const Tensor* residual) {
+			ML_CHECK(x.ndim() >= 1 && w.ndim() == 2, "linear: x must be [..., K] and w [K, N]");
+			ML_CHECK(x.dtype() == DType::Float32 && w.dtype() == DType::Float32 && bias.dtype() == DType::Float32,
+				"linear: float32 only");
+			const size_t K = w.sizes()[0];
+			const size_t N = w.sizes()[1];
+			ML_CHECK(x.sizes()[x.ndim() - 1] == K, "linear: shape mismatch");
+			ML_CHECK(bias.ndim() == 1 && bias.sizes()[0] == N, "linear: bias must be [N]");
+
+			Shape out_sizes = x.sizes();
+			out_sizes.back() = N;
+			const size_t M = x.numel() / K;
+
+			std::optional<Tensor> x_holder, b_holder, r_holder;
+			Matrix xm = as_matrix(x, K, x_holder);
+			const float* pb = bias.strides()[0] == 1 ? bias.data() : b_holder.emplace(bias.detach().contiguous()).data();
+
+			kernels::GemmEpilogue ep{ pb, nullptr, 0, act };
+			if (residual) {
+				ML_CHECK(residual->dtype() == DType::Float32, "linear: float32 only");
+				ML_CHECK(residual->sizes() == out_sizes, "linear: residual must have the output shape");
+				// the kernels read residual rows as unit-stride vectors
+				Matrix rm = as_matrix(*residual, N, r_holder);
+				if (rm.cs != 1) rm = { r_holder.emplace(residual->contiguous()).data(), N, 1 };
+				ep.residual = rm.data;
+				ep.ldr = rm.rs;
+			}
+
+			Tensor out = Tensor::empty(out_sizes);
+			detail::gemm<float>(M, N, K,
+				xm.data, xm.rs, xm.cs,
+				w.data(), w.strides()[0], w.strides()[1],
+				out.data(), N, &ep);
+
+			if (autograd::needs_grad({ &x, &w, &bias, residual })) {
+				const bool from_y = act == Activation::ReLU && !residual;
+				std::optional<Tensor> aux;
+				if (from_y) aux.emplace(out.detach());
+				else if (act != Activation::None) aux.emplace(bias.detach());
+				auto node = std::make_shared<LinearBackward>(x.detach(), w.detach(), act, std::move(aux), from_y);
+				autograd::record(out, std::move(node), { &x, &w, &bias, residual });
+			}
+			return out;
+		}
+
+	} // namespace
+
+	Tensor linear(const Tensor& x, const Tensor& w, const Tensor& bias, Activation act) {
+		return linear_impl(x, w, bias, act, nullptr);
+	}
+
+	Tensor linear(const Tensor& x, const Tensor& w, const Tensor& bias, Activation act, const Tensor& residual) {
+		return linear_impl(x, w, bias, act, &residual);
+	}
+
+}
@@ -0,0 +1,100 @@
+#include "ml/ops/loss.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ml::ops{
+
+	namespace {
+
+		// dlogits[r] = g / B * (e^(logits[r] - lse[r]) - onehot(targets[r]))
+		// saved: logits ([B, V], unit stride along V), targets ([B] int32), lse ([B])
+		struct CrossEntropyBackward : GradFn {
+			CrossEntropyBackward(Tensor logits, Tensor targets, Tensor lse) {
+				saved.push_back(std::move(logits));
+				saved.push_back(std::move(targets));
+				saved.push_back(std::move(lse));
+			}
+
+			void backward(const Tensor& grad_out) override {
+				const Tensor& logits = saved[0];
+				const Tensor& targets = saved[1];
+				const float* lse = saved[2].data();
+				const size_t B = logits.sizes()[0], V = logits.sizes()[1];
+				const size_t ld = logits.strides()[0];
+				const float scale = grad_out.contiguous().data()[0] / float(B);
+				Tensor gx = Tensor::empty({ B, V });
+				const float* px = logits.data();
+				const int32_t* pt = targets.data_as<int32_t>();
+				const size_t ts = targets.strides()[0];
+				float* pg = gx.data();
+				const auto& k = kernels::table();
+				parallel_for(0, B, std::max<size_t>(1, kDefaultGrain / V), [&](size_t r0, size_t r1) {
+					for (size_t r = r0; r < r1; ++r) {
+						k.exp_scale(px + r * ld, lse[r], scale, pg + r * V, V);
+						pg[r * V + size_t(pt[r * ts])] -= scale;
+					}
+					});
+				accumulate(0, std::move(gx));
+			}
+		};
+
+	} // namespace
+
+	Tensor cross_entropy(const Tensor& logits, const Tensor& targets) {
+		ML_CHECK(logits.dtype() == DType::Float32, "cross_entropy: logits must be float32");
+		ML_CHECK(targets.dtype() == DType::Int32, "cross_entropy: targets must be int32");
+		ML_CHECK(logits.ndim() == 2 && targets.ndim() == 1 && targets.sizes()[0] == logits.sizes()[0],
+			"cross_entropy: logits must be [B, V] and targets [B]");
+		const size_t B = logits.sizes()[0], V = logits.sizes()[1];
+
+		// rows are read as unit-stride vectors; other layouts are copied once
+		Tensor x = logits.strides()[1] == 1 ? logits.detach() : logits.detach().contiguous();
+		const size_t ld = x.strides()[0];
+		const float* px = x.data();
+		const int32_t* pt = targets.data_as<int32_t>();
+		const size_t ts = targets.strides()[0];
+
+		// targets are checked by the row loop itself (no separate pass); a
+		// bad row is skipped and reported once the loop is done
+		std::atomic<bool> bad_target{ false };
+		Tensor lse_t = Tensor::empty({ B });
+		float* lse = lse_t.data();
+		std::vector<float> row_loss(B);
+		const auto& k = kernels::table();
+		parallel_for(0, B, std::max<size_t>(1, kDefaultGrain / V), [&](size_t r0, size_t r1) {
+			for (size_t r = r0; r < r1; ++r) {
+				const int32_t t = pt[r * ts];
+				if (t < 0 || size_t(t) >= V) {
+					bad_target.store(true, std::memory_order_relaxed);
+					continue;
+				}
+				float m, s;
+				k.softmax_stats(px + r * ld, V, &m, &s);
+				lse[r] = m + std::log(s);
+				row_loss[r] = lse[r] - px[r * ld + size_t(t)];
+			}
+			});
+		ML_CHECK(!bad_target.load(), "cross_entropy: target out of range");
+		// rows summed in order: the loss does not depend on the thread count
+		double total = 0.0;
+		for (float l : row_loss) total += l;
+
+		Tensor out = Tensor::empty({});
+		out.data()[0] = float(total / double(B));
+		if (autograd::needs_grad({ &logits })) {
+			auto node = std::make_shared<CrossEntropyBackward>(std::move(x), targets.detach(), std::move(lse_t));
+			autograd::record(out, std::move(node), { &logits });
+		}
+		return out;
+	}
+
+}
@@ -1,28 +1,182 @@
 #include "ml/ops/matmul.hpp"
+#include "ml/autograd/graph.hpp"
 #include "ml/core/error.hpp"
+#include "ml/ops/convert.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/gemm.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace ml::ops {
 
-    Tensor matmul(const Tensor& a, const Tensor& b) {
-        ML_CHECK(a.ndim() == 2, "matmul: a must be 2D");
-        ML_CHECK(b.ndim() == 2, "matmul: b must be 2D");
-        ML_CHECK(a.sizes()[1] == b.sizes()[0], "matmul: shape mismatch");
+    namespace {
 
-        size_t M = a.sizes()[0];
-        size_t K = a.sizes()[1];
-        size_t N = b.sizes()[1];
+        // one [M,K] x [K,N] product: a and b through (row, col) strides,
+        // c row-major with leading dimension N
+        struct MatDims {
+            size_t M, N, K;
+            size_t rsa, csa;
+            size_t rsb, csb;
+        };
+
+        // float64 (validation runs): row-parallel i-p-j loop, accumulates in double
+        void matmul_f64(const MatDims& d, const double* pa, const double* pb, double* pc) {
+            size_t grain = std::max<size_t>(1, kDefaultGrain / std::max<size_t>(1, d.N * d.K));
+            parallel_for(0, d.M, grain, [&](size_t i0, size_t i1) {
+                for (size_t i = i0; i < i1; ++i) {
+                    double* row = pc + i * d.N;
+                    std::fill(row, row + d.N, 0.0);
+                    for (size_t p = 0; p < d.K; ++p) {
+                        const double av = pa[i * d.rsa + p * d.csa];
+                        const double* brow = pb + p * d.rsb;
+                        for (size_t j = 0; j < d.N; ++j) row[j] += av * brow[j * d.csb];
+                    }
+                }
+                });
+        }
 
-        Tensor out = Tensor::zeros({ M, N });
+        // mm(a_i, b_i, c_i) for every batch index i of a and b, which are
+        // already expanded to the same batch dims (stride 0 where broadcast);
+        // c_i = c + i * M * N
+        // small products run whole matrices per task across the batch; large
+        // ones go one after another and each splits itself over the pool
+        // (either way every output element has one owner, so the result does
+        // not depend on the thread count)
+        template <class T, class Out, class MM>
+        void for_each_batch(const Tensor& a, const Tensor& b, const MatDims& d, Out* c, MM mm) {
+            const size_t nd = a.ndim() - 2;
+            size_t batches = 1;
+            for (size_t i = 0; i < nd; ++i) batches *= a.sizes()[i];
 
-        for (size_t i = 0; i < M; ++i) {
-            for (size_t k = 0; k < K; ++k) {
-                float aik = a.at({ i, k });
-                for (size_t j = 0; j < N; ++j) {
-                    out.at({ i, j }) += aik * b.at({ k, j });
+            // element offsets of each batch matrix, walking the batch index
+            std::vector<size_t> off_a(batches), off_b(batches);
+            core::Shape idx(nd, 0);
+            size_t oa = 0, ob = 0;
+            for (size_t t = 0; t < batches; ++t) {
+                off_a[t] = oa;
+                off_b[t] = ob;
+                for (size_t i = nd; i-- > 0;) {
+                    oa += a.strides()[i];
+                    ob += b.strides()[i];
+                    if (++idx[i] < a.sizes()[i]) break;
+                    oa -= idx[i] * a.strides()[i];
+                    ob -= idx[i] * b.strides()[i];
+                    idx[i] = 0;
                 }
             }
+
+            const T* pa = a.data_as<T>();
+            const T* pb = b.data_as<T>();
+            const size_t mnk = std::max<size_t>(1, d.M * d.N * d.K);
+            auto run = [&](size_t t0, size_t t1) {
+                for (size_t t = t0; t < t1; ++t) mm(pa + off_a[t], pb + off_b[t], c + t * d.M * d.N);
+            };
+            if (batches > 1 && mnk < detail::kGemmParallelThreshold) {
+                parallel_for(0, batches, std::max<size_t>(1, detail::kGemmParallelThreshold / mnk), run);
+            }
+            else {
+                run(0, batches);
+            }
         }
-        return out;
+
+        template <class T>
+        void gemm_batches(const Tensor& a, const Tensor& b, const MatDims& d, float* c) {
+            for_each_batch<T>(a, b, d, c, [&](const T* pa, const T* pb, float* pc) {
+                detail::gemm<T>(d.M, d.N, d.K, pa, d.rsa, d.csa, pb, d.rsb, d.csb, pc, d.N);
+                });
+        }
+
+        // [..., M, N] = [..., M, K] x [..., K, N]:
+        //   da = g x b^T, db = a^T x g, each summed back over the batch dims
+        //   broadcasting added to it; the transposes are views, no copies
+        // saved: a, b
+        struct MatmulBackward : GradFn {
+            MatmulBackward(Tensor a, Tensor b) {
+                saved.push_back(std::move(a));
+                saved.push_back(std::move(b));
+            }
+
+            static Tensor mT(const Tensor& t) { return t.transpose(t.ndim() - 2, t.ndim() - 1); }
+
+            void backward(const Tensor& g) override {
+                const Tensor& a = saved[0];
+                const Tensor& b = saved[1];
+                if (inputs[0]) accumulate(0, autograd::sum_to(matmul(g, mT(b)), a.sizes()));
+                if (inputs[1]) accumulate(1, autograd::sum_to(matmul(mT(a), g), b.sizes()));
+            }
+        };
+
+    } // namespace
+
+    Tensor matmul(const Tensor& a, const Tensor& b) {
+        ML_CHECK(a.ndim() >= 2, "matmul: a must be at least 2D");
+        ML_CHECK(b.ndim() >= 2, "matmul: b must be at least 2D");
+        ML_CHECK(a.dtype() == b.dtype(), "matmul: dtype mismatch");
+
+        const size_t M = a.sizes()[a.ndim() - 2];
+        const size_t K = a.sizes()[a.ndim() - 1];
+        const size_t N = b.sizes()[b.ndim() - 1];
+        ML_CHECK(K == b.sizes()[b.ndim() - 2], "matmul: shape mismatch");
+
+        // batch dims broadcast; a and b become views with equal batch dims
+        core::Shape a_batch(a.sizes().begin(), a.sizes().end() - 2);
+        core::Shape b_batch(b.sizes().begin(), b.sizes().end() - 2);
+        core::Shape out_sizes = core::broadcast_shapes(a_batch, b_batch);
+        core::Shape a_sizes = out_sizes, b_sizes = out_sizes;
+        a_sizes.push_back(M);
+        a_sizes.push_back(K);
+        b_sizes.push_back(K);
+        b_sizes.push_back(N);
+        out_sizes.push_back(M);
+        out_sizes.push_back(N);
+        // detached: internal views, not graph nodes
+        Tensor ae = a.detach().expand(a_sizes);
+        Tensor be = b.detach().expand(b_sizes);
+
+        const size_t nd = ae.ndim();
+        const MatDims d{ M, N, K,
+            ae.strides()[nd - 2], ae.strides()[nd - 1],
+            be.strides()[nd - 2], be.strides()[nd - 1] };
+
+        switch (a.dtype()) {
+        case DType::Float32: {
+            // gemm overwrites every element, no need to zero
+            // strides go straight to the packing routines, views need no copy
+            Tensor out = Tensor::empty(out_sizes);
+            gemm_batches<float>(ae, be, d, out.data());
+            if (autograd::needs_grad({ &a, &b })) {
+                autograd::record(out, std::make_shared<MatmulBackward>(a.detach(), b.detach()), { &a, &b });
+            }
+            return out;
+        }
+        case DType::BFloat16:
+        case DType::Float16: {
+            // products and sums in float32, one rounding to the input dtype at the end
+            Tensor acc = Tensor::empty(out_sizes);
+            if (a.dtype() == DType::BFloat16) gemm_batches<core::BFloat16>(ae, be, d, acc.data());
+            else gemm_batches<core::Half>(ae, be, d, acc.data());
+            return to_dtype(acc, a.dtype());
+        }
+        case DType::Float64: {
+            Tensor out = Tensor::empty(out_sizes, DType::Float64);
+            for_each_batch<double>(ae, be, d, out.data_as<double>(), [&](const double* pa, const double* pb, double* pc) {
+                matmul_f64(d, pa, pb, pc);
+                });
+            return out;
+        }
+        default:
+            break;
+        }
+        core::fail(std::string("matmul: unsupported dtype ") + core::dtype_name(a.dtype()), __FILE__, __LINE__);
+    }
+
+    Tensor bmm(const Tensor& a, const Tensor& b) {
+        ML_CHECK(a.ndim() == 3 && b.ndim() == 3, "bmm: a and b must be 3D");
+        ML_CHECK(a.sizes()[0] == b.sizes()[0], "bmm: batch size mismatch");
+        return matmul(a, b);
     }
 
 } // namespace ml::ops
@@ -0,0 +1,171 @@
+#include "ml/ops/norm.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ml::ops{
+
+	namespace {
+
+		// fn(r) for every row, rows split over the pool
+		template <class F>
+		void for_rows(size_t rows, size_t n, F&& fn) {
+			parallel_for(0, rows, std::max<size_t>(1, kDefaultGrain / n), [&](size_t r0, size_t r1) {
+				for (size_t r = r0; r < r1; ++r) fn(r);
+				});
+		}
+
+		// [N] parameter as a unit-stride pointer, copied only if strided
+		const float* param_data(const Tensor* p, size_t N, const char* name, std::optional<Tensor>& holder) {
+			if (!p) return nullptr;
+			ML_CHECK(p->dtype() == DType::Float32, std::string(name) + ": float32 only");
+			ML_CHECK(p->ndim() == 1 && p->sizes()[0] == N, std::string(name) + ": weight and bias must be [N]");
+			return p->strides()[0] == 1 ? p->data() : holder.emplace(p->contiguous()).data();
+		}
+
+		// xhat = (x - mean) * rstd, gh = dy * w:
+		//   dx = rstd * (gh - mean(gh) - xhat * mean(gh * xhat))
+		//   (rms_norm: mean is 0 and there is no mean(gh) term)
+		//   dw = sum over rows dy * xhat, db = sum over rows dy
+		// dx reads each row once (xhat and dy * w go to row buffers), then one
+		// column-blocked pass gives dw/db
+		// (each column sums its rows in order, whatever the thread count)
+		// saved: x (contiguous [rows, N]), stats ([rows, 2]: mean, rstd) and
+		// the weight (unit-stride [N]) if there is one
+		struct NormBackward : GradFn {
+			bool rms;
+
+			NormBackward(Tensor x, Tensor stats, const float* weight, std::optional<Tensor> w, bool rms_) : rms(rms_) {
+				saved.push_back(std::move(x));
+				saved.push_back(std::move(stats));
+				if (weight) saved.push_back(std::move(*w));
+			}
+
+			void backward(const Tensor& grad_out) override {
+				const Tensor& x = saved[0];
+				const Tensor& stats = saved[1];
+				Tensor g = grad_out.contiguous();
+				const size_t N = x.sizes().back();
+				const size_t rows = x.numel() / N;
+				const float* px = x.data();
+				const float* pg = g.data();
+				const float* ps = stats.data();
+				const float* pw = saved.size() > 2 ? saved[2].data() : nullptr;
+
+				if (inputs[0]) {
+					Tensor gx = Tensor::empty(x.sizes());
+					float* pgx = gx.data();
+					const auto& k = kernels::table();
+					parallel_for(0, rows, std::max<size_t>(1, kDefaultGrain / N), [&](size_t r0, size_t r1) {
+						// xhat and dy * w of the current row
+						std::vector<float> xh(N), gw(pw ? N : 0);
+						for (size_t r = r0; r < r1; ++r) {
+							const float* gr = pg + r * N;
+							float* dr = pgx + r * N;
+							const float rstd = ps[2 * r + 1];
+							k.norm_apply(px + r * N, ps[2 * r], rstd, nullptr, nullptr, xh.data(), N);
+							const float* gh = gr;
+							if (pw) {
+								k.mul(gr, pw, gw.data(), N);
+								gh = gw.data();
+							}
+							float sgx;
+							k.dot_rows(gh, 0, 1, xh.data(), N, &sgx, 1);
+							const float a = rms ? 0.0f : k.reduce_sum(gh, N) / float(N), b = sgx / float(N);
+							for (size_t j = 0; j < N; ++j) dr[j] = rstd * (gh[j] - a - xh[j] * b);
+						}
+						});
+					accumulate(0, std::move(gx));
+				}
+
+				const bool want_w = inputs.size() > 1 && inputs[1];
+				const bool want_b = inputs.size() > 2 && inputs[2];
+				if (!want_w && !want_b) return;
+				// only the grads asked for (rms_norm has no bias at all)
+				std::optional<Tensor> gw, gb;
+				float* pgw = want_w ? gw.emplace(Tensor::zeros({ N })).data() : nullptr;
+				float* pgb = want_b ? gb.emplace(Tensor::zeros({ N })).data() : nullptr;
+				parallel_for(0, N, std::max<size_t>(16, kDefaultGrain / rows), [&](size_t j0, size_t j1) {
+					for (size_t r = 0; r < rows; ++r) {
+						const float* xr = px + r * N;
+						const float* gr = pg + r * N;
+						const float mean = ps[2 * r], rstd = ps[2 * r + 1];
+						if (pgw) {
+							for (size_t j = j0; j < j1; ++j) pgw[j] += gr[j] * (xr[j] - mean) * rstd;
+						}
+						if (pgb) {
+							for (size_t j = j0; j < j1; ++j) pgb[j] += gr[j];
+						}
+					}
+					});
+				if (gw) accumulate(1, std::move(*gw));
+				if (gb) accumulate(2, std::move(*gb));
+			}
+		};
+
+		Tensor norm_impl(const Tensor& x, const Tensor* weight, const Tensor* bias, float eps, bool rms) {
+			const char* name = rms ? "rms_norm" : "layer_norm";
+			ML_CHECK(x.dtype() == DType::Float32, std::string(name) + ": float32 only");
+			ML_CHECK(x.ndim() >= 1, std::string(name) + ": x must be [..., N]");
+			ML_CHECK(eps >= 0.0f, std::string(name) + ": eps must be >= 0");
+			const size_t N = x.sizes().back();
+			const size_t rows = x.numel() / N;
+
+			std::optional<Tensor> w_holder, b_holder;
+			const float* pw = param_data(weight, N, name, w_holder);
+			const float* pb = param_data(bias, N, name, b_holder);
+
+			Tensor xc = x.detach().contiguous();
+			Tensor out = Tensor::empty(x.sizes());
+			Tensor stats = Tensor::empty({ rows, 2 });
+			const float* px = xc.data();
+			float* po = out.data();
+			float* ps = stats.data();
+			const auto& k = kernels::table();
+			for_rows(rows, N, [&](size_t r) {
+				const float* xr = px + r * N;
+				float mean = 0.0f, m2;
+				if (rms) k.dot_rows(xr, 0, 1, xr, N, &m2, 1);
+				else k.row_moments(xr, N, &mean, &m2);
+				const float rstd = 1.0f / std::sqrt(m2 / float(N) + eps);
+				ps[2 * r] = mean;
+				ps[2 * r + 1] = rstd;
+				k.norm_apply(xr, mean, rstd, pw, pb, po + r * N, N);
+				});
+
+			if (autograd::needs_grad({ &x, weight, bias })) {
+				std::optional<Tensor> w;
+				if (pw) w.emplace(w_holder ? w_holder->detach() : weight->detach());
+				auto node = std::make_shared<NormBackward>(std::move(xc), std::move(stats), pw, std::move(w), rms);
+				autograd::record(out, std::move(node), { &x, weight, bias });
+			}
+			return out;
+		}
+
+	} // namespace
+
+	Tensor layer_norm(const Tensor& x, const Tensor& weight, const Tensor& bias, float eps) {
+		return norm_impl(x, &weight, &bias, eps, false);
+	}
+
+	Tensor layer_norm(const Tensor& x, float eps) {
+		return norm_impl(x, nullptr, nullptr, eps, false);
+	}
+
+	Tensor rms_norm(const Tensor& x, const Tensor& weight, float eps) {
+		return norm_impl(x, &weight, nullptr, eps, true);
+	}
+
+	Tensor rms_norm(const Tensor& x, float eps) {
+		return norm_impl(x, nullptr, nullptr, eps, true);
+	}
+
+}
@@ -0,0 +1,197 @@
+#include "ops/qgemm.hpp"
+#include "ops/gemm.hpp"
+#include "ml/core/allocator.hpp"
+#include "ops/kernels/kernels.hpp"
+#include "ml/runtime/parallel.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace ml::ops::detail {
+
+    namespace {
+
+        size_t round_up(size_t x, size_t m) { return (x + m - 1) / m * m; }
+
+        // A block [mc x kc] -> panels of MR rows, k in groups of 4:
+        // per group, MR words of 4 bytes (row i: k, k+1, k+2, k+3)
+        // rows past mc and k past kc are zero; returns the OR of all bytes
+        // (bit 7 set -> the block needs the full-range kernel)
+        uint8_t pack_a(size_t mc, size_t kc,
+            const uint8_t* a, size_t rsa, size_t csa,
+            size_t MR, uint8_t* out) {
+            const size_t kg = (kc + 3) / 4;
+            uint8_t seen = 0;
+            for (size_t ir = 0; ir < mc; ir += MR) {
+                size_t mr = std::min(MR, mc - ir);
+                for (size_t g = 0; g < kg; ++g) {
+                    size_t kn = std::min<size_t>(4, kc - g * 4);
+                    for (size_t i = 0; i < MR; ++i, out += 4) {
+                        out[0] = out[1] = out[2] = out[3] = 0;
+                        if (i >= mr) continue;
+                        const uint8_t* src = a + (ir + i) * rsa + g * 4 * csa;
+                        for (size_t t = 0; t < kn; ++t) {
+                            out[t] = src[t * csa];
+                            seen |= out[t];
+                        }
+                    }
+                }
+            }
+            return seen;
+        }
+
+        // B block [kc x nc] -> panels of NR columns, k in groups of 4:
+        // per group, NR words of 4 bytes (column j: k, k+1, k+2, k+3)
+        void pack_b(size_t kc, size_t nc,
+            const int8_t* b, size_t rsb, size_t csb,
+            size_t NR, int8_t* out) {
+            const size_t kg = (kc + 3) / 4;
+            for (size_t jr = 0; jr < nc; jr += NR) {
+                size_t nr = std::min(NR, nc - jr);
+                for (size_t g = 0; g < kg; ++g) {
+                    size_t kn = std::min<size_t>(4, kc - g * 4);
+                    for (size_t j = 0; j < NR; ++j, out += 4) {
+                        out[0] = out[1] = out[2] = out[3] = 0;
+                        if (j >= nr) continue;
+                        const int8_t* src = b + g * 4 * rsb + (jr + j) * csb;
+                        for (size_t t = 0; t < kn; ++t) out[t] = src[t * rsb];
+                    }
+                }
+            }
+        }
+
+        void edge_kernel(const kernels::QGemmKernel& k, kernels::QGemmFn fn,
+            size_t m, size_t n, size_t kg,
+            const uint8_t* a, const int8_t* b,
+            int32_t* c, size_t ldc, bool accumulate) {
+            int32_t tile[kernels::kMaxQMR * kernels::kMaxQNR];
+            fn(kg, a, b, tile, k.nr, false);
+
+            for (size_t i = 0; i < m; ++i) {
+                int32_t* row = c + i * ldc;
+                const int32_t* t = tile + i * k.nr;
+                if (accumulate) {
+                    for (size_t j = 0; j < n; ++j) row[j] += t[j];
+                }
+                else {
+                    for (size_t j = 0; j < n; ++j) row[j] = t[j];
+                }
+            }
+        }
+
+        void macro_kernel(const kernels::QGemmKernel& k, kernels::QGemmFn fn,
+            size_t mc, size_t nc, size_t kc,
+            size_t jr_begin, size_t jr_end,
+            const uint8_t* a_packed, const int8_t* b_packed,
+            int32_t* c, size_t ldc, bool accumulate) {
+            const size_t MR = k.mr;
+            const size_t NR = k.nr;
+            const size_t kc4 = round_up(kc, 4);
+            const size_t kg = kc4 / 4;
+
+            for (size_t jr = jr_begin; jr < jr_end; jr += NR) {
+                size_t nr = std::min(NR, nc - jr);
+                const int8_t* bp = b_packed + jr * kc4;
+
+                for (size_t ir = 0; ir < mc; ir += MR) {
+                    size_t mr = std::min(MR, mc - ir);
+                    const uint8_t* ap = a_packed + ir * kc4;
+                    int32_t* cp = c + ir * ldc + jr;
+
+                    if (mr == MR && nr == NR) {
+                        fn(kg, ap, bp, cp, ldc, accumulate);
+                    }
+                    else {
+                        edge_kernel(k, fn, mr, nr, kg, ap, bp, cp, ldc, accumulate);
+                    }
+                }
+            }
+        }
+
+    } // namespace
+
+    void qgemm(size_t M, size_t N, size_t K,
+        const uint8_t* a, size_t rsa, size_t csa,
+        const int8_t* b, size_t rsb, size_t csb,
+        int32_t* c, size_t ldc) {
+        const kernels::QGemmKernel& k = kernels::table().qgemm;
+        const size_t MR = k.mr;
+        const size_t NR = k.nr;
+
+        const size_t MC = std::max(MR, kQGemmMC / MR * MR);
+        const size_t KC = kQGemmKC;
+        const size_t NC = std::max(NR, kQGemmNC / NR * NR);
+
+        // same work threshold as the float GEMM
+        const bool parallel = M * N * K >= kGemmParallelThreshold && !in_parallel_region();
+        const size_t n_threads = parallel ? get_num_threads() : 1;
+
+        thread_local std::vector<int8_t, core::CachingAllocator<int8_t>> b_buf;
+        b_buf.resize(std::max(b_buf.size(), round_up(std::min(N, NC), NR) * round_up(std::min(K, KC), 4)));
+        const size_t a_size = round_up(std::min(M, MC), MR) * round_up(std::min(K, KC), 4);
+
+        const size_t m_blocks = (M + MC - 1) / MC;
+
+        for (size_t jc = 0; jc < N; jc += NC) {
+            size_t nc = std::min(NC, N - jc);
+            size_t n_panels = (nc + NR - 1) / NR;
+
+            size_t n_groups = 1;
+            if (n_threads > 1) {
+                n_groups = std::min(n_panels, (2 * n_threads + m_blocks - 1) / m_blocks);
+                n_groups = std::max<size_t>(n_groups, 1);
+            }
+            size_t group_panels = (n_panels + n_groups - 1) / n_groups;
+            n_groups = (n_panels + group_panels - 1) / group_panels;
+
+            for (size_t pc = 0; pc < K; pc += KC) {
+                size_t kc = std::min(KC, K - pc);
+                size_t kc4 = round_up(kc, 4);
+                bool accumulate = pc != 0;
+                const int8_t* b_block = b + pc * rsb + jc * csb;
+                int8_t* b_packed = b_buf.data();
+
+                if (n_threads > 1) {
+                    size_t chunks = std::min(n_threads, n_panels);
+                    size_t chunk_panels = (n_panels + chunks - 1) / chunks;
+                    parallel_for(0, chunks, 1, [&](size_t t0, size_t t1) {
+                        size_t j0 = t0 * chunk_panels * NR;
+                        size_t j1 = std::min(nc, t1 * chunk_panels * NR);
+                        if (j0 < j1) {
+                            pack_b(kc, j1 - j0, b_block + j0 * csb, rsb, csb, NR, b_packed + j0 * kc4);
+                        }
+                        });
+                }
+                else {
+                    pack_b(kc, nc, b_block, rsb, csb, NR, b_packed);
+                }
+
+                auto tile_task = [&](size_t t) {
+                    size_t ic = (t / n_groups) * MC;
+                    size_t jr0 = (t % n_groups) * group_panels * NR;
+                    size_t jr1 = std::min(nc, jr0 + group_panels * NR);
+                    size_t mc = std::min(MC, M - ic);
+
+                    thread_local std::vector<uint8_t, core::CachingAllocator<uint8_t>> a_buf;
+                    if (a_buf.size() < a_size) a_buf.resize(a_size);
+
+                    uint8_t seen = pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, MR, a_buf.data());
+                    kernels::QGemmFn fn = (seen & 0x80) ? k.fn_u8 : k.fn;
+                    macro_kernel(k, fn, mc, nc, kc, jr0, jr1, a_buf.data(), b_packed,
+                        c + ic * ldc + jc, ldc, accumulate);
+                };
+
+                size_t n_tasks = m_blocks * n_groups;
+                if (n_threads > 1) {
+                    parallel_for(0, n_tasks, 1, [&](size_t t0, size_t t1) {
+                        for (size_t t = t0; t < t1; ++t) tile_task(t);
+                        });
+                }
+                else {
+                    for (size_t t = 0; t < n_tasks; ++t) tile_task(t);
+                }
+            }
+        }
+    }
+
+} // namespace ml::ops::detail
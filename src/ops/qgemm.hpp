@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// internal int8 GEMM engine used by ops::quantized_matmul
+
+namespace ml::ops::detail {
+
+    // cache blocking (elements = bytes); KC is a multiple of the k group (4)
+    // and MC a multiple of every int8 micro-kernel's MR
+    constexpr size_t kQGemmMC = 128;
+    constexpr size_t kQGemmKC = 1024;
+    constexpr size_t kQGemmNC = 4096;
+
+    // int32 sums stay exact while K * 255 * 128 < 2^31
+    constexpr size_t kQGemmMaxK = 65792;
+
+    // C[M,N] = A[M,K] * B[K,N] with u8 A, s8 B and exact int32 C
+    // A and B are read through (row stride, col stride) so any 2D view works
+    // C is row-major with leading dimension ldc and is fully overwritten
+    // A blocks with values above 127 use the kernel's full-range variant
+    // (only slower on pre-VNNI CPUs); parallel split as in gemm()
+    void qgemm(size_t M, size_t N, size_t K,
+        const uint8_t* a, size_t rsa, size_t csa,
+        const int8_t* b, size_t rsb, size_t csb,
+        int32_t* c, size_t ldc);
+
+} // namespace ml::ops::detail
@@ -0,0 +1,211 @@
+#include "ml/ops/quantize.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/qgemm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ml::ops{
+
+	namespace {
+
+		// contiguous element i -> channel: (i / inner) % channels
+		struct ChannelMap {
+			size_t channels{ 1 };
+			size_t inner{ 1 };
+
+			ChannelMap(const Tensor& x, int axis) {
+				if (axis < 0) return;
+				channels = x.sizes()[axis];
+				for (size_t d = static_cast<size_t>(axis) + 1; d < x.ndim(); ++d) inner *= x.sizes()[d];
+			}
+
+			size_t operator()(size_t i) const { return (i / inner) % channels; }
+		};
+
+		void check_qparams(const Tensor& x, const QuantParams& qp) {
+			ML_CHECK(!qp.scale.empty() && qp.scale.size() == qp.zero_point.size(), "quantize: scale/zero_point size mismatch");
+			if (qp.per_channel()) {
+				ML_CHECK_LT(static_cast<size_t>(qp.axis), x.ndim(), "quantize: axis out of range");
+				ML_CHECK_EQ(qp.scale.size(), x.sizes()[qp.axis], "quantize: one scale per channel expected");
+			}
+		}
+
+		template <class Q>
+		void quantize_into(const float* x, Q* q, size_t n, const QuantParams& qp, const ChannelMap& ch) {
+			constexpr float lo = static_cast<float>(std::numeric_limits<Q>::min());
+			constexpr float hi = static_cast<float>(std::numeric_limits<Q>::max());
+			parallel_for(0, n, kDefaultGrain, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					size_t c = ch(i);
+					float v = std::nearbyint(x[i] / qp.scale[c]) + static_cast<float>(qp.zero_point[c]);
+					// NaN would pass the clamp, and its cast is UB: it maps to the zero point
+					q[i] = v == v ? static_cast<Q>(std::min(std::max(v, lo), hi)) : static_cast<Q>(qp.zero_point[c]);
+				}
+				});
+		}
+
+		template <class Q>
+		void dequantize_into(const Q* q, float* x, size_t n, const QuantParams& qp, const ChannelMap& ch) {
+			parallel_for(0, n, kDefaultGrain, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					size_t c = ch(i);
+					x[i] = qp.scale[c] * static_cast<float>(static_cast<int32_t>(q[i]) - qp.zero_point[c]);
+				}
+				});
+		}
+
+		// shapes and dtypes, before the wrappers size their output from them
+		void check_operands(const Tensor& a, const Tensor& b) {
+			ML_CHECK(a.ndim() == 2 && b.ndim() == 2, "quantized_matmul: a and b must be 2D");
+			ML_CHECK(a.sizes()[1] == b.sizes()[0], "quantized_matmul: shape mismatch");
+			ML_CHECK(a.dtype() == DType::UInt8 && a.is_quantized(), "quantized_matmul: a must be quantized uint8");
+			ML_CHECK(b.dtype() == DType::Int8 && b.is_quantized(), "quantized_matmul: b must be quantized int8");
+		}
+
+		// raw int32 product + the zero-point corrections, handed per element to
+		// store(i, j, real_value); a and b passed check_operands
+		//   sum (a - za)(b - zb) = sum ab - zb * rowsum(a) - za * colsum(b) + K za zb
+		template <class Store>
+		void quantized_matmul_impl(const Tensor& a, const Tensor& b, Store store) {
+			const QuantParams& qa = *a.qparams();
+			const QuantParams& qb = *b.qparams();
+			ML_CHECK(!qa.per_channel(), "quantized_matmul: a must be quantized per tensor");
+			ML_CHECK(!qb.per_channel() || qb.axis == 1, "quantized_matmul: b must be per tensor or per column");
+
+			const size_t M = a.sizes()[0];
+			const size_t K = a.sizes()[1];
+			const size_t N = b.sizes()[1];
+			ML_CHECK(K <= detail::kQGemmMaxK, "quantized_matmul: K too large for int32 accumulation");
+
+			Tensor acc = Tensor::empty({ M, N }, DType::Int32);
+			const uint8_t* pa = a.data_as<uint8_t>();
+			const int8_t* pb = b.data_as<int8_t>();
+			const size_t rsa = a.strides()[0], csa = a.strides()[1];
+			const size_t rsb = b.strides()[0], csb = b.strides()[1];
+			detail::qgemm(M, N, K, pa, rsa, csa, pb, rsb, csb, acc.data_as<int32_t>(), N);
+
+			const int64_t za = qa.zero_point[0];
+			bool any_zb = false;
+			for (int32_t z : qb.zero_point) any_zb = any_zb || z != 0;
+
+			// corrections, only when the matching zero point is nonzero
+			std::vector<int64_t> col_sum(za != 0 ? N : 0, 0);
+			for (size_t k = 0; k < K && za != 0; ++k) {
+				for (size_t j = 0; j < N; ++j) col_sum[j] += pb[k * rsb + j * csb];
+			}
+			std::vector<int64_t> row_sum(any_zb ? M : 0, 0);
+			for (size_t i = 0; i < M && any_zb; ++i) {
+				for (size_t k = 0; k < K; ++k) row_sum[i] += pa[i * rsa + k * csa];
+			}
+
+			const int32_t* pc = acc.data_as<int32_t>();
+			const float sa = qa.scale[0];
+			size_t grain = std::max<size_t>(1, kDefaultGrain / N);
+			parallel_for(0, M, grain, [&](size_t i0, size_t i1) {
+				for (size_t i = i0; i < i1; ++i) {
+					for (size_t j = 0; j < N; ++j) {
+						const int64_t zb = qb.zero_point_at(j);
+						int64_t v = pc[i * N + j];
+						if (za != 0) v -= za * col_sum[j];
+						if (zb != 0) v -= zb * row_sum[i] - static_cast<int64_t>(K) * za * zb;
+						store(i, j, sa * qb.scale_at(j) * static_cast<float>(v));
+					}
+				}
+				});
+		}
+
+	} // namespace
+
+	std::shared_ptr<const QuantParams> choose_qparams(const Tensor& x, DType dtype, int axis, bool reduce_range) {
+		ML_CHECK(x.dtype() == DType::Float32, "choose_qparams: float32 input expected");
+		ML_CHECK(dtype == DType::Int8 || dtype == DType::UInt8, "choose_qparams: int8/uint8 only");
+		ML_CHECK(axis < 0 || static_cast<size_t>(axis) < x.ndim(), "choose_qparams: axis out of range");
+
+		Tensor xc = x.detach().contiguous();
+		const float* p = xc.data();
+		ChannelMap ch(xc, axis);
+		std::vector<float> lo(ch.channels, 0.0f), hi(ch.channels, 0.0f);   // 0 always in range
+		for (size_t i = 0, n = xc.numel(); i < n; ++i) {
+			size_t c = ch(i);
+			lo[c] = std::min(lo[c], p[i]);
+			hi[c] = std::max(hi[c], p[i]);
+		}
+
+		auto qp = std::make_shared<QuantParams>();
+		qp->axis = axis < 0 ? -1 : axis;
+		for (size_t c = 0; c < ch.channels; ++c) {
+			float scale;
+			int32_t zp;
+			if (dtype == DType::Int8) {
+				scale = std::max(-lo[c], hi[c]) / 127.0f;
+				zp = 0;
+			}
+			else {
+				const float qmax = reduce_range ? 127.0f : 255.0f;
+				scale = (hi[c] - lo[c]) / qmax;
+				zp = scale > 0.0f ? static_cast<int32_t>(std::min(std::max(std::nearbyint(-lo[c] / scale), 0.0f), qmax)) : 0;
+			}
+			if (!(scale > 0.0f) || !std::isfinite(scale)) scale = 1.0f;   // all-zero channel
+			qp->scale.push_back(scale);
+			qp->zero_point.push_back(zp);
+		}
+		return qp;
+	}
+
+	Tensor quantize(const Tensor& x, DType dtype, std::shared_ptr<const QuantParams> qp) {
+		ML_CHECK(x.dtype() == DType::Float32, "quantize: float32 input expected");
+		ML_CHECK(dtype == DType::Int8 || dtype == DType::UInt8, "quantize: int8/uint8 only");
+		ML_CHECK(qp != nullptr, "quantize: missing params");
+		check_qparams(x, *qp);
+
+		Tensor xc = x.detach().contiguous();
+		Tensor q = Tensor::empty(x.sizes(), dtype);
+		ChannelMap ch(xc, qp->axis);
+		if (dtype == DType::Int8) quantize_into(xc.data(), q.data_as<int8_t>(), xc.numel(), *qp, ch);
+		else quantize_into(xc.data(), q.data_as<uint8_t>(), xc.numel(), *qp, ch);
+		q.set_qparams(std::move(qp));
+		return q;
+	}
+
+	Tensor dequantize(const Tensor& q) {
+		ML_CHECK(q.is_quantized(), "dequantize: tensor has no quantization params");
+		Tensor qc = q.contiguous();
+		Tensor x = Tensor::empty(q.sizes());
+		ChannelMap ch(qc, qc.qparams()->axis);
+		if (q.dtype() == DType::Int8) dequantize_into(qc.data_as<int8_t>(), x.data(), qc.numel(), *qc.qparams(), ch);
+		else dequantize_into(qc.data_as<uint8_t>(), x.data(), qc.numel(), *qc.qparams(), ch);
+		return x;
+	}
+
+	Tensor quantized_matmul(const Tensor& a, const Tensor& b) {
+		check_operands(a, b);
+		Tensor out = Tensor::empty({ a.sizes()[0], b.sizes()[1] });
+		float* po = out.data();
+		const size_t N = b.sizes()[1];
+		quantized_matmul_impl(a, b, [&](size_t i, size_t j, float v) { po[i * N + j] = v; });
+		return out;
+	}
+
+	Tensor quantized_matmul(const Tensor& a, const Tensor& b, std::shared_ptr<const QuantParams> out_qp) {
+		ML_CHECK(out_qp != nullptr && !out_qp->per_channel() && out_qp->scale.size() == 1 && out_qp->zero_point.size() == 1,
+			"quantized_matmul: output params must be per tensor");
+		check_operands(a, b);
+		Tensor out = Tensor::empty({ a.sizes()[0], b.sizes()[1] }, DType::UInt8);
+		uint8_t* po = out.data_as<uint8_t>();
+		const size_t N = b.sizes()[1];
+		const float so = out_qp->scale[0];
+		const float zo = static_cast<float>(out_qp->zero_point[0]);
+		quantized_matmul_impl(a, b, [&](size_t i, size_t j, float v) {
+			float q = std::nearbyint(v / so) + zo;
+			if (q != q) q = zo;   // NaN (e.g. 0 / 0 with a zero scale), as in quantize
+			po[i * N + j] = static_cast<uint8_t>(std::min(std::max(q, 0.0f), 255.0f));
+			});
+		out.set_qparams(std::move(out_qp));
+		return out;
+	}
+
+}
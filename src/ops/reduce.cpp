@@ -0,0 +1,564 @@
+#include "ml/ops/reduce.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace ml::ops{
+
+	namespace {
+
+		// chunking of one output's reduction: kReduceChunk elements when the
+		// reduced dims are walked per output, kColumnChunk reduced rows when
+		// whole rows of outputs are accumulated at once
+		// chunk bounds depend on the shape only and their partial results are
+		// combined in chunk order, so any split over threads gives the same bits
+		constexpr size_t kReduceChunk = kDefaultGrain;
+		constexpr size_t kColumnChunk = 256;
+
+		// outputs per column task: a 2 KB float accumulator row stays in L1
+		// while each x line is long enough for the prefetcher
+		constexpr size_t kColumnBlock = 512;
+
+		// x split into kept dims (one output element each) and reduced dims
+		struct ReducePlan {
+			Shape out_sizes;
+			Shape kept_sizes, kept_strides;
+			Shape red_sizes, red_strides;
+		};
+
+		ReducePlan make_plan(const Tensor& x, const std::vector<size_t>& dims, bool keepdim, const char* name) {
+			std::array<bool, core::kMaxDims> reduced{};
+			for (size_t d : dims) {
+				ML_CHECK_LT(d, x.ndim(), std::string(name) + ": dim out of range");
+				ML_CHECK(!reduced[d], std::string(name) + ": dim listed twice");
+				reduced[d] = true;
+			}
+
+			ReducePlan p;
+			for (size_t d = 0; d < x.ndim(); ++d) {
+				if (reduced[d]) {
+					p.red_sizes.push_back(x.sizes()[d]);
+					p.red_strides.push_back(x.strides()[d]);
+					if (keepdim) p.out_sizes.push_back(1);
+				}
+				else {
+					p.kept_sizes.push_back(x.sizes()[d]);
+					p.kept_strides.push_back(x.strides()[d]);
+					p.out_sizes.push_back(x.sizes()[d]);
+				}
+			}
+			return p;
+		}
+
+		std::vector<size_t> all_dims(const Tensor& x) {
+			std::vector<size_t> dims(x.ndim());
+			std::iota(dims.begin(), dims.end(), size_t(0));
+			return dims;
+		}
+
+		// ---- reduction ops ----
+		// Acc init(): identity
+		// Acc combine(a, b): b holds elements after a's
+		// Acc fold(acc, x, n, s, r): acc with x[j * s], j < n (reduced index r + j)
+		// void fold_cols(acc, x, n, r): acc[j] with x[j], j < n (reduced index r)
+		// Out finish(acc)
+
+		template <class T>
+		struct SumOp {
+			using Acc = core::compute_t<T>;
+			using Out = T;
+			size_t count = 0;   // mean: divide by it
+
+			Acc init() const { return Acc(0); }
+			Acc combine(Acc a, Acc b) const { return a + b; }
+
+			Acc fold(Acc acc, const T* x, size_t n, size_t s, size_t) const {
+				if constexpr (std::is_same_v<T, float>) {
+					if (s == 1) return acc + kernels::table().reduce_sum(x, n);
+				}
+				for (size_t j = 0; j < n; ++j) acc += static_cast<Acc>(x[j * s]);
+				return acc;
+			}
+
+			void fold_cols(Acc* acc, const T* x, size_t n, size_t) const {
+				if constexpr (std::is_same_v<T, float>) {
+					kernels::table().add(acc, x, acc, n);
+				}
+				else {
+					for (size_t j = 0; j < n; ++j) acc[j] += static_cast<Acc>(x[j]);
+				}
+			}
+
+			Out finish(Acc a) const {
+				return static_cast<T>(count ? a / static_cast<Acc>(count) : a);
+			}
+		};
+
+		template <class T>
+		struct ProdOp {
+			using Acc = core::compute_t<T>;
+			using Out = T;
+
+			Acc init() const { return Acc(1); }
+			Acc combine(Acc a, Acc b) const { return a * b; }
+
+			Acc fold(Acc acc, const T* x, size_t n, size_t s, size_t) const {
+				for (size_t j = 0; j < n; ++j) acc *= static_cast<Acc>(x[j * s]);
+				return acc;
+			}
+
+			void fold_cols(Acc* acc, const T* x, size_t n, size_t) const {
+				for (size_t j = 0; j < n; ++j) acc[j] *= static_cast<Acc>(x[j]);
+			}
+
+			Out finish(Acc a) const { return static_cast<T>(a); }
+		};
+
+		// max (Max) or min; a NaN on either side wins
+		template <class T, bool Max>
+		struct ExtremeOp {
+			using Acc = core::compute_t<T>;
+			using Out = T;
+
+			Acc init() const {
+				if constexpr (std::numeric_limits<Acc>::has_infinity) {
+					return Max ? -std::numeric_limits<Acc>::infinity() : std::numeric_limits<Acc>::infinity();
+				}
+				else {
+					return Max ? std::numeric_limits<Acc>::lowest() : std::numeric_limits<Acc>::max();
+				}
+			}
+
+			Acc combine(Acc a, Acc b) const {
+				return ((Max ? a > b : a < b) || a != a) ? a : b;
+			}
+
+			Acc fold(Acc acc, const T* x, size_t n, size_t s, size_t) const {
+				if constexpr (std::is_same_v<T, float>) {
+					if (s == 1) return combine(acc, Max ? kernels::table().reduce_max(x, n) : kernels::table().reduce_min(x, n));
+				}
+				for (size_t j = 0; j < n; ++j) acc = combine(acc, static_cast<Acc>(x[j * s]));
+				return acc;
+			}
+
+			void fold_cols(Acc* acc, const T* x, size_t n, size_t) const {
+				if constexpr (std::is_same_v<T, float>) {
+					if (Max) kernels::table().maximum(acc, x, acc, n);
+					else kernels::table().minimum(acc, x, acc, n);
+				}
+				else {
+					for (size_t j = 0; j < n; ++j) acc[j] = combine(acc[j], static_cast<Acc>(x[j]));
+				}
+			}
+
+			Out finish(Acc a) const { return static_cast<T>(a); }
+		};
+
+		// argmax (Max) or argmin: the earlier index wins ties, the first NaN wins
+		template <class T, bool Max>
+		struct ArgOp {
+			struct Acc {
+				core::compute_t<T> v;
+				size_t i;
+			};
+			using Out = int32_t;
+
+			Acc init() const { return { ExtremeOp<T, Max>().init(), 0 }; }
+
+			Acc combine(Acc a, Acc b) const {
+				if (a.v != a.v) return a;
+				return (b.v != b.v || (Max ? b.v > a.v : b.v < a.v)) ? b : a;
+			}
+
+			// float rows: vector max/min, then a scan for its first position
+			Acc fold(Acc acc, const T* x, size_t n, size_t s, size_t r) const {
+				if constexpr (std::is_same_v<T, float>) {
+					if (s == 1) {
+						const float m = Max ? kernels::table().reduce_max(x, n) : kernels::table().reduce_min(x, n);
+						size_t j = 0;
+						if (m != m) {
+							while (x[j] == x[j]) ++j;
+						}
+						else {
+							while (x[j] != m) ++j;
+						}
+						return combine(acc, { m, r + j });
+					}
+				}
+				for (size_t j = 0; j < n; ++j) acc = combine(acc, { static_cast<core::compute_t<T>>(x[j * s]), r + j });
+				return acc;
+			}
+
+			void fold_cols(Acc* acc, const T* x, size_t n, size_t r) const {
+				for (size_t j = 0; j < n; ++j) acc[j] = combine(acc[j], { static_cast<core::compute_t<T>>(x[j]), r });
+			}
+
+			Out finish(Acc a) const { return static_cast<int32_t>(a.i); }
+		};
+
+		// po[e] = op over the reduced dims, e = row-major index over the kept dims
+		//
+		// reduced dims contiguous (or no better choice): each output walks
+		// its own elements in kReduceChunk chunks; a few long reductions
+		// run their chunks in parallel, many short ones split the outputs
+		// kept dims contiguous instead (sum over rows of [N, C], ...): blocks
+		// of outputs accumulate whole x rows with vector ops, kColumnChunk
+		// rows per partial, so every x line is read once, in order
+		template <class T, class Op>
+		void run_reduce(const Tensor& x, const ReducePlan& p, typename Op::Out* po, const Op& op) {
+			using Acc = typename Op::Acc;
+			const T* px = x.data_as<T>();
+			core::StridedLoop<1> kept(p.kept_sizes, { &p.kept_strides });
+			core::StridedLoop<1> red(p.red_sizes, { &p.red_strides });
+			const size_t O = kept.numel();
+			const size_t R = red.numel();
+			const size_t ks = kept.inner_stride(0);
+			const size_t rs = red.inner_stride(0);
+
+			if (rs != 1 && ks == 1 && O > 1) {
+				const size_t chunks = (R + kColumnChunk - 1) / kColumnChunk;
+				const size_t block = kColumnBlock;
+				const size_t blocks = (O + block - 1) / block;
+				const size_t rows = std::min(R, kColumnChunk);
+				std::vector<Acc> part(chunks * O);   // chunk c, output e: part[c * O + e]
+
+				parallel_for(0, chunks * blocks, std::max<size_t>(1, kDefaultGrain / (rows * block)), [&](size_t t0, size_t t1) {
+					for (size_t t = t0; t < t1; ++t) {
+						const size_t c = t / blocks;
+						const size_t e0 = (t % blocks) * block;
+						const size_t r0 = c * kColumnChunk;
+						size_t e = e0;
+						kept.for_range(e0, std::min(O, e0 + block), [&](const std::array<size_t, 1>& ko, size_t n) {
+							Acc* acc = part.data() + c * O + e;
+							std::fill(acc, acc + n, op.init());
+							size_t r = r0;
+							red.for_range(r0, std::min(R, r0 + kColumnChunk), [&](const std::array<size_t, 1>& ro, size_t rn) {
+								for (size_t q = 0; q < rn; ++q, ++r) op.fold_cols(acc, px + ko[0] + ro[0] + q * rs, n, r);
+								});
+							e += n;
+							});
+					}
+					});
+
+				parallel_for(0, O, kDefaultGrain, [&](size_t e0, size_t e1) {
+					for (size_t e = e0; e < e1; ++e) {
+						Acc a = part[e];
+						for (size_t c = 1; c < chunks; ++c) a = op.combine(a, part[c * O + e]);
+						po[e] = op.finish(a);
+					}
+					});
+				return;
+			}
+
+			const size_t chunks = (R + kReduceChunk - 1) / kReduceChunk;
+			auto chunk = [&](size_t xo, size_t c) {
+				Acc acc = op.init();
+				const size_t r0 = c * kReduceChunk;
+				size_t r = r0;
+				red.for_range(r0, std::min(R, r0 + kReduceChunk), [&](const std::array<size_t, 1>& ro, size_t n) {
+					acc = op.fold(acc, px + xo + ro[0], n, rs, r);
+					r += n;
+					});
+				return acc;
+			};
+
+			if (chunks > 1 && O < 2 * get_num_threads()) {
+				std::vector<Acc> part(chunks);
+				size_t e = 0;
+				kept.for_range(0, O, [&](const std::array<size_t, 1>& ko, size_t n) {
+					for (size_t j = 0; j < n; ++j, ++e) {
+						const size_t xo = ko[0] + j * ks;
+						parallel_for(0, chunks, 1, [&](size_t c0, size_t c1) {
+							for (size_t c = c0; c < c1; ++c) part[c] = chunk(xo, c);
+							});
+						Acc a = part[0];
+						for (size_t c = 1; c < chunks; ++c) a = op.combine(a, part[c]);
+						po[e] = op.finish(a);
+					}
+					});
+				return;
+			}
+
+			parallel_for(0, O, std::max<size_t>(1, kDefaultGrain / R), [&](size_t e0, size_t e1) {
+				size_t e = e0;
+				kept.for_range(e0, e1, [&](const std::array<size_t, 1>& ko, size_t n) {
+					for (size_t j = 0; j < n; ++j, ++e) {
+						const size_t xo = ko[0] + j * ks;
+						Acc a = chunk(xo, 0);
+						for (size_t c = 1; c < chunks; ++c) a = op.combine(a, chunk(xo, c));
+						po[e] = op.finish(a);
+					}
+					});
+				});
+		}
+
+		// make_op(TypeTag<T>{}, plan) -> op; the output dtype is the op's Out
+		template <class MakeOp>
+		Tensor reduce(const Tensor& x, const std::vector<size_t>& dims, bool keepdim, const char* name, MakeOp make_op) {
+			const ReducePlan p = make_plan(x, dims, keepdim, name);
+			return core::dispatch_dtype(x.dtype(), [&](auto tag) {
+				using T = typename decltype(tag)::type;
+				auto op = make_op(tag, p);
+				using Out = typename decltype(op)::Out;
+				Tensor out = Tensor::empty(p.out_sizes, core::dtype_v<Out>);
+				run_reduce<T>(x, p, out.template data_as<Out>(), op);
+				return out;
+				});
+		}
+
+		// ---- autograd ----
+
+		// out[i] = f(v) over sizes, v[k] the element of ins[k] expanded to
+		// sizes (float32, any strides): the elementwise glue of the backward
+		// passes below
+		template <size_t N, class F>
+		Tensor map_expanded(const Shape& sizes, const std::array<const Tensor*, N>& ins, F f) {
+			Tensor out = Tensor::empty(sizes);
+			std::vector<Tensor> views;
+			views.reserve(N);
+			std::array<const Shape*, N + 1> strides;
+			strides[0] = &out.strides();
+			for (size_t k = 0; k < N; ++k) {
+				views.push_back(ins[k]->detach().expand(sizes));
+				strides[k + 1] = &views.back().strides();
+			}
+			core::StridedLoop<N + 1> loop(sizes, strides);
+			std::array<const float*, N> pin;
+			std::array<size_t, N + 1> step;
+			for (size_t k = 0; k < N; ++k) pin[k] = views[k].data();
+			for (size_t k = 0; k <= N; ++k) step[k] = loop.inner_stride(k);
+			float* po = out.data();
+			parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+				loop.for_range(e0, e1, [&](const std::array<size_t, N + 1>& off, size_t n) {
+					std::array<float, N> v;
+					for (size_t j = 0; j < n; ++j) {
+						for (size_t k = 0; k < N; ++k) v[k] = pin[k][off[k + 1] + j * step[k + 1]];
+						po[off[0] + j * step[0]] = f(v);
+					}
+					});
+				});
+			return out;
+		}
+
+		// x's sizes with the reduced dims kept as 1: the result's shape under
+		// keepdim, which broadcasts against x
+		Shape keep_sizes(const Tensor& x, const std::vector<size_t>& dims) {
+			Shape s = x.sizes();
+			for (size_t d : dims) s[d] = 1;
+			return s;
+		}
+
+		// every reduced element gets the gradient of its output (/ count for mean)
+		struct SumBackward : GradFn {
+			Shape in_sizes, kept;
+			float scale;
+
+			SumBackward(Shape in, Shape k, float sc) : in_sizes(std::move(in)), kept(std::move(k)), scale(sc) {}
+
+			void backward(const Tensor& g) override {
+				Tensor gk = g.contiguous().reshape(kept);
+				const float sc = scale;
+				accumulate(0, map_expanded<1>(in_sizes, { &gk }, [sc](const std::array<float, 1>& v) { return v[0] * sc; }));
+			}
+		};
+
+		// d prod / d x_i = product of the other elements: out / x_i without
+		// zeros, the product of the nonzero ones at a single zero, 0 beyond
+		// saved: x
+		struct ProdBackward : GradFn {
+			std::vector<size_t> dims;
+
+			ProdBackward(Tensor x, std::vector<size_t> d) : dims(std::move(d)) { saved.push_back(std::move(x)); }
+
+			void backward(const Tensor& g) override {
+				const Tensor& x = saved[0];
+				const Shape kept = keep_sizes(x, dims);
+				Tensor nonzero = map_expanded<1>(x.sizes(), { &x }, [](const std::array<float, 1>& v) { return v[0] == 0.0f ? 1.0f : v[0]; });
+				Tensor is_zero = map_expanded<1>(x.sizes(), { &x }, [](const std::array<float, 1>& v) { return v[0] == 0.0f ? 1.0f : 0.0f; });
+				Tensor p = prod(nonzero, dims, true);
+				Tensor z = sum(is_zero, dims, true);
+				Tensor gk = g.contiguous().reshape(kept);
+				accumulate(0, map_expanded<4>(x.sizes(), { &x, &p, &z, &gk }, [](const std::array<float, 4>& v) {
+					if (v[0] != 0.0f) return v[2] == 0.0f ? v[3] * v[1] / v[0] : 0.0f;
+					return v[2] == 1.0f ? v[3] * v[1] : 0.0f;
+					}));
+			}
+		};
+
+		// the gradient goes to the elements equal to their output (NaN
+		// counting as equal to NaN), split evenly between ties
+		// saved: x, out (with keepdim sizes)
+		struct ExtremeBackward : GradFn {
+			std::vector<size_t> dims;
+
+			ExtremeBackward(Tensor x, Tensor out, std::vector<size_t> d) : dims(std::move(d)) {
+				saved.push_back(std::move(x));
+				saved.push_back(std::move(out));
+			}
+
+			void backward(const Tensor& g) override {
+				const Tensor& x = saved[0];
+				const Tensor& out = saved[1];
+				Tensor hit = map_expanded<2>(x.sizes(), { &x, &out }, [](const std::array<float, 2>& v) {
+					return v[0] == v[1] || (std::isnan(v[0]) && std::isnan(v[1])) ? 1.0f : 0.0f;
+					});
+				Tensor ties = sum(hit, dims, true);
+				Tensor gk = g.contiguous().reshape(out.sizes());
+				accumulate(0, map_expanded<3>(x.sizes(), { &hit, &gk, &ties }, [](const std::array<float, 3>& v) {
+					return v[0] != 0.0f ? v[1] / v[2] : 0.0f;
+					}));
+			}
+		};
+
+		Tensor sum_impl(const Tensor& x, const std::vector<size_t>& dims, bool keepdim, bool mean) {
+			const char* name = mean ? "mean" : "sum";
+			if (mean) {
+				ML_CHECK(x.dtype() == DType::Float32 || x.dtype() == DType::Float64 ||
+					x.dtype() == DType::Float16 || x.dtype() == DType::BFloat16,
+					std::string("mean: floating dtype required, got ") + core::dtype_name(x.dtype()));
+			}
+			Tensor out = reduce(x, dims, keepdim, name, [&](auto tag, const ReducePlan& p) {
+				SumOp<typename decltype(tag)::type> op;
+				if (mean) op.count = core::numel(p.red_sizes);
+				return op;
+				});
+			if (x.dtype() == DType::Float32 && autograd::needs_grad({ &x })) {
+				const float scale = mean ? float(out.numel()) / float(x.numel()) : 1.0f;
+				autograd::record(out, std::make_shared<SumBackward>(x.sizes(), keep_sizes(x, dims), scale), { &x });
+			}
+			return out;
+		}
+
+		Tensor prod_impl(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+			Tensor out = reduce(x, dims, keepdim, "prod", [](auto tag, const ReducePlan&) {
+				return ProdOp<typename decltype(tag)::type>();
+				});
+			if (x.dtype() == DType::Float32 && autograd::needs_grad({ &x })) {
+				autograd::record(out, std::make_shared<ProdBackward>(x.detach(), dims), { &x });
+			}
+			return out;
+		}
+
+		template <bool Max>
+		Tensor extreme_impl(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+			Tensor out = reduce(x, dims, keepdim, Max ? "max" : "min", [](auto tag, const ReducePlan&) {
+				return ExtremeOp<typename decltype(tag)::type, Max>();
+				});
+			if (x.dtype() == DType::Float32 && autograd::needs_grad({ &x })) {
+				Tensor kept = out.detach().reshape(keep_sizes(x, dims));
+				autograd::record(out, std::make_shared<ExtremeBackward>(x.detach(), std::move(kept), dims), { &x });
+			}
+			return out;
+		}
+
+		template <bool Max>
+		Tensor arg_impl(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+			const char* name = Max ? "argmax" : "argmin";
+			size_t count = 1;
+			for (size_t d : dims) count *= d < x.ndim() ? x.sizes()[d] : 1;
+			ML_CHECK(count <= size_t(std::numeric_limits<int32_t>::max()), std::string(name) + ": index does not fit int32");
+			return reduce(x, dims, keepdim, name, [](auto tag, const ReducePlan&) {
+				return ArgOp<typename decltype(tag)::type, Max>();
+				});
+		}
+
+		void check_dims(const std::vector<size_t>& dims, const char* name) {
+			ML_CHECK(!dims.empty(), std::string(name) + ": no dims to reduce");
+		}
+
+	} // namespace
+
+	Tensor sum(const Tensor& x) {
+		return sum_impl(x, all_dims(x), false, false);
+	}
+
+	Tensor sum(const Tensor& x, size_t dim, bool keepdim) {
+		return sum_impl(x, { dim }, keepdim, false);
+	}
+
+	Tensor sum(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+		check_dims(dims, "sum");
+		return sum_impl(x, dims, keepdim, false);
+	}
+
+	Tensor mean(const Tensor& x) {
+		return sum_impl(x, all_dims(x), false, true);
+	}
+
+	Tensor mean(const Tensor& x, size_t dim, bool keepdim) {
+		return sum_impl(x, { dim }, keepdim, true);
+	}
+
+	Tensor mean(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+		check_dims(dims, "mean");
+		return sum_impl(x, dims, keepdim, true);
+	}
+
+	Tensor prod(const Tensor& x) {
+		return prod_impl(x, all_dims(x), false);
+	}
+
+	Tensor prod(const Tensor& x, size_t dim, bool keepdim) {
+		return prod_impl(x, { dim }, keepdim);
+	}
+
+	Tensor prod(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+		check_dims(dims, "prod");
+		return prod_impl(x, dims, keepdim);
+	}
+
+	Tensor max(const Tensor& x) {
+		return extreme_impl<true>(x, all_dims(x), false);
+	}
+
+	Tensor max(const Tensor& x, size_t dim, bool keepdim) {
+		return extreme_impl<true>(x, { dim }, keepdim);
+	}
+
+	Tensor max(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+		check_dims(dims, "max");
+		return extreme_impl<true>(x, dims, keepdim);
+	}
+
+	Tensor min(const Tensor& x) {
+		return extreme_impl<false>(x, all_dims(x), false);
+	}
+
+	Tensor min(const Tensor& x, size_t dim, bool keepdim) {
+		return extreme_impl<false>(x, { dim }, keepdim);
+	}
+
+	Tensor min(const Tensor& x, const std::vector<size_t>& dims, bool keepdim) {
+		check_dims(dims, "min");
+		return extreme_impl<false>(x, dims, keepdim);
+	}
+
+	Tensor argmax(const Tensor& x) {
+		return arg_impl<true>(x, all_dims(x), false);
+	}
+
+	Tensor argmax(const Tensor& x, size_t dim, bool keepdim) {
+		return arg_impl<true>(x, { dim }, keepdim);
+	}
+
+	Tensor argmin(const Tensor& x) {
+		return arg_impl<false>(x, all_dims(x), false);
+	}
+
+	Tensor argmin(const Tensor& x, size_t dim, bool keepdim) {
+		return arg_impl<false>(x, { dim }, keepdim);
+	}
+
+}
@@ -0,0 +1,193 @@
+#include "ml/ops/softmax.hpp"
+#include "ml/autograd/graph.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace ml::ops{
+
+	namespace {
+
+		// x with dim moved last (the other dims keep their order) as
+		// contiguous [rows, n] rows; no copy when dim is already last
+		Tensor rows_last(const Tensor& x, size_t dim) {
+			if (dim + 1 == x.ndim() && x.is_contiguous()) return x.detach();
+			Tensor t = x.detach();
+			for (size_t d = dim; d + 1 < x.ndim(); ++d) t = t.transpose(d, d + 1);
+			return t.contiguous();
+		}
+
+		// rows_last undone: t holds rows along dim, the result x's layout
+		Tensor from_rows_last(Tensor t, size_t dim) {
+			if (dim + 1 == t.ndim()) return t;
+			for (size_t d = t.ndim() - 1; d-- > dim;) t = t.transpose(d, d + 1);
+			return t.contiguous();
+		}
+
+		// fn(r) for every row, rows split over the pool
+		template <class F>
+		void for_rows(size_t rows, size_t n, F&& fn) {
+			parallel_for(0, rows, std::max<size_t>(1, kDefaultGrain / n), [&](size_t r0, size_t r1) {
+				for (size_t r = r0; r < r1; ++r) fn(r);
+				});
+		}
+
+		void check_input(const Tensor& x, size_t dim, const char* name) {
+			ML_CHECK(x.dtype() == DType::Float32, std::string(name) + ": float32 only");
+			ML_CHECK_LT(dim, x.ndim(), std::string(name) + ": dim out of range");
+		}
+
+		// dx = y * (dy - sum(dy * y)) per row
+		// saved: y
+		struct SoftmaxBackward : GradFn {
+			size_t dim;
+
+			SoftmaxBackward(Tensor y, size_t dim_) : dim(dim_) { saved.push_back(std::move(y)); }
+
+			void backward(const Tensor& grad_out) override {
+				Tensor g = rows_last(grad_out, dim);
+				Tensor yr = rows_last(saved[0], dim);
+				Tensor gx = Tensor::empty(g.sizes());
+				const size_t n = g.sizes().back();
+				const float* pg = g.data();
+				const float* py = yr.data();
+				float* px = gx.data();
+				const auto& k = kernels::table();
+				for_rows(g.numel() / n, n, [&](size_t r) {
+					const float* gr = pg + r * n;
+					const float* yrow = py + r * n;
+					float dot;
+					k.dot_rows(gr, 0, 1, yrow, n, &dot, 1);
+					for (size_t j = 0; j < n; ++j) px[r * n + j] = yrow[j] * (gr[j] - dot);
+					});
+				accumulate(0, from_rows_last(std::move(gx), dim));
+			}
+		};
+
+		// dx = dy - exp(y) * sum(dy) per row
+		// saved: y
+		struct LogSoftmaxBackward : GradFn {
+			size_t dim;
+
+			LogSoftmaxBackward(Tensor y, size_t dim_) : dim(dim_) { saved.push_back(std::move(y)); }
+
+			void backward(const Tensor& grad_out) override {
+				Tensor g = rows_last(grad_out, dim);
+				Tensor yr = rows_last(saved[0], dim);
+				Tensor gx = Tensor::empty(g.sizes());
+				const size_t n = g.sizes().back();
+				const float* pg = g.data();
+				const float* py = yr.data();
+				float* px = gx.data();
+				const auto& k = kernels::table();
+				for_rows(g.numel() / n, n, [&](size_t r) {
+					const float* gr = pg + r * n;
+					float* xr = px + r * n;
+					k.exp_scale(py + r * n, 0.0f, k.reduce_sum(gr, n), xr, n);
+					k.sub(gr, xr, xr, n);
+					});
+				accumulate(0, from_rows_last(std::move(gx), dim));
+			}
+		};
+
+		// dx = dy * exp(x - logsumexp(x)) per row
+		// saved: x, lse (contiguous, one value per row)
+		struct LogsumexpBackward : GradFn {
+			size_t dim;
+
+			LogsumexpBackward(Tensor x, Tensor lse, size_t dim_) : dim(dim_) {
+				saved.push_back(std::move(x));
+				saved.push_back(std::move(lse));
+			}
+
+			void backward(const Tensor& grad_out) override {
+				Tensor g = grad_out.contiguous();
+				Tensor xr = rows_last(saved[0], dim);
+				Tensor gx = Tensor::empty(xr.sizes());
+				const size_t n = xr.sizes().back();
+				const float* pg = g.data();
+				const float* pl = saved[1].data();
+				const float* pxr = xr.data();
+				float* px = gx.data();
+				const auto& k = kernels::table();
+				for_rows(xr.numel() / n, n, [&](size_t r) {
+					k.exp_scale(pxr + r * n, pl[r], pg[r], px + r * n, n);
+					});
+				accumulate(0, from_rows_last(std::move(gx), dim));
+			}
+		};
+
+		Tensor softmax_impl(const Tensor& x, size_t dim, bool log) {
+			check_input(x, dim, log ? "log_softmax" : "softmax");
+			Tensor xr = rows_last(x, dim);
+			Tensor yr = Tensor::empty(xr.sizes());
+			const size_t n = xr.sizes().back();
+			const float* px = xr.data();
+			float* py = yr.data();
+			const auto& k = kernels::table();
+			for_rows(xr.numel() / n, n, [&](size_t r) {
+				const float* xrow = px + r * n;
+				float* yrow = py + r * n;
+				float m, s;
+				k.softmax_stats(xrow, n, &m, &s);
+				if (log) {
+					const float c = m + std::log(s);
+					for (size_t j = 0; j < n; ++j) yrow[j] = xrow[j] - c;
+				}
+				else {
+					k.exp_scale(xrow, m, 1.0f / s, yrow, n);
+				}
+				});
+
+			Tensor y = from_rows_last(std::move(yr), dim);
+			if (autograd::needs_grad({ &x })) {
+				std::shared_ptr<GradFn> node;
+				if (log) node = std::make_shared<LogSoftmaxBackward>(y.detach(), dim);
+				else node = std::make_shared<SoftmaxBackward>(y.detach(), dim);
+				autograd::record(y, std::move(node), { &x });
+			}
+			return y;
+		}
+
+	} // namespace
+
+	Tensor softmax(const Tensor& x, size_t dim) {
+		return softmax_impl(x, dim, false);
+	}
+
+	Tensor log_softmax(const Tensor& x, size_t dim) {
+		return softmax_impl(x, dim, true);
+	}
+
+	Tensor logsumexp(const Tensor& x, size_t dim, bool keepdim) {
+		check_input(x, dim, "logsumexp");
+		Tensor xr = rows_last(x, dim);
+		const size_t n = xr.sizes().back();
+
+		// rows_last keeps the other dims in order: row r is output element r
+		Shape out_sizes;
+		for (size_t d = 0; d < x.ndim(); ++d) {
+			if (d != dim) out_sizes.push_back(x.sizes()[d]);
+			else if (keepdim) out_sizes.push_back(1);
+		}
+		Tensor out = Tensor::empty(out_sizes);
+		const float* px = xr.data();
+		float* po = out.data();
+		const auto& k = kernels::table();
+		for_rows(xr.numel() / n, n, [&](size_t r) {
+			float m, s;
+			k.softmax_stats(px + r * n, n, &m, &s);
+			po[r] = m + std::log(s);
+			});
+
+		if (autograd::needs_grad({ &x })) {
+			autograd::record(out, std::make_shared<LogsumexpBackward>(x.detach(), out.detach(), dim), { &x });
+		}
+		return out;
+	}
+
+}
@@ -0,0 +1,245 @@
+#include "runtime/thread_pool.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/core/error.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace ml::runtime {
+
+    namespace {
+
+        thread_local bool t_in_parallel = false;
+
+        // marks the current thread as running a parallel range
+        struct ParallelRegion {
+            bool prev;
+            ParallelRegion() : prev(t_in_parallel) { t_in_parallel = true; }
+            ~ParallelRegion() { t_in_parallel = prev; }
+        };
+
+        // idle workers retry this many times before going to sleep
+        constexpr int kSpinTries = 64;
+
+        size_t default_num_threads() {
+            if (const char* env = std::getenv("ML_NUM_THREADS")) {
+                long n = std::strtol(env, nullptr, 10);
+                if (n > 0) return static_cast<size_t>(n);
+            }
+            size_t hw = std::thread::hardware_concurrency();
+            return hw > 0 ? hw : 1;
+        }
+
+        // the current pool is read lock-free by every parallel_for; the mutex
+        // only guards creating and replacing it
+        // a replaced pool is stopped but never freed before exit: a thread
+        // that loaded the old pointer just before set_num_threads() finishes
+        // its call on it, on its own thread
+        std::mutex g_pool_mu;
+        std::atomic<ThreadPool*> g_pool{ nullptr };
+        std::vector<std::unique_ptr<ThreadPool>> g_pools;   // current one last
+
+    } // namespace
+
+    ThreadPool::ThreadPool(size_t n_threads) {
+        ML_CHECK(n_threads > 0, "ThreadPool: need at least one thread");
+        queues_.reserve(n_threads);
+        for (size_t i = 0; i < n_threads; ++i) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        workers_.reserve(n_threads - 1);
+        for (size_t i = 1; i < n_threads; ++i) {
+            workers_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        stop_workers();
+    }
+
+    void ThreadPool::stop_workers() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mu_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    // -------- queues --------
+    void ThreadPool::push(size_t self, const Task& t) {
+        {
+            std::lock_guard<std::mutex> lock(queues_[self]->mu);
+            queues_[self]->tasks.push_back(t);
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        // taking the lock orders this against a worker that is about to sleep
+        { std::lock_guard<std::mutex> lock(sleep_mu_); }
+        sleep_cv_.notify_one();
+    }
+
+    bool ThreadPool::pop(size_t self, Task& t) {
+        WorkQueue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mu);
+        if (q.tasks.empty()) return false;
+        t = q.tasks.back();
+        q.tasks.pop_back();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ThreadPool::steal(size_t self, Task& t) {
+        const size_t n = queues_.size();
+        for (size_t k = 1; k < n; ++k) {
+            WorkQueue& q = *queues_[(self + k) % n];
+            std::lock_guard<std::mutex> lock(q.mu);
+            if (q.tasks.empty()) continue;
+            t = q.tasks.front();
+            q.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    bool ThreadPool::find_task(size_t self, Task& t) {
+        if (queued_.load(std::memory_order_acquire) == 0) return false;
+        return pop(self, t) || steal(self, t);
+    }
+
+    // -------- execution --------
+    void ThreadPool::execute(size_t self, Task t) {
+        Job& job = *t.job;
+
+        // keep the left half, publish the right half for thieves
+        while (t.end - t.begin > job.grain) {
+            size_t chunks = (t.end - t.begin + job.grain - 1) / job.grain;
+            size_t mid = t.begin + (chunks / 2) * job.grain;
+            push(self, Task{ t.job, mid, t.end });
+            t.end = mid;
+        }
+
+        if (!job.failed.load(std::memory_order_relaxed)) {
+            ParallelRegion region;
+            ml::detail::GradModeScope mode(job.mode);
+            try {
+                (*job.fn)(t.begin, t.end);
+            }
+            catch (...) {
+                bool expected = false;
+                if (job.failed.compare_exchange_strong(expected, true)) {
+                    job.error = std::current_exception();
+                }
+            }
+        }
+
+        // last access to job: the caller may return as soon as this hits zero
+        job.remaining.fetch_sub(t.end - t.begin, std::memory_order_acq_rel);
+    }
+
+    void ThreadPool::worker_loop(size_t self) {
+        for (;;) {
+            Task t;
+            bool found = false;
+            for (int i = 0; i < kSpinTries && !found; ++i) {
+                found = find_task(self, t);
+                if (!found) std::this_thread::yield();
+            }
+            if (found) {
+                execute(self, t);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mu_);
+            sleep_cv_.wait(lock, [&] {
+                return stop_ || queued_.load(std::memory_order_acquire) > 0;
+            });
+            if (stop_) return;
+        }
+    }
+
+    void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn) {
+        if (begin >= end) return;
+        grain = std::max<size_t>(grain, 1);
+
+        // one range, no workers, or nested inside another parallel range:
+        // run inline so nested parallelism never oversubscribes the machine
+        if (end - begin <= grain || workers_.empty() || t_in_parallel) {
+            ParallelRegion region;
+            fn(begin, end);
+            return;
+        }
+
+        // another thread already drives the pool: do the work here instead of queueing
+        std::unique_lock<std::mutex> caller(caller_mu_, std::try_to_lock);
+        if (!caller.owns_lock()) {
+            ParallelRegion region;
+            fn(begin, end);
+            return;
+        }
+
+        Job job;
+        job.fn = &fn;
+        job.grain = grain;
+        job.mode = ml::detail::grad_mode_state();
+        job.remaining.store(end - begin, std::memory_order_relaxed);
+
+        execute(0, Task{ &job, begin, end });
+
+        // help until every range is done
+        while (job.remaining.load(std::memory_order_acquire) != 0) {
+            Task t;
+            if (find_task(0, t)) execute(0, t);
+            else std::this_thread::yield();
+        }
+
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+    ThreadPool& pool() {
+        if (ThreadPool* p = g_pool.load(std::memory_order_acquire)) return *p;
+
+        std::lock_guard<std::mutex> lock(g_pool_mu);
+        ThreadPool* p = g_pool.load(std::memory_order_relaxed);
+        if (!p) {
+            g_pools.push_back(std::make_unique<ThreadPool>(default_num_threads()));
+            p = g_pools.back().get();
+            g_pool.store(p, std::memory_order_release);
+        }
+        return *p;
+    }
+
+    bool in_parallel_region() { return t_in_parallel; }
+
+} // namespace ml::runtime
+
+namespace ml {
+
+    void set_num_threads(size_t n) {
+        ML_CHECK(n > 0, "set_num_threads(): n must be > 0");
+        // a worker would end up joining itself
+        ML_CHECK(!runtime::in_parallel_region(), "set_num_threads(): called from inside a parallel_for range");
+        std::lock_guard<std::mutex> lock(runtime::g_pool_mu);
+        runtime::ThreadPool* old = runtime::g_pool.load(std::memory_order_relaxed);
+        if (old && old->num_threads() == n) return;
+        runtime::g_pools.push_back(std::make_unique<runtime::ThreadPool>(n));
+        runtime::g_pool.store(runtime::g_pools.back().get(), std::memory_order_release);
+        if (old) old->stop_workers();
+    }
+
+    size_t get_num_threads() {
+        return runtime::pool().num_threads();
+    }
+
+    bool in_parallel_region() {
+        return runtime::in_parallel_region();
+    }
+
+    void parallel_for(size_t begin, size_t end, size_t grain,
+        const std::function<void(size_t, size_t)>& fn) {
+        runtime::pool().parallel_for(begin, end, grain, fn);
+    }
+
+} // namespace ml
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ml/autograd/grad_mode.hpp"
+
+// internal work-stealing pool behind ml::parallel_for / ml::set_num_threads
+
+namespace ml::runtime {
+
+    using RangeFn = std::function<void(size_t, size_t)>;
+
+    class ThreadPool {
+    public:
+        // n_threads counts the calling thread, so n_threads - 1 workers are spawned
+        explicit ThreadPool(size_t n_threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t num_threads() const { return queues_.size(); }
+
+        // run fn(b, e) over [begin, end) and block until every range is done
+        // ranges are split in halves on grain boundaries, so every parallel leaf
+        // range starts at begin + k*grain and holds at most grain elements
+        // the caller helps; the first exception thrown by fn is rethrown here
+        void parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn);
+
+        // joins the workers once they are idle; parallel_for keeps working
+        // afterwards (the caller then runs every range itself)
+        void stop_workers();
+
+    private:
+        struct Job {
+            const RangeFn* fn;
+            size_t grain;
+            std::atomic<size_t> remaining;   // elements not yet processed
+            std::atomic<bool> failed{ false };
+            std::exception_ptr error;        // written once, by whoever sets failed
+            ml::detail::GradModeState mode;  // the caller's, set on every task
+        };
+
+        struct Task {
+            Job* job;
+            size_t begin;
+            size_t end;
+        };
+
+        // owner pushes/pops at the back, thieves take from the front
+        // (the oldest and therefore largest ranges)
+        struct WorkQueue {
+            std::mutex mu;
+            std::deque<Task> tasks;
+        };
+
+        void push(size_t self, const Task& t);
+        bool pop(size_t self, Task& t);
+        bool steal(size_t self, Task& t);
+        bool find_task(size_t self, Task& t);
+        void execute(size_t self, Task t);
+        void worker_loop(size_t self);
+
+        // slot 0 belongs to the external caller, 1..n-1 to the workers
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::vector<std::thread> workers_;
+
+        std::atomic<size_t> queued_{ 0 };    // tasks sitting in any queue
+        std::mutex sleep_mu_;
+        std::condition_variable sleep_cv_;
+        bool stop_{ false };
+
+        std::mutex caller_mu_;               // owner of slot 0
+    };
+
+    // process-wide pool sized by ml::set_num_threads; lock-free after the
+    // first call, and the reference stays valid until exit
+    ThreadPool& pool();
+
+    // true on a thread that is currently executing a parallel range
+    bool in_parallel_region();
+
+} // namespace ml::runtime
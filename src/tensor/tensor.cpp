@@ -1,128 +1,363 @@
 #include "ml/tensor/tensor.hpp"
+#include "ml/autograd/grad_mode.hpp"
+#include "ml/autograd/graph.hpp"
 #include "ml/core/error.hpp"
 #include "ml/core/storage.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ops/kernels/kernels.hpp"
 
 #include <algorithm> // fill, copy
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace ml {
 
     // -------- internal ctor --------
     Tensor::Tensor(std::shared_ptr<Storage> storage,
         size_t offset,
-        std::vector<size_t> sizes,
-        std::vector<size_t> strides)
+        Shape sizes,
+        Shape strides)
         : storage_(std::move(storage)),
         offset_(offset),
         sizes_(std::move(sizes)),
-        strides_(std::move(strides)) {
+        strides_(std::move(strides)),
+        inference_(inference_mode_enabled()) {
 
-        ML_CHECK(storage_ != nullptr, "Tensor: storage is null");
-        ML_CHECK_EQ(sizes_.size(), strides_.size(), "Tensor: sizes/strides rank mismatch");
+        // every caller has validated its arguments already
+        ML_DCHECK(storage_ != nullptr, "Tensor: storage is null");
+        ML_DCHECK_EQ(sizes_.size(), strides_.size(), "Tensor: sizes/strides rank mismatch");
 
         // v1 restriction: no zero-sized dims
+#if ML_DCHECKS_ENABLED
         for (size_t s : sizes_) {
-            ML_CHECK(s > 0, "Tensor: dimension must be > 0 (v1 restriction)");
+            ML_DCHECK(s > 0, "Tensor: dimension must be > 0 (v1 restriction)");
         }
+#endif
     }
 
     // -------- factories --------
-    Tensor Tensor::empty(const std::vector<size_t>& sizes) {
-        auto st = std::make_shared<Storage>(core::numel(sizes));
+    // uninitialized: every caller overwrites the whole buffer
+    Tensor Tensor::empty(const Shape& sizes, DType dtype) {
+        auto st = std::make_shared<Storage>(core::numel(sizes), dtype);
         auto strides = core::contiguous_strides(sizes);
         return Tensor(st, 0, sizes, strides);
     }
 
-    Tensor Tensor::zeros(const std::vector<size_t>& sizes) {
-        Tensor t = empty(sizes);
-        std::fill(t.storage_->data.begin(), t.storage_->data.end(), 0.0f);
+    // one pass of aligned stores over the fresh (uninitialized) buffer
+    // float32 goes through the SIMD fill kernel
+    static void fill_storage(Storage& st, float v) {
+        core::dispatch_dtype(st.dtype(), [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            T* p = st.data<T>();
+            if constexpr (std::is_same_v<T, float>) {
+                auto fill = ops::kernels::table().fill;
+                // grain is a multiple of 16 floats, so every chunk starts 64-byte aligned
+                parallel_for(0, st.size(), kDefaultGrain, [&](size_t i0, size_t i1) {
+                    fill(p + i0, v, i1 - i0);
+                    });
+            }
+            else {
+                const T x = core::convert_value<T>(v);
+                parallel_for(0, st.size(), kDefaultGrain, [&](size_t i0, size_t i1) {
+                    std::fill(p + i0, p + i1, x);
+                    });
+            }
+            });
+    }
+
+    Tensor Tensor::zeros(const Shape& sizes, DType dtype) {
+        Tensor t = empty(sizes, dtype);
+        fill_storage(*t.storage_, 0.0f);
         return t;
     }
 
-    Tensor Tensor::ones(const std::vector<size_t>& sizes) {
-        Tensor t = empty(sizes);
-        std::fill(t.storage_->data.begin(), t.storage_->data.end(), 1.0f);
+    Tensor Tensor::ones(const Shape& sizes, DType dtype) {
+        Tensor t = empty(sizes, dtype);
+        fill_storage(*t.storage_, 1.0f);
         return t;
     }
 
     Tensor Tensor::arange(size_t n) {
         Tensor t = empty({ n });
         for (size_t i = 0; i < n; ++i) {
-            t.storage_->data[i] = static_cast<float>(i);
+            t.storage_->ptr()[i] = static_cast<float>(i);
         }
         return t;
     }
 
     Tensor Tensor::from_vector(const std::vector<float>& v,
-        const std::vector<size_t>& sizes) {
+        const Shape& sizes) {
         ML_CHECK_EQ(v.size(), core::numel(sizes), "from_vector: data size != numel(shape)");
         auto st = std::make_shared<Storage>(v.size());
-        std::copy(v.begin(), v.end(), st->data.begin());
+        std::copy(v.begin(), v.end(), st->ptr());
+        return Tensor(st, 0, sizes, core::contiguous_strides(sizes));
+    }
+
+    Tensor Tensor::from_blob(void* data, const Shape& sizes, DType dtype) {
+        ML_CHECK(data != nullptr, "from_blob: data is null");
+        auto st = std::make_shared<Storage>(data, core::numel(sizes), dtype, Storage::Borrowed{});
         return Tensor(st, 0, sizes, core::contiguous_strides(sizes));
     }
 
+    Tensor Tensor::zeros_like(const Tensor& t) {
+        return zeros(t.sizes(), t.dtype());
+    }
+
+    Tensor Tensor::ones_like(const Tensor& t) {
+        return ones(t.sizes(), t.dtype());
+    }
+
     // -------- info --------
     size_t Tensor::ndim() const { return sizes_.size(); }
     size_t Tensor::numel() const { return core::numel(sizes_); }
-    const std::vector<size_t>& Tensor::sizes() const { return sizes_; }
-    const std::vector<size_t>& Tensor::strides() const { return strides_; }
+    const Shape& Tensor::sizes() const { return sizes_; }
+    const Shape& Tensor::strides() const { return strides_; }
     bool Tensor::is_contiguous() const { return core::is_contiguous(sizes_, strides_); }
+    DType Tensor::dtype() const { return storage_->dtype(); }
+    size_t Tensor::element_size() const { return core::dtype_size(storage_->dtype()); }
 
     // -------- raw data --------
-    float* Tensor::data() { return storage_->ptr() + offset_; }
-    const float* Tensor::data() const { return storage_->ptr() + offset_; }
+    float* Tensor::data() { return data_as<float>(); }
+    const float* Tensor::data() const { return data_as<float>(); }
+
+    void* Tensor::raw_data() {
+        return static_cast<char*>(storage_->raw()) + offset_ * element_size();
+    }
+
+    const void* Tensor::raw_data() const {
+        return static_cast<const char*>(storage_->raw()) + offset_ * element_size();
+    }
 
     const std::shared_ptr<Storage>& Tensor::storage_ptr() const { return storage_; }
 
     // -------- indexing (initializer_list) --------
-    float& Tensor::at(std::initializer_list<size_t> idx_list) {
-        std::vector<size_t> idx(idx_list.begin(), idx_list.end());
-        return at_vec_(idx);
+    float& Tensor::at(std::initializer_list<size_t> idx) {
+        ML_CHECK(dtype() == DType::Float32, "at(): float32 tensors only");
+        return storage_->ptr()[checked_offset_(idx)];
     }
 
-    float Tensor::at(std::initializer_list<size_t> idx_list) const {
-        std::vector<size_t> idx(idx_list.begin(), idx_list.end());
-        return at_vec_(idx);
+    float Tensor::at(std::initializer_list<size_t> idx) const {
+        ML_CHECK(dtype() == DType::Float32, "at(): float32 tensors only");
+        return storage_->ptr()[checked_offset_(idx)];
     }
 
-    // -------- private helpers for indexing --------
-    float& Tensor::at_vec_(const std::vector<size_t>& idx) {
+    // -------- private helper for indexing --------
+    // bounds-checked storage offset, straight from the list (no index copy)
+    size_t Tensor::checked_offset_(std::initializer_list<size_t> idx) const {
         ML_CHECK_EQ(idx.size(), ndim(), "at(): wrong number of indices");
-        for (size_t d = 0; d < idx.size(); ++d) {
-            ML_CHECK_LT(idx[d], sizes_[d], "at(): index out of range");
+        size_t lin = offset_;
+        size_t d = 0;
+        for (size_t i : idx) {
+            ML_CHECK_LT(i, sizes_[d], "at(): index out of range");
+            lin += i * strides_[d];
+            ++d;
+        }
+        ML_DCHECK_LT(lin, storage_->size(), "at(): linear index out of storage bounds");
+        return lin;
+    }
+
+    // -------- quantization --------
+    void Tensor::set_qparams(std::shared_ptr<const QuantParams> qp) {
+        if (qp) {
+            ML_CHECK(dtype() == DType::Int8 || dtype() == DType::UInt8, "set_qparams(): int8/uint8 tensors only");
+            ML_CHECK(!qp->scale.empty() && qp->scale.size() == qp->zero_point.size(), "set_qparams(): scale/zero_point size mismatch");
+            if (qp->per_channel()) {
+                ML_CHECK_LT(static_cast<size_t>(qp->axis), ndim(), "set_qparams(): axis out of range");
+                ML_CHECK_EQ(qp->scale.size(), sizes_[qp->axis], "set_qparams(): one scale per channel expected");
+            }
+            else {
+                ML_CHECK_EQ(qp->scale.size(), size_t(1), "set_qparams(): per-tensor params need one scale");
+            }
         }
+        qparams_ = std::move(qp);
+    }
 
-        size_t lin = core::linear_index(offset_, strides_, idx);
-        ML_CHECK_LT(lin, storage_->size(), "at(): linear index out of storage bounds");
-        return storage_->data[lin];
+    // per-channel params moved to another dim (null/per-tensor pass through)
+    static std::shared_ptr<const QuantParams> move_axis(const std::shared_ptr<const QuantParams>& qp, int axis) {
+        if (!qp || !qp->per_channel() || qp->axis == axis) return qp;
+        auto moved = std::make_shared<QuantParams>(*qp);
+        moved->axis = axis;
+        return moved;
     }
 
-    float Tensor::at_vec_(const std::vector<size_t>& idx) const {
-        ML_CHECK_EQ(idx.size(), ndim(), "at() const: wrong number of indices");
-        for (size_t d = 0; d < idx.size(); ++d) {
-            ML_CHECK_LT(idx[d], sizes_[d], "at() const: index out of range");
+    // -------- autograd --------
+    void Tensor::set_requires_grad(bool v) {
+        if (v) {
+            ML_CHECK(dtype() == DType::Float32, "set_requires_grad(): float32 tensors only");
+            ML_CHECK(!inference_, "set_requires_grad(): inference tensor (created under InferenceMode)");
+            if (!autograd_) autograd_ = std::make_shared<AutogradMeta>();
         }
+        requires_grad_ = v;
+    }
+
+    void Tensor::set_grad_fn(std::shared_ptr<GradFn> fn) {
+        if (!autograd_) autograd_ = std::make_shared<AutogradMeta>();
+        autograd_->grad_fn = std::move(fn);
+        requires_grad_ = true;
+    }
+
+    const Tensor& Tensor::grad() const {
+        ML_CHECK(has_grad(), "grad(): tensor has no grad");
+        return *autograd_->grad;
+    }
 
-        size_t lin = core::linear_index(offset_, strides_, idx);
-        ML_CHECK_LT(lin, storage_->size(), "at() const: linear index out of storage bounds");
-        return storage_->data[lin];
+    Tensor& Tensor::grad_mut() {
+        ML_CHECK(has_grad(), "grad_mut(): tensor has no grad");
+        return *autograd_->grad;
     }
 
-    // "odometer" increment: returns false when finished
-    bool Tensor::next_index_(std::vector<size_t>& idx, const std::vector<size_t>& sizes) {
-        // increment last dimension, carry if overflow
-        for (size_t d = sizes.size(); d-- > 0; ) {
-            idx[d] += 1;
-            if (idx[d] < sizes[d]) return true; // no carry needed
-            idx[d] = 0; // carry
+    void Tensor::zero_grad() {
+        if (has_grad()) fill_storage(*autograd_->grad->storage_, 0.0f);
+    }
+
+    Tensor Tensor::detach() const {
+        Tensor t(storage_, offset_, sizes_, strides_);
+        t.qparams_ = qparams_;
+        t.inference_ = t.inference_ || inference_;
+        return t;
+    }
+
+    // nodes run in reverse topological order of the graph below the loss,
+    // so every node has all of its incoming gradient before it runs, and
+    // release their saved tensors right after
+    // the walk is an explicit stack (deep graphs do not recurse)
+    void Tensor::backward(bool retain_graph) {
+        ML_CHECK(requires_grad_ && autograd_, "backward(): tensor does not require grad");
+        ML_CHECK_EQ(numel(), size_t(1), "backward(): loss must have one element");
+
+        std::vector<AutogradMeta*> order;   // post-order: inputs before their consumers
+        std::unordered_set<AutogradMeta*> seen{ autograd_.get() };
+        std::vector<std::pair<AutogradMeta*, size_t>> stack{ { autograd_.get(), 0 } };
+        while (!stack.empty()) {
+            auto& [meta, next] = stack.back();
+            const GradFn* fn = meta->grad_fn.get();
+            if (fn && next == 0) {
+                ML_CHECK(!fn->released(), "backward(): graph already freed by a previous backward (retain_graph keeps it)");
+            }
+            if (fn && next < fn->inputs.size()) {
+                AutogradMeta* in = fn->inputs[next++].get();
+                if (in && seen.insert(in).second) stack.push_back({ in, 0 });
+                continue;
+            }
+            order.push_back(meta);
+            stack.pop_back();
+        }
+
+        Tensor seed = ones(sizes_);
+        if (autograd_->grad) {
+            // a leaf loss: its grad accumulates like any other leaf
+            ops::kernels::table().add(autograd_->grad->data(), seed.data(), autograd_->grad->data(), 1);
+        }
+        else {
+            autograd_->grad = std::make_unique<Tensor>(std::move(seed));
+        }
+
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            AutogradMeta* meta = *it;
+            if (!meta->grad_fn || !meta->grad) continue;   // leaf, or no gradient reached it
+            Tensor g = std::move(*meta->grad);
+            meta->grad.reset();
+            meta->grad_fn->backward(g);
+            if (!retain_graph) meta->grad_fn->release();
         }
-        return false; // overflowed past the first dim => done
     }
 
     // -------- views --------
-    Tensor Tensor::reshape(const std::vector<size_t>& new_sizes) const {
+    namespace {
+
+        // dst = src elementwise, same shape and dtype, any strides on both sides
+        void copy_elements(Tensor& dst, const Tensor& src) {
+            core::StridedLoop<2> loop(dst.sizes(), { &dst.strides(), &src.strides() });
+            const size_t dst_stride = loop.inner_stride(0);
+            const size_t src_stride = loop.inner_stride(1);
+
+            core::dispatch_dtype(dst.dtype(), [&](auto tag) {
+                using T = typename decltype(tag)::type;
+                T* pd = dst.data_as<T>();
+                const T* ps = src.data_as<T>();
+
+                parallel_for(0, loop.numel(), kDefaultGrain, [&](size_t e0, size_t e1) {
+                    loop.for_range(e0, e1, [&](const std::array<size_t, 2>& off, size_t n) {
+                        T* d = pd + off[0];
+                        const T* s = ps + off[1];
+                        if (dst_stride == 1 && src_stride == 1) {
+                            std::copy(s, s + n, d);
+                        }
+                        else {
+                            for (size_t j = 0; j < n; ++j) d[j * dst_stride] = s[j * src_stride];
+                        }
+                        });
+                    });
+                });
+        }
+
+        // views of a tensor that requires grad are graph nodes: the gradient
+        // of the view is mapped back onto the base's shape
+
+        struct ReshapeBackward : GradFn {
+            Shape in_sizes;
+            explicit ReshapeBackward(Shape s) : in_sizes(std::move(s)) {}
+            void backward(const Tensor& g) override { accumulate(0, g.contiguous().reshape(in_sizes)); }
+        };
+
+        struct TransposeBackward : GradFn {
+            size_t dim0, dim1;
+            TransposeBackward(size_t d0, size_t d1) : dim0(d0), dim1(d1) {}
+            void backward(const Tensor& g) override { accumulate(0, g.transpose(dim0, dim1)); }
+        };
+
+        // zeros outside the slice
+        struct SliceBackward : GradFn {
+            Shape in_sizes;
+            size_t dim, start;
+            SliceBackward(Shape s, size_t d, size_t st) : in_sizes(std::move(s)), dim(d), start(st) {}
+            void backward(const Tensor& g) override {
+                Tensor gx = Tensor::zeros(in_sizes);
+                Tensor window = gx.slice(dim, start, g.sizes()[dim]);
+                copy_elements(window, g);
+                accumulate(0, std::move(gx));
+            }
+        };
+
+        // every expanded copy of an element adds into it
+        struct ExpandBackward : GradFn {
+            Shape in_sizes;
+            explicit ExpandBackward(Shape s) : in_sizes(std::move(s)) {}
+            void backward(const Tensor& g) override { accumulate(0, autograd::sum_to(g, in_sizes)); }
+        };
+
+        // contiguous() and clone(): same elements, same shape
+        struct IdentityBackward : GradFn {
+            void backward(const Tensor& g) override { accumulate(0, g.detach()); }
+        };
+
+        void track_view(Tensor& view, const Tensor& base, std::shared_ptr<GradFn> node) {
+            autograd::record(view, std::move(node), { &base });
+        }
+
+    } // namespace
+
+    bool Tensor::view_needs_grad_(Tensor& view) const {
+        if (inference_) {
+            view.inference_ = true;
+            return false;
+        }
+        return autograd::needs_grad({ this });
+    }
+
+    Tensor Tensor::reshape(const Shape& new_sizes) const {
         ML_CHECK(is_contiguous(), "reshape(): requires contiguous tensor (v1)");
         ML_CHECK_EQ(core::numel(new_sizes), numel(), "reshape(): numel mismatch");
-        return Tensor(storage_, offset_, new_sizes, core::contiguous_strides(new_sizes));
+        ML_CHECK(!qparams_ || !qparams_->per_channel(), "reshape(): per-channel quantized tensor");
+        Tensor t(storage_, offset_, new_sizes, core::contiguous_strides(new_sizes));
+        t.qparams_ = qparams_;
+        if (view_needs_grad_(t)) track_view(t, *this, std::make_shared<ReshapeBackward>(sizes_));
+        return t;
     }
 
     Tensor Tensor::transpose(size_t dim0, size_t dim1) const {
@@ -134,42 +369,88 @@ namespace ml {
         std::swap(new_sizes[dim0], new_sizes[dim1]);
         std::swap(new_strides[dim0], new_strides[dim1]);
 
-        return Tensor(storage_, offset_, std::move(new_sizes), std::move(new_strides));
+        Tensor t(storage_, offset_, std::move(new_sizes), std::move(new_strides));
+        if (qparams_ && qparams_->per_channel()) {
+            int axis = qparams_->axis;
+            if (axis == static_cast<int>(dim0)) axis = static_cast<int>(dim1);
+            else if (axis == static_cast<int>(dim1)) axis = static_cast<int>(dim0);
+            t.qparams_ = move_axis(qparams_, axis);
+        }
+        else {
+            t.qparams_ = qparams_;
+        }
+        if (view_needs_grad_(t)) track_view(t, *this, std::make_shared<TransposeBackward>(dim0, dim1));
+        return t;
     }
 
     Tensor Tensor::slice(size_t dim, size_t start, size_t length) const {
         ML_CHECK_LT(dim, ndim(), "slice(): dim out of range");
+        ML_CHECK(length > 0, "slice(): length must be > 0 (v1 restriction)");
         ML_CHECK(start + length <= sizes_[dim], "slice(): range out of bounds");
 
         auto new_sizes = sizes_;
         new_sizes[dim] = length;
 
         size_t new_offset = offset_ + start * strides_[dim];
-        return Tensor(storage_, new_offset, std::move(new_sizes), strides_);
+        Tensor t(storage_, new_offset, std::move(new_sizes), strides_);
+        if (qparams_ && qparams_->axis == static_cast<int>(dim)) {
+            // keep only the sliced channels
+            auto sliced = std::make_shared<QuantParams>();
+            sliced->axis = qparams_->axis;
+            sliced->scale.assign(qparams_->scale.begin() + start, qparams_->scale.begin() + start + length);
+            sliced->zero_point.assign(qparams_->zero_point.begin() + start, qparams_->zero_point.begin() + start + length);
+            t.qparams_ = std::move(sliced);
+        }
+        else {
+            t.qparams_ = qparams_;
+        }
+        if (view_needs_grad_(t)) track_view(t, *this, std::make_shared<SliceBackward>(sizes_, dim, start));
+        return t;
     }
 
-    // -------- contiguous materialize --------
-    Tensor Tensor::contiguous() const {
-        if (is_contiguous()) {
-            // return an equivalent view (no copy)
-            return Tensor(storage_, offset_, sizes_, strides_);
+    Tensor Tensor::expand(const Shape& new_sizes) const {
+        ML_CHECK(new_sizes.size() >= ndim(), "expand(): cannot drop dimensions");
+        for (size_t s : new_sizes) {
+            ML_CHECK(s > 0, "expand(): dimension must be > 0 (v1 restriction)");
         }
 
-        Tensor out = empty(sizes_);
-
-        if (ndim() == 0) {
-            // scalar
-            out.storage_->data[0] = storage_->data[offset_];
-            return out;
+        const size_t lead = new_sizes.size() - ndim();
+        Shape new_strides(new_sizes.size(), 0);
+        for (size_t d = 0; d < ndim(); ++d) {
+            size_t target = new_sizes[lead + d];
+            if (sizes_[d] == target) {
+                new_strides[lead + d] = strides_[d];
+            }
+            else {
+                ML_CHECK(sizes_[d] == 1, "expand(): only size-1 dims can be expanded");
+                new_strides[lead + d] = 0;
+            }
         }
+        Tensor t(storage_, offset_, new_sizes, std::move(new_strides));
+        t.qparams_ = qparams_ && qparams_->per_channel()
+            ? move_axis(qparams_, qparams_->axis + static_cast<int>(lead))
+            : qparams_;
+        if (view_needs_grad_(t)) track_view(t, *this, std::make_shared<ExpandBackward>(sizes_));
+        return t;
+    }
 
-        std::vector<size_t> idx(ndim(), 0);
-
-        for (size_t out_lin = 0; out_lin < out.numel(); ++out_lin) {
-            out.storage_->data[out_lin] = at_vec_(idx);
-            if (!next_index_(idx, sizes_)) break;
+    // -------- contiguous materialize --------
+    Tensor Tensor::contiguous() const {
+        if (is_contiguous()) {
+            // return an equivalent view (no copy)
+            Tensor t(storage_, offset_, sizes_, strides_);
+            t.qparams_ = qparams_;
+            if (view_needs_grad_(t)) track_view(t, *this, std::make_shared<IdentityBackward>());
+            return t;
         }
+        return clone();
+    }
 
+    Tensor Tensor::clone() const {
+        Tensor out = empty(sizes_, dtype());
+        out.qparams_ = qparams_;
+        copy_elements(out, *this);
+        if (autograd::needs_grad({ this })) track_view(out, *this, std::make_shared<IdentityBackward>());
         return out;
     }
 
@@ -0,0 +1,1483 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ml/autograd/grad_mode.hpp"
+#include "ml/core/allocator.hpp"
+#include "ml/core/cpu.hpp"
+#include "ml/ops/convert.hpp"
+#include "ml/ops/elementwise.hpp"
+#include "ml/ops/expr.hpp"
+#include "ml/ops/linear.hpp"
+#include "ml/ops/loss.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/ops/norm.hpp"
+#include "ml/ops/quantize.hpp"
+#include "ml/ops/reduce.hpp"
+#include "ml/ops/softmax.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+using ml::Tensor;
+
+static void expect_throw(const char* name, const std::function<void()>& fn) {
+    try {
+        fn();
+        std::cerr << "[FAIL] Expected exception: " << name << "\n";
+        std::abort();
+    }
+    catch (const std::exception&) {
+        std::cout << "[OK]   threw: " << name << "\n";
+    }
+}
+
+static Tensor random_tensor(const std::vector<size_t>& sizes, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(ml::core::numel(sizes));
+    for (auto& x : v) x = dist(gen);
+    return Tensor::from_vector(v, sizes);
+}
+
+// plain triple loop through at(), works for any 2D view
+static Tensor matmul_ref(const Tensor& a, const Tensor& b) {
+    size_t M = a.sizes()[0], K = a.sizes()[1], N = b.sizes()[1];
+    Tensor out = Tensor::zeros({ M, N });
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            double acc = 0.0;
+            for (size_t k = 0; k < K; ++k) acc += double(a.at({ i, k })) * b.at({ k, j });
+            out.at({ i, j }) = static_cast<float>(acc);
+        }
+    }
+    return out;
+}
+
+// batched reference on 4D inputs already expanded to the same batch dims
+static Tensor matmul_ref4(const Tensor& a, const Tensor& b) {
+    size_t B0 = a.sizes()[0], B1 = a.sizes()[1];
+    size_t M = a.sizes()[2], K = a.sizes()[3], N = b.sizes()[3];
+    Tensor out = Tensor::zeros({ B0, B1, M, N });
+    for (size_t x = 0; x < B0; ++x) {
+        for (size_t y = 0; y < B1; ++y) {
+            for (size_t i = 0; i < M; ++i) {
+                for (size_t j = 0; j < N; ++j) {
+                    double acc = 0.0;
+                    for (size_t k = 0; k < K; ++k) acc += double(a.at({ x, y, i, k })) * b.at({ x, y, k, j });
+                    out.at({ x, y, i, j }) = static_cast<float>(acc);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+static bool all_close(const Tensor& x, const Tensor& y, float tol) {
+    if (x.sizes() != y.sizes()) return false;
+    for (size_t i = 0; i < x.sizes()[0]; ++i) {
+        for (size_t j = 0; j < x.sizes()[1]; ++j) {
+            float a = x.at({ i, j }), b = y.at({ i, j });
+            if (std::abs(a - b) > tol * (1.0f + std::abs(b))) return false;
+        }
+    }
+    return true;
+}
+
+// per-output double sum / max / first argmax over dims, kept dims row-major
+// (x through contiguous(), so any view works)
+struct RefReduce {
+    std::vector<double> sum, max;
+    std::vector<size_t> argmax;
+};
+
+static RefReduce reduce_ref(const Tensor& x, const std::vector<size_t>& dims) {
+    Tensor c = x.contiguous();
+    const size_t nd = x.ndim();
+    std::vector<bool> red(nd, false);
+    for (size_t d : dims) red[d] = true;
+    size_t outs = 1;
+    for (size_t d = 0; d < nd; ++d) if (!red[d]) outs *= x.sizes()[d];
+    RefReduce r{ std::vector<double>(outs, 0.0), std::vector<double>(outs, -INFINITY), std::vector<size_t>(outs, 0) };
+    std::vector<size_t> idx(nd, 0);
+    for (size_t e = 0; e < c.numel(); ++e) {
+        size_t o = 0, ri = 0;
+        for (size_t d = 0; d < nd; ++d) {
+            if (red[d]) ri = ri * x.sizes()[d] + idx[d];
+            else o = o * x.sizes()[d] + idx[d];
+        }
+        const double v = c.data()[e];
+        r.sum[o] += v;
+        if (v > r.max[o]) {
+            r.max[o] = v;
+            r.argmax[o] = ri;
+        }
+        for (size_t d = nd; d-- > 0;) {
+            if (++idx[d] < x.sizes()[d]) break;
+            idx[d] = 0;
+        }
+    }
+    return r;
+}
+
+// double log-softmax and logsumexp along dim, both in x's row-major order
+// (x through contiguous(), so any view works; lse holds one value per row)
+static void log_softmax_ref(const Tensor& x, size_t dim, std::vector<double>& logp, std::vector<double>& lse) {
+    Tensor c = x.contiguous();
+    size_t pre = 1, post = 1, n = x.sizes()[dim];
+    for (size_t d = 0; d < dim; ++d) pre *= x.sizes()[d];
+    for (size_t d = dim + 1; d < x.ndim(); ++d) post *= x.sizes()[d];
+    logp.assign(c.numel(), 0.0);
+    lse.assign(pre * post, 0.0);
+    for (size_t o = 0; o < pre; ++o) {
+        for (size_t i = 0; i < post; ++i) {
+            const float* row = c.data() + o * n * post + i;
+            double m = -INFINITY, s = 0.0;
+            for (size_t j = 0; j < n; ++j) m = std::max(m, double(row[j * post]));
+            for (size_t j = 0; j < n; ++j) s += std::exp(double(row[j * post]) - m);
+            lse[o * post + i] = m + std::log(s);
+            for (size_t j = 0; j < n; ++j) logp[o * n * post + j * post + i] = row[j * post] - lse[o * post + i];
+        }
+    }
+}
+
+// grads that backward() of sum(f() * w), w fixed random, leaves on xs
+// (contiguous leaves that require grad) against central differences
+static void check_grads(const char* name, const std::function<Tensor()>& f, const std::vector<Tensor*>& xs, float h = 1e-2f) {
+    Tensor y0 = f();
+    Tensor w = Tensor::empty(y0.sizes());
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t i = 0; i < w.numel(); ++i) w.data()[i] = dist(gen);
+
+    for (Tensor* x : xs) x->zero_grad();
+    ml::ops::sum(ml::ops::mul(f(), w)).backward();
+    auto loss = [&] {
+        Tensor y = f().contiguous();
+        double acc = 0.0;
+        for (size_t i = 0; i < y.numel(); ++i) acc += double(w.data()[i]) * y.data()[i];
+        return acc;
+    };
+    for (size_t k = 0; k < xs.size(); ++k) {
+        Tensor& x = *xs[k];
+        if (!x.has_grad()) {
+            std::cerr << "[FAIL] " << name << ": input " << k << " got no grad\n";
+            std::abort();
+        }
+        for (size_t e = 0; e < x.numel(); ++e) {
+            const float v0 = x.data()[e];
+            x.data()[e] = v0 + h;
+            const double up = loss();
+            x.data()[e] = v0 - h;
+            const double down = loss();
+            x.data()[e] = v0;
+            const double fd = (up - down) / (2.0 * h);
+            if (std::abs(x.grad().data()[e] - fd) > 5e-3 * (1.0 + std::abs(fd))) {
+                std::cerr << "[FAIL] " << name << ": input " << k << " grad " << e << ": " << x.grad().data()[e] << " vs " << fd << "\n";
+                std::abort();
+            }
+        }
+    }
+    std::cout << "[OK]   grad " << name << "\n";
+}
+
+int main() {
+    using namespace ml;
+
+    std::cout << "Running ops tests...\n";
+
+    // ---- dispatch level (ML_CPU_LEVEL forces it down for testing) ----
+    {
+        auto level = core::cpu_level();
+        assert(level <= core::detected_cpu_level());
+        if (const char* env = std::getenv("ML_CPU_LEVEL")) {
+            for (auto l : { core::CpuLevel::Scalar, core::CpuLevel::AVX2, core::CpuLevel::AVX512, core::CpuLevel::AVX512VNNI }) {
+                if (std::strcmp(env, core::cpu_level_name(l)) == 0 && l <= core::detected_cpu_level()) {
+                    assert(level == l);
+                }
+            }
+        }
+        std::cout << "[OK]   kernels: " << core::cpu_level_name(level)
+            << " (detected " << core::cpu_level_name(core::detected_cpu_level()) << ")\n";
+    }
+
+    // ---- aligned storage + vectorized zeros/ones ----
+    {
+        for (size_t n : { 1, 5, 16, 17, 63, 100, 1000, 70001 }) {
+            auto e = Tensor::empty({ n });
+            assert(reinterpret_cast<uintptr_t>(e.data()) % core::kAllocAlignment == 0);
+            auto z = Tensor::zeros({ n });
+            auto o = Tensor::ones({ n });
+            for (size_t i = 0; i < n; ++i) assert(z.data()[i] == 0.0f && o.data()[i] == 1.0f);
+        }
+        std::cout << "[OK]   aligned storage + fill\n";
+    }
+
+    // ---- matmul small exact ----
+    {
+        auto A = Tensor::from_vector({ 1,2,3,4,5,6 }, { 2,3 });
+        auto B = Tensor::from_vector({ 7,8,9,10,11,12 }, { 3,2 });
+        auto C = ops::matmul(A, B);
+        assert((C.sizes() == std::vector<size_t>{2, 2}));
+        assert(C.at({ 0,0 }) == 58.0f);
+        assert(C.at({ 0,1 }) == 64.0f);
+        assert(C.at({ 1,0 }) == 139.0f);
+        assert(C.at({ 1,1 }) == 154.0f);
+        std::cout << "[OK]   matmul 2x3 * 3x2\n";
+    }
+
+    // ---- matmul vs reference: edge tiles and multiple cache blocks ----
+    {
+        const size_t shapes[][3] = {
+            { 1, 1, 1 }, { 3, 5, 7 }, { 17, 33, 9 }, { 64, 64, 64 },
+            { 130, 300, 70 }, { 5, 600, 260 },
+        };
+        unsigned seed = 1;
+        for (auto& s : shapes) {
+            auto A = random_tensor({ s[0], s[1] }, seed++);
+            auto B = random_tensor({ s[1], s[2] }, seed++);
+            assert(all_close(ops::matmul(A, B), matmul_ref(A, B), 1e-4f));
+        }
+        std::cout << "[OK]   matmul vs reference\n";
+    }
+
+    // ---- matmul on strided views (no contiguous() needed) ----
+    {
+        auto A = random_tensor({ 40, 50 }, 11);
+        auto B = random_tensor({ 37, 40 }, 12);
+        auto At = A.transpose(0, 1);                 // [50,40]
+        auto Bt = B.transpose(0, 1);                 // [40,37]
+        assert(all_close(ops::matmul(At, Bt), matmul_ref(At, Bt), 1e-4f));
+
+        auto As = A.slice(1, 5, 20);                 // [40,20], row stride 50
+        auto Bs = random_tensor({ 20, 9 }, 13);
+        assert(all_close(ops::matmul(As, Bs), matmul_ref(As, Bs), 1e-4f));
+        std::cout << "[OK]   matmul strided views\n";
+    }
+
+    // ---- matmul: row- and column-major operands pack the same ----
+    {
+        // K spans two KC blocks, M and N leave edge panels; slices give ld > extent
+        auto a_row = random_tensor({ 41,300 }, 61);                 // csa == 1
+        auto W = random_tensor({ 53,310 }, 62);
+        auto At = random_tensor({ 310,41 }, 63);
+        auto a_col = At.slice(0, 3, 300).transpose(0, 1);           // rsa == 1
+        auto w_col = W.slice(1, 5, 300).transpose(0, 1);            // rsb == 1: linear layer
+        auto w_row = w_col.contiguous();                            // csb == 1
+        for (const Tensor* a : { &a_row, &a_col }) {
+            for (const Tensor* w : { &w_row, &w_col }) {
+                auto C = ops::matmul(*a, *w);
+                assert(all_close(C, matmul_ref(*a, *w), 1e-4f));
+            }
+        }
+        // same bits whichever way the operands are laid out
+        auto a_col_c = a_col.contiguous();
+        auto C0 = ops::matmul(a_col_c, w_row);
+        auto C1 = ops::matmul(a_col_c, w_col);
+        auto C2 = ops::matmul(a_col, w_col);
+        assert(std::memcmp(C0.data(), C1.data(), C0.numel() * sizeof(float)) == 0);
+        assert(std::memcmp(C0.data(), C2.data(), C0.numel() * sizeof(float)) == 0);
+        // 16-bit operands widen through the same line packing
+        auto Cb = ops::matmul(ops::to_dtype(a_row, DType::BFloat16), ops::to_dtype(w_row, DType::BFloat16).transpose(0, 1).contiguous().transpose(0, 1));
+        auto Cr = ops::matmul(ops::to_dtype(ops::to_dtype(a_row, DType::BFloat16), DType::Float32),
+            ops::to_dtype(ops::to_dtype(w_row, DType::BFloat16), DType::Float32));
+        assert(all_close(ops::to_dtype(Cb, DType::Float32), Cr, 1.0f / 128.0f));
+        std::cout << "[OK]   matmul row/column-major operands\n";
+    }
+
+    // ---- fused linear: bias, activation and residual in the GEMM epilogue ----
+    {
+        auto gelu_ref = [](double v) { return 0.5 * v * (1.0 + std::tanh(0.7978845608028654 * (v + 0.044715 * v * v * v))); };
+        // K spans two KC blocks (epilogue only once), M and N leave edge tiles
+        auto X = random_tensor({ 2,19,300 }, 71);
+        auto Wt = random_tensor({ 45,300 }, 72);
+        auto W = Wt.transpose(0, 1);                 // [K,N] view of an [N,K] weight
+        auto bias = random_tensor({ 45 }, 73);
+        auto R = random_tensor({ 2,19,45 }, 74);
+        auto Y = ops::matmul(X, W);                  // unfused reference pieces
+        for (auto act : { ops::Activation::None, ops::Activation::ReLU, ops::Activation::GELU }) {
+            auto F = ops::linear(X, W, bias, act);
+            auto FR = ops::linear(X, W, bias, act, R);
+            assert((F.sizes() == std::vector<size_t>{ 2,19,45 }));
+            for (size_t i = 0; i < F.numel(); ++i) {
+                double v = double(Y.data()[i]) + bias.data()[i % 45];
+                if (act == ops::Activation::ReLU) v = v > 0.0 ? v : 0.0;
+                if (act == ops::Activation::GELU) v = gelu_ref(v);
+                assert(std::abs(F.data()[i] - v) <= 1e-4 * (1.0 + std::abs(v)));
+                assert(std::abs(FR.data()[i] - (v + R.data()[i])) <= 1e-4 * (1.0 + std::abs(v)));
+            }
+        }
+        // matches the unfused ops exactly where no rounding differs
+        auto relu_ref = ops::relu(ops::add(ops::matmul(X, W), bias));
+        auto relu_fused = ops::linear(X, W, bias, ops::Activation::ReLU);
+        assert(std::memcmp(relu_ref.data(), relu_fused.data(), relu_ref.numel() * sizeof(float)) == 0);
+
+        // strided 2D inputs: transposed x, broadcast (stride 0) residual rows
+        auto Xt = random_tensor({ 300,7 }, 75).transpose(0, 1);
+        auto r_row = random_tensor({ 1,45 }, 76);
+        auto F2 = ops::linear(Xt, W, bias, ops::Activation::None, r_row.expand({ 7,45 }));
+        auto R2 = ops::add(ops::add(ops::matmul(Xt, W), bias), r_row);
+        assert(all_close(F2, R2, 1e-6f));
+
+        // GELU tails: no overflow or NaN for large |x|
+        auto big = Tensor::from_vector({ -100, -20, -5, 0, 5, 20, 100, 1e-3f }, { 8,1 });
+        auto G = ops::linear(big, Tensor::ones({ 1,1 }), Tensor::zeros({ 1 }), ops::Activation::GELU);
+        for (size_t i = 0; i < 8; ++i) {
+            double v = big.data()[i];
+            assert(std::abs(G.data()[i] - gelu_ref(v)) <= 1e-5 * (1.0 + std::abs(v)));
+        }
+        // 1D x is one row
+        auto v1 = ops::linear(random_tensor({ 300 }, 77), W, bias);
+        assert(v1.ndim() == 1 && v1.sizes()[0] == 45);
+
+        expect_throw("linear shape mismatch", [&] { (void)ops::linear(X, Wt, bias); });
+        expect_throw("linear bias size", [&] { (void)ops::linear(X, W, Tensor::zeros({ 44 })); });
+        expect_throw("linear residual shape", [&] { (void)ops::linear(X, W, bias, ops::Activation::None, Tensor::zeros({ 19,45 })); });
+        expect_throw("linear dtype", [&] { (void)ops::linear(ops::to_dtype(X, DType::BFloat16), W, bias); });
+        std::cout << "[OK]   fused linear\n";
+    }
+
+    // ---- matrix-vector and skinny shapes (M or N < 16) ----
+    {
+        for (auto [M, K, N] : { std::array<size_t,3>{ 1,300,70 }, { 3,1,40 }, { 15,77,130 }, { 70,300,1 }, { 130,65,5 }, { 2,3,2 } }) {
+            auto A = random_tensor({ M,K }, 81);
+            auto B = random_tensor({ K,N }, 82);
+            auto ref = matmul_ref(A, B);
+            auto Acm = A.transpose(0, 1).contiguous().transpose(0, 1);
+            auto Bcm = B.transpose(0, 1).contiguous().transpose(0, 1);
+            // dot-product and axpy kernels, small operand contiguous or gathered
+            for (const Tensor* a : { &A, &Acm }) {
+                for (const Tensor* b : { &B, &Bcm }) {
+                    assert(all_close(ops::matmul(*a, *b), ref, 1e-4f));
+                }
+            }
+            // fused epilogue on the skinny path
+            auto bias = random_tensor({ N }, 83);
+            auto F = ops::linear(A, Bcm, bias, ops::Activation::ReLU, ref);
+            for (size_t i = 0; i < M; ++i) {
+                for (size_t j = 0; j < N; ++j) {
+                    float v = std::max(ref.at({ i, j }) + bias.at({ j }), 0.0f) + ref.at({ i, j });
+                    assert(std::abs(F.at({ i, j }) - v) <= 1e-4f * (1.0f + std::abs(v)));
+                }
+            }
+        }
+        // large enough to split over the pool: same bits for any thread count
+        auto x = random_tensor({ 1,512 }, 84);
+        auto W = random_tensor({ 2000,512 }, 85).transpose(0, 1);
+        auto Wr = W.contiguous();
+        size_t saved = get_num_threads();
+        set_num_threads(1);
+        auto y1 = ops::matmul(x, W);
+        auto z1 = ops::matmul(x, Wr);
+        set_num_threads(4);
+        auto y4 = ops::matmul(x, W);
+        auto z4 = ops::matmul(x, Wr);
+        set_num_threads(saved);
+        assert(std::memcmp(y1.data(), y4.data(), y1.numel() * sizeof(float)) == 0);
+        assert(std::memcmp(z1.data(), z4.data(), z1.numel() * sizeof(float)) == 0);
+        assert(all_close(y1, z1, 1e-5f) && all_close(y1, matmul_ref(x, W), 1e-4f));
+        std::cout << "[OK]   skinny matmul\n";
+    }
+
+    // ---- threaded matmul: same bits for any thread count ----
+    {
+        size_t prev = get_num_threads();
+        auto A = random_tensor({ 300, 200 }, 21);
+        auto B = random_tensor({ 200, 500 }, 22);
+
+        set_num_threads(1);
+        auto C1 = ops::matmul(A, B);
+        for (size_t n : { 2, 3, 8 }) {
+            set_num_threads(n);
+            assert(get_num_threads() == n);
+            auto Cn = ops::matmul(A, B);
+            for (size_t i = 0; i < C1.numel(); ++i) assert(Cn.data()[i] == C1.data()[i]);
+        }
+        // tall-skinny: few M blocks, the N split has to provide the parallelism
+        auto T = random_tensor({ 7, 300 }, 23);
+        auto W = random_tensor({ 300, 900 }, 24);
+        assert(all_close(ops::matmul(T, W), matmul_ref(T, W), 1e-4f));
+
+        set_num_threads(prev);
+        std::cout << "[OK]   threaded matmul\n";
+    }
+
+    // ---- batched matmul: broadcasting batch dims, strided views ----
+    {
+        auto flat_close = [](const Tensor& x, const Tensor& y, float tol) {
+            if (x.sizes() != y.sizes()) return false;
+            auto xc = x.contiguous();
+            auto yc = y.contiguous();
+            for (size_t i = 0; i < xc.numel(); ++i) {
+                if (std::abs(xc.data()[i] - yc.data()[i]) > tol * (1.0f + std::abs(yc.data()[i]))) return false;
+            }
+            return true;
+        };
+        // [2,3,M,K] x [2,3,K,N], small and large per-matrix sizes
+        for (auto [M, K, N] : { std::array<size_t,3>{ 5,7,3 }, { 70,130,90 } }) {
+            auto A = random_tensor({ 2,3,M,K }, 41);
+            auto B = random_tensor({ 2,3,K,N }, 42);
+            auto C = ops::matmul(A, B);
+            assert((C.sizes() == std::vector<size_t>{ 2,3,M,N }));
+            assert(flat_close(C, matmul_ref4(A, B), 1e-4f));
+        }
+        // broadcast: [2,1,M,K] x [3,K,N] -> [2,3,M,N], and [2,3,M,K] x [K,N]
+        auto A = random_tensor({ 2,1,6,8 }, 43);
+        auto B = random_tensor({ 3,8,4 }, 44);
+        auto C = ops::matmul(A, B);
+        assert((C.sizes() == std::vector<size_t>{ 2,3,6,4 }));
+        assert(flat_close(C, matmul_ref4(A.expand({ 2,3,6,8 }), B.expand({ 2,3,8,4 })), 1e-5f));
+        auto A4 = random_tensor({ 2,3,6,8 }, 45);
+        auto W = random_tensor({ 8,4 }, 46);
+        assert(flat_close(ops::matmul(A4, W), matmul_ref4(A4, W.expand({ 2,3,8,4 })), 1e-5f));
+
+        // attention-style views: heads split by transpose, K^T as a view
+        auto Q = random_tensor({ 2,9,3,5 }, 47).transpose(1, 2);   // [2,3,9,5], strided
+        auto Kt = random_tensor({ 2,11,3,5 }, 48).transpose(1, 2).transpose(2, 3);   // [2,3,5,11]
+        auto S = ops::matmul(Q, Kt);
+        assert(flat_close(S, matmul_ref4(Q, Kt), 1e-5f));
+        assert(flat_close(ops::matmul(Q.slice(2, 2, 4), Kt), matmul_ref4(Q.slice(2, 2, 4), Kt), 1e-5f));
+
+        // bmm and the float64 / bf16 batch paths
+        auto A3 = random_tensor({ 4,6,8 }, 49);
+        auto B3 = random_tensor({ 4,8,5 }, 50);
+        auto C3 = ops::bmm(A3, B3);
+        assert(flat_close(C3, ops::matmul(A3.reshape({ 1,4,6,8 }), B3.reshape({ 1,4,8,5 })).reshape({ 4,6,5 }), 0.0f));
+        auto Cd = ops::matmul(ops::to_dtype(A3, DType::Float64), ops::to_dtype(B3, DType::Float64));
+        assert(flat_close(ops::to_dtype(Cd, DType::Float32), C3, 1e-5f));
+        auto Cb = ops::matmul(ops::to_dtype(A3, DType::BFloat16), ops::to_dtype(B3, DType::BFloat16));
+        assert(Cb.dtype() == DType::BFloat16 && flat_close(ops::to_dtype(Cb, DType::Float32), C3, 0.05f));
+
+        // same bits for any thread count (batch-parallel and gemm-parallel)
+        auto Ab = random_tensor({ 64,16,16 }, 51);
+        auto Bb = random_tensor({ 64,16,16 }, 52);
+        size_t saved = get_num_threads();
+        set_num_threads(1);
+        auto R1 = ops::bmm(Ab, Bb);
+        set_num_threads(4);
+        auto R4 = ops::bmm(Ab, Bb);
+        set_num_threads(saved);
+        assert(std::memcmp(R1.data(), R4.data(), R1.numel() * sizeof(float)) == 0);
+
+        expect_throw("bmm batch mismatch", [&] { (void)ops::bmm(A3, random_tensor({ 3,8,5 }, 53)); });
+        expect_throw("bmm non-3D", [&] { (void)ops::bmm(A4, W); });
+        expect_throw("matmul batch not broadcastable", [&] { (void)ops::matmul(A3, random_tensor({ 3,8,5 }, 53)); });
+        expect_throw("matmul batch inner mismatch", [&] { (void)ops::matmul(A3, random_tensor({ 4,7,5 }, 54)); });
+        std::cout << "[OK]   batched matmul\n";
+    }
+
+    // ---- elementwise ----
+    {
+        auto a = Tensor::from_vector({ 1,-2,3,-4 }, { 2,2 });
+        auto b = Tensor::from_vector({ 5,6,7,8 }, { 2,2 });
+        auto s = ops::add(a, b);
+        auto d = ops::sub(a, b);
+        auto m = ops::mul(a, b);
+        auto r = ops::relu(a);
+        assert(s.at({ 1,1 }) == 4.0f);
+        assert(d.at({ 0,1 }) == -8.0f);
+        assert(m.at({ 1,0 }) == 21.0f);
+        assert(r.at({ 0,1 }) == 0.0f && r.at({ 1,0 }) == 3.0f);
+        std::cout << "[OK]   elementwise\n";
+    }
+
+    // ---- elementwise: every vector-width tail ----
+    {
+        for (size_t n = 1; n <= 150; ++n) {
+            auto a = random_tensor({ n }, 100 + unsigned(n));
+            auto b = random_tensor({ n }, 300 + unsigned(n));
+            auto s = ops::add(a, b);
+            auto d = ops::sub(a, b);
+            auto m = ops::mul(a, b);
+            auto r = ops::relu(a);
+            for (size_t i = 0; i < n; ++i) {
+                float x = a.at({ i }), y = b.at({ i });
+                assert(s.at({ i }) == x + y);
+                assert(d.at({ i }) == x - y);
+                assert(m.at({ i }) == x * y);
+                assert(r.at({ i }) == (x > 0.0f ? x : 0.0f));
+            }
+        }
+        std::cout << "[OK]   elementwise tails\n";
+    }
+
+    // ---- broadcasting ----
+    {
+        auto x = random_tensor({ 4, 37 }, 31);
+        auto bias = random_tensor({ 37 }, 32);     // row bias, last dim contiguous on both
+        auto colv = random_tensor({ 4, 1 }, 33);   // column broadcast, inner stride 0
+        auto row = random_tensor({ 1, 37 }, 34);
+
+        auto s = ops::add(x, bias);
+        auto d = ops::sub(x, colv);
+        auto m = ops::mul(colv, row);              // outer product [4,1] * [1,37]
+        assert((m.sizes() == std::vector<size_t>{4, 37}));
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t j = 0; j < 37; ++j) {
+                assert(s.at({ i,j }) == x.at({ i,j }) + bias.at({ j }));
+                assert(d.at({ i,j }) == x.at({ i,j }) - colv.at({ i,0 }));
+                assert(m.at({ i,j }) == colv.at({ i,0 }) * row.at({ 0,j }));
+            }
+        }
+
+        // rank-3 with a broadcast middle dim, plus a 0-d scalar operand
+        auto t = random_tensor({ 3, 1, 5 }, 35);
+        auto u = random_tensor({ 4, 5 }, 36);
+        auto tu = ops::add(t, u);
+        assert((tu.sizes() == std::vector<size_t>{3, 4, 5}));
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 4; ++j)
+                for (size_t k = 0; k < 5; ++k)
+                    assert(tu.at({ i,j,k }) == t.at({ i,0,k }) + u.at({ j,k }));
+
+        auto two = Tensor::from_vector({ 2.0f }, {});
+        auto x2 = ops::mul(x, two);
+        assert(x2.at({ 3,36 }) == 2.0f * x.at({ 3,36 }));
+
+        // large enough to split rows across the pool
+        auto big = random_tensor({ 2000, 300 }, 37);
+        auto bb = random_tensor({ 300 }, 38);
+        auto sb = ops::add(big, bb);
+        assert(sb.at({ 1999, 299 }) == big.at({ 1999, 299 }) + bb.at({ 299 }));
+        assert(sb.at({ 1234, 17 }) == big.at({ 1234, 17 }) + bb.at({ 17 }));
+        std::cout << "[OK]   broadcasting\n";
+    }
+
+    // ---- elementwise on non-contiguous views ----
+    {
+        auto A = random_tensor({ 33, 70 }, 41);
+        auto B = random_tensor({ 70, 33 }, 42);
+        auto At = A.transpose(0, 1);               // [70,33]
+        auto Bs = B.slice(1, 3, 20);               // [70,20], row stride 33
+        auto As = At.slice(1, 10, 20);             // [70,20], transposed + offset
+
+        auto s = ops::add(At, B);
+        auto m = ops::mul(As, Bs);
+        auto r = ops::relu(At);
+        auto d = ops::sub(Bs, ops::relu(As));
+        for (size_t i = 0; i < 70; ++i) {
+            for (size_t j = 0; j < 33; ++j) {
+                assert(s.at({ i,j }) == At.at({ i,j }) + B.at({ i,j }));
+                float v = At.at({ i,j });
+                assert(r.at({ i,j }) == (v > 0.0f ? v : 0.0f));
+            }
+            for (size_t j = 0; j < 20; ++j) {
+                assert(m.at({ i,j }) == As.at({ i,j }) * Bs.at({ i,j }));
+                float v = As.at({ i,j });
+                assert(d.at({ i,j }) == Bs.at({ i,j }) - (v > 0.0f ? v : 0.0f));
+            }
+        }
+
+        // large transposed input split across the pool, rows cut mid-way
+        auto X = random_tensor({ 517, 311 }, 43);
+        auto Xt = X.transpose(0, 1);
+        auto Y = ops::add(Xt, Xt);
+        for (size_t i = 0; i < 311; i += 7)
+            for (size_t j = 0; j < 517; j += 5)
+                assert(Y.at({ i,j }) == 2.0f * X.at({ j,i }));
+        std::cout << "[OK]   elementwise on views\n";
+    }
+
+    // ---- fused expressions match the op-by-op result ----
+    {
+        auto a = random_tensor({ 64, 100 }, 51);
+        auto w = random_tensor({ 64, 100 }, 52);
+        auto b = random_tensor({ 100 }, 53);     // broadcast bias
+
+        auto ref = ops::relu(ops::add(ops::mul(a, w), b));
+        auto fused = expr::eval(expr::relu(expr::add(expr::mul(a, w), b)));
+        assert((fused.sizes() == ref.sizes()));
+        for (size_t i = 0; i < ref.numel(); ++i) assert(fused.data()[i] == ref.data()[i]);
+
+        // operators, scalar constants and a transposed leaf
+        auto at = a.transpose(0, 1);               // [100,64]
+        auto wt = w.transpose(0, 1);
+        auto y = expr::eval(expr::mul(at, wt) * 2.0f - expr::relu(at) + 1.0f);
+        for (size_t i = 0; i < 100; i += 3) {
+            for (size_t j = 0; j < 64; j += 5) {
+                float x = at.at({ i,j }), v = wt.at({ i,j });
+                float expect = ((x * v) * 2.0f - (x > 0.0f ? x : 0.0f)) + 1.0f;
+                assert(y.at({ i,j }) == expect);
+            }
+        }
+
+        auto c = expr::eval(expr::add(Tensor::ones({ 3 }), 2.0f));
+        assert(c.at({ 2 }) == 3.0f);
+        std::cout << "[OK]   fused expressions\n";
+    }
+
+    // ---- fp32 <-> bf16/fp16: SIMD kernels match the scalar conversions ----
+    {
+        using namespace ml::core;
+        std::vector<float> v = { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 65520.0f, 1e-5f, 6e-8f, 2.9e-8f,
+            1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 3.0e38f, INFINITY, -INFINITY, NAN };
+        std::mt19937 gen(9);
+        std::uniform_real_distribution<float> dist(-300.0f, 300.0f);
+        while (v.size() < 67) v.push_back(dist(gen));   // 67: full vectors plus a tail
+
+        auto x = Tensor::from_vector(v, { v.size() });
+        auto xb = ops::to_dtype(x, DType::BFloat16);
+        auto xh = ops::to_dtype(x, DType::Float16);
+        assert(xb.dtype() == DType::BFloat16 && xh.dtype() == DType::Float16 && xb.element_size() == 2);
+        auto back_b = ops::to_dtype(xb, DType::Float32);
+        auto back_h = ops::to_dtype(xh, DType::Float32);
+        for (size_t i = 0; i < v.size(); ++i) {
+            assert(xb.data_as<BFloat16>()[i].bits == float_to_bf16_bits(v[i]));
+            assert(xh.data_as<Half>()[i].bits == float_to_half_bits(v[i]));
+            float rb = bf16_bits_to_float(float_to_bf16_bits(v[i]));
+            float rh = half_bits_to_float(float_to_half_bits(v[i]));
+            assert(std::memcmp(&back_b.data()[i], &rb, 4) == 0);
+            assert(std::memcmp(&back_h.data()[i], &rh, 4) == 0);
+        }
+        // rounding: ties to even, overflow to inf, subnormal halves
+        assert(half_bits_to_float(float_to_half_bits(1.0f + 1.0f / 2048.0f)) == 1.0f);
+        assert(half_bits_to_float(float_to_half_bits(1.0f + 3.0f / 2048.0f)) == 1.0f + 2.0f / 1024.0f);
+        assert(std::isinf(half_bits_to_float(float_to_half_bits(65520.0f))));
+        assert(half_bits_to_float(float_to_half_bits(6e-8f)) == std::ldexp(1.0f, -24));
+        assert(std::isnan(bf16_bits_to_float(float_to_bf16_bits(NAN))));
+        std::cout << "[OK]   fp32 <-> bf16/fp16\n";
+    }
+
+    // ---- other conversions: strided source, saturation ----
+    {
+        using ml::DType;
+        auto x = Tensor::from_vector({ -1.5f, 2.7f, 300.0f, -300.0f, 7.0f, NAN }, { 2,3 });
+        auto i8 = ops::to_dtype(x.transpose(0, 1), DType::Int8);   // [3,2] from a view
+        const int8_t* p = i8.data_as<int8_t>();
+        int8_t want[6] = { -1, -128, 2, 7, 127, 0 };
+        for (int i = 0; i < 6; ++i) assert(p[i] == want[i]);
+        assert(ops::to_dtype(x, DType::Int32).data_as<int32_t>()[3] == -300);
+
+        auto d = ops::to_dtype(ops::to_dtype(x, DType::Float64), DType::Float32);
+        assert(d.at({ 1,1 }) == 7.0f);
+        auto same = ops::to_dtype(x, DType::Float32);
+        assert(same.storage_ptr() == x.storage_ptr());
+        std::cout << "[OK]   dtype conversions\n";
+    }
+
+    // ---- elementwise on every dtype ----
+    {
+        using ml::DType;
+        auto a = Tensor::from_vector({ 1, -2, 3, -4, 5, 6 }, { 2,3 });   // exact in bf16
+        auto b = Tensor::from_vector({ 10, 20, 30 }, { 3 });
+        auto want = ops::relu(ops::add(ops::mul(a, b), a));
+        for (DType dt : { DType::Float64, DType::Float16, DType::BFloat16, DType::Int32 }) {
+            auto ad = ops::to_dtype(a, dt);
+            auto bd = ops::to_dtype(b, dt);
+            auto r = ops::relu(ops::add(ops::mul(ad, bd), ad));
+            assert(r.dtype() == dt);
+            auto rf = ops::to_dtype(r, DType::Float32);
+            for (size_t i = 0; i < 2; ++i)
+                for (size_t j = 0; j < 3; ++j) assert(rf.at({ i,j }) == want.at({ i,j }));
+        }
+        // int8 wraps: 120 + 10 = -126
+        auto c = ops::add(ops::to_dtype(Tensor::from_vector({ 120 }, { 1 }), DType::Int8),
+            ops::to_dtype(Tensor::from_vector({ 10 }, { 1 }), DType::Int8));
+        assert(c.data_as<int8_t>()[0] == -126);
+        expect_throw("add dtype mismatch", [&] { (void)ops::add(a, ops::to_dtype(a, DType::Float64)); });
+        std::cout << "[OK]   elementwise dtypes\n";
+    }
+
+    // ---- matmul: bf16/fp16 accumulate in fp32, fp64 ----
+    {
+        using ml::DType;
+        auto A = random_tensor({ 67,300 }, 21);
+        auto B = random_tensor({ 300,45 }, 22);
+        for (DType dt : { DType::BFloat16, DType::Float16 }) {
+            // reference on the already-rounded inputs, so only accumulation differs
+            auto Ar = ops::to_dtype(ops::to_dtype(A, dt), DType::Float32);
+            auto Br = ops::to_dtype(ops::to_dtype(B, dt), DType::Float32);
+            auto ref = matmul_ref(Ar, Br);
+            auto Ad = ops::to_dtype(A, dt);
+            auto Bd = ops::to_dtype(B, dt);
+            auto Acm = Ad.transpose(0, 1).contiguous().transpose(0, 1);   // column-major views
+            auto Bcm = Bd.transpose(0, 1).contiguous().transpose(0, 1);
+            // one final rounding: 2^-8 relative for bf16, 2^-11 for fp16
+            float tol = dt == DType::BFloat16 ? 1.0f / 128.0f : 1.0f / 1024.0f;
+            // both layouts: unit-stride runs (SIMD widening) and strided runs in packing
+            auto C1 = ops::matmul(Ad, Bcm);
+            auto C2 = ops::matmul(Acm, Bd);
+            assert(C1.dtype() == dt && C2.dtype() == dt);
+            assert(all_close(ops::to_dtype(C1, DType::Float32), ref, tol));
+            assert(all_close(ops::to_dtype(C2, DType::Float32), ref, tol));
+        }
+        auto Cd = ops::matmul(ops::to_dtype(A, DType::Float64), ops::to_dtype(B, DType::Float64));
+        assert(Cd.dtype() == DType::Float64);
+        assert(all_close(ops::to_dtype(Cd, DType::Float32), matmul_ref(A, B), 1e-6f));
+        expect_throw("matmul int32", [&] { (void)ops::matmul(ops::to_dtype(A, DType::Int32), ops::to_dtype(B, DType::Int32)); });
+        expect_throw("matmul dtype mismatch", [&] { (void)ops::matmul(A, ops::to_dtype(B, DType::BFloat16)); });
+        std::cout << "[OK]   matmul dtypes\n";
+    }
+
+    // ---- quantize / dequantize round trip, per tensor and per channel ----
+    {
+        using ml::DType;
+        auto X = random_tensor({ 6,35 }, 31);
+        for (int axis : { -1, 0, 1 }) {
+            for (DType dt : { DType::UInt8, DType::Int8 }) {
+                auto qp = ops::choose_qparams(X, dt, axis);
+                auto Q = ops::quantize(X, dt, qp);
+                assert(Q.dtype() == dt && Q.is_quantized() && Q.qparams() == qp);
+                if (dt == DType::Int8) {
+                    for (int32_t z : qp->zero_point) assert(z == 0);
+                }
+                auto D = ops::dequantize(Q);
+                for (size_t i = 0; i < 6; ++i) {
+                    for (size_t j = 0; j < 35; ++j) {
+                        float s = qp->scale_at(axis == 0 ? i : j);
+                        assert(std::abs(D.at({ i, j }) - X.at({ i, j })) <= 0.5f * s + 1e-6f);
+                    }
+                }
+            }
+        }
+        // zero stays exact, all-zero channels get scale 1
+        auto Z = Tensor::from_vector({ 0, 0, -1, 2 }, { 2,2 });
+        auto qz = ops::choose_qparams(Z, DType::UInt8, 0);
+        assert(qz->scale[0] == 1.0f && qz->zero_point[0] == 0);
+        assert(ops::dequantize(ops::quantize(Z, DType::UInt8, qz)).at({ 1, 0 }) != 0.0f);
+        auto q7 = ops::choose_qparams(X, DType::UInt8, -1, true);
+        auto Q7 = ops::quantize(X, DType::UInt8, q7);
+        for (size_t i = 0; i < Q7.numel(); ++i) assert(Q7.data_as<uint8_t>()[i] <= 127);
+        // NaN quantizes to the zero point, infinities saturate
+        auto N = Tensor::from_vector({ std::nanf(""), 1.0f, INFINITY, -INFINITY }, { 4 });
+        auto qn = std::make_shared<ml::QuantParams>();
+        qn->scale = { 0.5f };
+        qn->zero_point = { 7 };
+        auto QN = ops::quantize(N, DType::UInt8, qn);
+        assert(QN.data_as<uint8_t>()[0] == 7 && QN.data_as<uint8_t>()[1] == 9);
+        assert(QN.data_as<uint8_t>()[2] == 255 && QN.data_as<uint8_t>()[3] == 0);
+        assert(ops::quantize(N, DType::Int8, qn).data_as<int8_t>()[0] == 7);
+        std::cout << "[OK]   quantize round trip\n";
+    }
+
+    // ---- qparams follow views ----
+    {
+        using ml::DType;
+        auto W = random_tensor({ 4,5,6 }, 32);
+        auto Q = ops::quantize(W, DType::Int8, ops::choose_qparams(W, DType::Int8, 1));
+        assert(Q.transpose(0, 1).qparams()->axis == 0);
+        auto S = Q.slice(1, 1, 2);
+        assert(S.qparams()->axis == 1 && S.qparams()->scale.size() == 2);
+        assert(S.qparams()->scale[0] == Q.qparams()->scale[1]);
+        assert(Q.slice(2, 0, 3).qparams() == Q.qparams());
+        assert(Q.transpose(0, 2).contiguous().qparams()->axis == 1);
+        assert(Q.expand({ 2,4,5,6 }).qparams()->axis == 2);
+        auto D1 = ops::dequantize(Q.transpose(1, 2));
+        auto D2 = ops::dequantize(Q).transpose(1, 2).contiguous();
+        for (size_t i = 0; i < D1.numel(); ++i) assert(D1.data()[i] == D2.data()[i]);
+        expect_throw("reshape per-channel", [&] { (void)Q.reshape({ 20,6 }); });
+        auto P = ops::quantize(W, DType::Int8, ops::choose_qparams(W, DType::Int8));
+        assert(P.reshape({ 20,6 }).qparams() == P.qparams());
+        std::cout << "[OK]   qparams on views\n";
+    }
+
+    // ---- quantized gemm: exact int32 sums, every tile edge, both kernels ----
+    {
+        using ml::DType;
+        auto unit = std::make_shared<QuantParams>();
+        unit->scale = { 1.0f };
+        unit->zero_point = { 0 };
+        std::mt19937 gen(33);
+        for (int amax : { 127, 255 }) {   // 255 exercises the full-range path without VNNI
+            for (auto [M, N, K] : { std::array<size_t,3>{ 1,1,1 }, { 5,17,3 }, { 37,45,300 }, { 130,70,1100 } }) {
+                std::vector<float> av(M * K), bv(K * N);
+                std::uniform_int_distribution<int> da(0, amax), db(-128, 127);
+                for (auto& v : av) v = float(da(gen));
+                for (auto& v : bv) v = float(db(gen));
+                auto A = ops::to_dtype(Tensor::from_vector(av, { M,K }), DType::UInt8);
+                A.set_qparams(unit);
+                // B as a transposed view: strided packing
+                auto B = ops::to_dtype(Tensor::from_vector(bv, { N,K }), DType::Int8).transpose(0, 1);
+                B.set_qparams(unit);
+                auto C = ops::quantized_matmul(A, B);
+                for (size_t i = 0; i < M; ++i) {
+                    for (size_t j = 0; j < N; ++j) {
+                        int64_t ref = 0;
+                        for (size_t k = 0; k < K; ++k) ref += int64_t(av[i * K + k]) * int64_t(bv[j * K + k]);
+                        assert(C.at({ i, j }) == float(ref));
+                    }
+                }
+            }
+        }
+        std::cout << "[OK]   quantized gemm exact\n";
+    }
+
+    // ---- quantized_matmul vs fp32 matmul ----
+    {
+        using ml::DType;
+        auto A = random_tensor({ 67,300 }, 34);
+        auto W = random_tensor({ 300,45 }, 35);
+        auto ref = matmul_ref(A, W);
+        for (bool reduce : { false, true }) {
+            for (int axis : { -1, 1 }) {
+                auto qa = ops::quantize(A, DType::UInt8, ops::choose_qparams(A, DType::UInt8, -1, reduce));
+                auto qw = ops::quantize(W, DType::Int8, ops::choose_qparams(W, DType::Int8, axis));
+                auto C = ops::quantized_matmul(qa, qw);
+                // exact up to the float epilogue against the dequantized operands
+                assert(all_close(C, matmul_ref(ops::dequantize(qa), ops::dequantize(qw)), 1e-5f));
+                // and within quantization noise of fp32
+                double err = 0.0, norm = 0.0;
+                for (size_t i = 0; i < C.numel(); ++i) {
+                    err += double(C.data()[i] - ref.data()[i]) * (C.data()[i] - ref.data()[i]);
+                    norm += double(ref.data()[i]) * ref.data()[i];
+                }
+                assert(std::sqrt(err / norm) < (reduce ? 0.03 : 0.02));
+
+                // requantized output: same as quantizing the float result (ties may differ by one)
+                auto qo = ops::choose_qparams(C, DType::UInt8);
+                auto Q = ops::quantized_matmul(qa, qw, qo);
+                auto Qr = ops::quantize(C, DType::UInt8, qo);
+                assert(Q.dtype() == DType::UInt8 && Q.qparams() == qo);
+                for (size_t i = 0; i < Q.numel(); ++i) {
+                    assert(std::abs(int(Q.data_as<uint8_t>()[i]) - int(Qr.data_as<uint8_t>()[i])) <= 1);
+                }
+            }
+        }
+        auto qa = ops::quantize(A, DType::UInt8, ops::choose_qparams(A, DType::UInt8));
+        auto qw = ops::quantize(W, DType::Int8, ops::choose_qparams(W, DType::Int8, 1));
+        expect_throw("quantized_matmul float input", [&] { (void)ops::quantized_matmul(A, qw); });
+        expect_throw("quantized_matmul swapped dtypes", [&] { (void)ops::quantized_matmul(qw, qa); });
+        // ranks are checked before the output is sized from them
+        auto v1 = Tensor::ones({ 300 });
+        auto q1 = ops::quantize(v1, DType::Int8, ops::choose_qparams(v1, DType::Int8));
+        expect_throw("quantized_matmul 1D b", [&] { (void)ops::quantized_matmul(qa, q1); });
+        expect_throw("quantized_matmul 1D b requantized", [&] { (void)ops::quantized_matmul(qa, q1, qa.qparams()); });
+        expect_throw("quantized_matmul per-row weights", [&] {
+            (void)ops::quantized_matmul(qa, ops::quantize(W, DType::Int8, ops::choose_qparams(W, DType::Int8, 0)));
+            });
+        // a zero output scale: 0 / 0 requantizes to the zero point, not UB
+        auto qz = std::make_shared<QuantParams>();
+        qz->scale = { 0.0f };
+        qz->zero_point = { 3 };
+        auto Z = ops::quantize(Tensor::zeros({ 2, 300 }), DType::UInt8, qa.qparams());
+        auto QZ = ops::quantized_matmul(Z, qw, qz);
+        for (size_t i = 0; i < QZ.numel(); ++i) assert(QZ.data_as<uint8_t>()[i] == 3);
+        expect_throw("quantize float32", [&] { (void)ops::quantize(A, DType::Float32, qa.qparams()); });
+        expect_throw("dequantize unquantized", [&] { (void)ops::dequantize(A); });
+        expect_throw("qparams on float", [&] { Tensor t = Tensor::zeros({ 2 }); t.set_qparams(qa.qparams()); });
+        std::cout << "[OK]   quantized matmul\n";
+    }
+
+    // ---- reductions: dims, keepdim, views, both loop layouts ----
+    {
+        auto X = random_tensor({ 6, 37, 129 }, 61);
+        auto XT = X.transpose(0, 2);   // [129, 37, 6] view
+        for (const Tensor* t : { &X, &XT }) {
+            std::vector<std::vector<size_t>> cases = { { 0 }, { 1 }, { 2 }, { 0, 1 }, { 0, 2 }, { 1, 2 }, { 0, 1, 2 } };
+            for (const auto& dims : cases) {
+                RefReduce ref = reduce_ref(*t, dims);
+                Tensor S = ops::sum(*t, dims);
+                Tensor M = ops::mean(*t, dims, true);
+                Tensor Mx = ops::max(*t, dims);
+                assert(S.ndim() == t->ndim() - dims.size());
+                assert(M.ndim() == t->ndim());
+                for (size_t d : dims) assert(M.sizes()[d] == 1);
+                size_t count = t->numel() / S.numel();
+                for (size_t o = 0; o < S.numel(); ++o) {
+                    assert(std::abs(S.data()[o] - ref.sum[o]) < 1e-3);
+                    assert(std::abs(M.data()[o] - ref.sum[o] / double(count)) < 1e-5);
+                    assert(Mx.data()[o] == float(ref.max[o]));
+                }
+                if (dims.size() == 1) {
+                    Tensor A = ops::argmax(*t, dims[0]);
+                    assert(A.dtype() == DType::Int32);
+                    for (size_t o = 0; o < A.numel(); ++o) assert(size_t(A.data_as<int32_t>()[o]) == ref.argmax[o]);
+                }
+            }
+        }
+        // whole tensor: 0-d results
+        RefReduce all = reduce_ref(X, { 0, 1, 2 });
+        Tensor S = ops::sum(X);
+        assert(S.ndim() == 0 && S.numel() == 1);
+        assert(std::abs(S.data()[0] - all.sum[0]) < 1e-3);
+        assert(size_t(ops::argmax(XT).data_as<int32_t>()[0]) == reduce_ref(XT, { 0, 1, 2 }).argmax[0]);
+        assert(ops::sum(X, 1, true).sizes() == (Shape{ 6, 1, 129 }));
+
+        auto small = Tensor::from_vector({ 3, -1, 3, 2, 5, 5 }, { 2, 3 });
+        assert(ops::min(small).data()[0] == -1.0f);
+        assert(ops::argmin(small).data_as<int32_t>()[0] == 1);
+        assert(ops::argmax(small, 1).data_as<int32_t>()[0] == 0);   // ties: first index
+        assert(ops::argmax(small, 1).data_as<int32_t>()[1] == 1);
+        assert(ops::prod(small, 0).data()[1] == -5.0f);
+        std::cout << "[OK]   reductions\n";
+    }
+
+    // ---- reductions: chunked, NaN, dtypes, thread-count independence ----
+    {
+        using ml::DType;
+        size_t prev = get_num_threads();
+        auto L = random_tensor({ 3, 100003 }, 62);     // several chunks per row
+        auto C = random_tensor({ 1000, 67 }, 63);      // column reduction over 4 row chunks
+        set_num_threads(1);
+        Tensor l1 = ops::sum(L, 1), la = ops::sum(L), c1 = ops::sum(C, 0), cm = ops::max(C, 0);
+        Tensor ca = ops::argmin(C, 0);
+        for (size_t n : { 2, 3, 8 }) {
+            set_num_threads(n);
+            Tensor ln = ops::sum(L, 1), lan = ops::sum(L), cn = ops::sum(C, 0), cmn = ops::max(C, 0);
+            Tensor can = ops::argmin(C, 0);
+            for (size_t i = 0; i < 3; ++i) assert(ln.data()[i] == l1.data()[i]);
+            assert(lan.data()[0] == la.data()[0]);
+            for (size_t i = 0; i < 67; ++i) {
+                assert(cn.data()[i] == c1.data()[i] && cmn.data()[i] == cm.data()[i]);
+                assert(can.data_as<int32_t>()[i] == ca.data_as<int32_t>()[i]);
+            }
+        }
+        set_num_threads(prev);
+        RefReduce lr = reduce_ref(L, { 1 }), cr = reduce_ref(C, { 0 });
+        for (size_t i = 0; i < 3; ++i) assert(std::abs(l1.data()[i] - lr.sum[i]) < 1e-2);
+        for (size_t i = 0; i < 67; ++i) {
+            assert(std::abs(c1.data()[i] - cr.sum[i]) < 1e-3 && cm.data()[i] == float(cr.max[i]));
+        }
+
+        // NaN propagates through max/min and is what argmax finds, at every tail length
+        for (size_t n : { 1, 7, 8, 17, 33, 64, 100 }) {
+            std::vector<float> v(n, 1.0f);
+            v[n / 2] = NAN;
+            auto t = Tensor::from_vector(v, { n });
+            assert(std::isnan(ops::max(t).data()[0]) && std::isnan(ops::min(t).data()[0]));
+            assert(ops::argmax(t).data_as<int32_t>()[0] == int32_t(n / 2));
+            auto col = Tensor::from_vector(v, { n, 1 }).expand({ n, 9 });
+            assert(std::isnan(ops::max(col, 0).data()[8]));
+        }
+
+        // other dtypes compute in compute_t
+        auto I = ops::to_dtype(Tensor::from_vector({ 1, 2, 3, 4, 5, 6 }, { 2, 3 }), DType::Int32);
+        auto Is = ops::sum(I, 0);
+        assert(Is.dtype() == DType::Int32 && Is.data_as<int32_t>()[2] == 9);
+        assert(ops::max(I).data_as<int32_t>()[0] == 6);
+        auto B = ops::to_dtype(C, DType::BFloat16);
+        auto Bm = ops::mean(B, 1);
+        assert(Bm.dtype() == DType::BFloat16);
+        auto D = ops::to_dtype(C, DType::Float64);
+        auto Dm = ops::mean(D, 1);
+        for (size_t i = 0; i < 1000; ++i) {
+            assert(std::abs(float(Bm.data_as<ml::core::BFloat16>()[i]) - Dm.data_as<double>()[i]) < 2e-2);
+        }
+
+        expect_throw("sum dim out of range", [&] { (void)ops::sum(C, 2); });
+        expect_throw("sum dim listed twice", [&] { (void)ops::sum(C, { 0, 0 }); });
+        expect_throw("sum no dims", [&] { (void)ops::sum(C, std::vector<size_t>{}); });
+        expect_throw("mean of int32", [&] { (void)ops::mean(I); });
+        std::cout << "[OK]   reductions chunked / NaN / dtypes\n";
+    }
+
+    // ---- softmax / log_softmax / logsumexp: every dim, views, extremes ----
+    {
+        auto X = random_tensor({ 5, 37, 19 }, 71);
+        for (size_t i = 0; i < X.numel(); ++i) X.data()[i] *= 8.0f;
+        auto XT = X.transpose(0, 2);   // [19, 37, 5] view
+        for (const Tensor* t : { &X, &XT }) {
+            for (size_t dim = 0; dim < 3; ++dim) {
+                std::vector<double> logp, lse;
+                log_softmax_ref(*t, dim, logp, lse);
+                Tensor P = ops::softmax(*t, dim).contiguous();
+                Tensor L = ops::log_softmax(*t, dim).contiguous();
+                Tensor S = ops::logsumexp(*t, dim);
+                assert(P.sizes() == t->sizes() && S.ndim() == 2);
+                for (size_t e = 0; e < P.numel(); ++e) {
+                    assert(std::abs(P.data()[e] - std::exp(logp[e])) < 1e-6);
+                    assert(std::abs(L.data()[e] - logp[e]) < 1e-4);
+                }
+                for (size_t r = 0; r < S.numel(); ++r) assert(std::abs(S.data()[r] - lse[r]) < 1e-4);
+                assert(ops::logsumexp(*t, dim, true).sizes()[dim] == 1);
+            }
+        }
+
+        // every tail length; huge logits neither overflow nor underflow the
+        // sum, -inf gives exactly 0, NaN poisons its row only
+        for (size_t n = 1; n <= 70; ++n) {
+            std::vector<float> v(2 * n);
+            for (size_t j = 0; j < n; ++j) {
+                v[j] = 1000.0f - float(j % 5);
+                v[n + j] = -1000.0f + float(j % 3);
+            }
+            auto t = Tensor::from_vector(v, { 2, n });
+            std::vector<double> logp, lse;
+            log_softmax_ref(t, 1, logp, lse);
+            Tensor P = ops::softmax(t, 1), L = ops::log_softmax(t, 1), S = ops::logsumexp(t, 1);
+            for (size_t e = 0; e < 2 * n; ++e) {
+                assert(std::abs(P.data()[e] - std::exp(logp[e])) < 1e-6);
+                assert(std::abs(L.data()[e] - logp[e]) < 1e-3);
+            }
+            assert(std::abs(S.data()[0] - lse[0]) < 1e-3 && std::abs(S.data()[1] - lse[1]) < 1e-3);
+
+            if (n == 1) continue;
+            v.assign(2 * n, 0.5f);
+            v[n - 1] = -INFINITY;
+            v[n + n / 2] = NAN;
+            t = Tensor::from_vector(v, { 2, n });
+            P = ops::softmax(t, 1);
+            L = ops::log_softmax(t, 1);
+            assert(P.data()[n - 1] == 0.0f && L.data()[n - 1] == -INFINITY);
+            assert(std::abs(P.data()[0] - 1.0f / float(n - 1)) < 1e-6);
+            for (size_t j = 0; j < n; ++j) assert(std::isnan(P.data()[n + j]) && std::isnan(L.data()[n + j]));
+            assert(std::isnan(ops::logsumexp(t, 1).data()[1]));
+        }
+
+        expect_throw("softmax dim out of range", [&] { (void)ops::softmax(X, 3); });
+        expect_throw("softmax of int32", [&] { (void)ops::softmax(ops::to_dtype(X, DType::Int32), 0); });
+        std::cout << "[OK]   softmax / log_softmax / logsumexp\n";
+    }
+
+    // ---- softmax family backward: finite differences, graph, accumulation ----
+    {
+        // d(sum(w * f(x)))/dx against central differences in double
+        auto check_grad = [&](const char* name, size_t dim, const std::function<Tensor(const Tensor&)>& f) {
+            auto X = random_tensor({ 3, 6, 4 }, 72);
+            X.set_requires_grad(true);
+            Tensor Y = f(X);
+            auto W = random_tensor(std::vector<size_t>(Y.sizes().begin(), Y.sizes().end()), 73);
+            assert(Y.requires_grad() && Y.grad_fn());
+            Y.grad_fn()->backward(W);
+            Tensor G = X.grad().contiguous();
+            auto loss = [&](const Tensor& x) {
+                Tensor y = f(x.detach()).contiguous();
+                double acc = 0.0;
+                for (size_t i = 0; i < y.numel(); ++i) acc += double(W.data()[i]) * y.data()[i];
+                return acc;
+            };
+            for (size_t e = 0; e < X.numel(); ++e) {
+                const float x0 = X.data()[e], h = 1e-2f;
+                X.data()[e] = x0 + h;
+                const double up = loss(X);
+                X.data()[e] = x0 - h;
+                const double down = loss(X);
+                X.data()[e] = x0;
+                const double fd = (up - down) / (2.0 * h);
+                if (std::abs(G.data()[e] - fd) > 2e-3 * (1.0 + std::abs(fd))) {
+                    std::cerr << "[FAIL] " << name << " dim " << dim << " grad " << e << ": " << G.data()[e] << " vs " << fd << "\n";
+                    std::abort();
+                }
+            }
+        };
+        for (size_t dim = 0; dim < 3; ++dim) {
+            check_grad("softmax", dim, [dim](const Tensor& x) { return ops::softmax(x, dim); });
+            check_grad("log_softmax", dim, [dim](const Tensor& x) { return ops::log_softmax(x, dim); });
+            check_grad("logsumexp", dim, [dim](const Tensor& x) { return ops::logsumexp(x, dim); });
+            check_grad("logsumexp keepdim", dim, [dim](const Tensor& x) { return ops::logsumexp(x, dim, true); });
+        }
+
+        // Tensor::backward through a chain: d logsumexp(log_softmax(x)) = 0,
+        // d logsumexp(x) = softmax(x), and leaf grads accumulate over calls
+        auto x = random_tensor({ 41 }, 74);
+        x.set_requires_grad(true);
+        Tensor p = ops::softmax(x, 0);
+        Tensor lse = ops::logsumexp(x, 0);
+        assert(lse.ndim() == 0);
+        lse.backward();
+        for (size_t i = 0; i < 41; ++i) assert(std::abs(x.grad().data()[i] - p.data()[i]) < 1e-6);
+        Tensor chained = ops::logsumexp(ops::log_softmax(x, 0), 0);
+        chained.backward();
+        for (size_t i = 0; i < 41; ++i) assert(std::abs(x.grad().data()[i] - p.data()[i]) < 1e-6);
+        ops::logsumexp(x, 0).backward();
+        for (size_t i = 0; i < 41; ++i) assert(std::abs(x.grad().data()[i] - 2.0f * p.data()[i]) < 1e-6);
+        x.zero_grad();
+        assert(x.grad().data()[0] == 0.0f);
+
+        auto nograd = random_tensor({ 4 }, 75);
+        assert(!ops::softmax(nograd, 0).requires_grad() && !ops::softmax(nograd, 0).grad_fn());
+        expect_throw("backward of non-scalar", [&] { ops::softmax(x, 0).backward(); });
+        expect_throw("backward without grad", [&] { ops::logsumexp(nograd, 0).backward(); });
+        std::cout << "[OK]   softmax family backward\n";
+    }
+
+    // ---- cross_entropy: loss and softmax - onehot gradient ----
+    {
+        using ml::DType;
+        for (size_t V : { 1, 3, 17, 64, 1000, 50021 }) {
+            const size_t B = 6;
+            auto L = random_tensor({ B, V }, 101);
+            for (size_t i = 0; i < L.numel(); ++i) L.data()[i] *= 20.0f;
+            std::vector<float> tv(B);
+            for (size_t r = 0; r < B; ++r) tv[r] = float((r * 7919) % V);
+            Tensor T = ops::to_dtype(Tensor::from_vector(tv, { B }), DType::Int32);
+            std::vector<double> logp, lse;
+            log_softmax_ref(L, 1, logp, lse);
+
+            L.set_requires_grad(true);
+            Tensor loss = ops::cross_entropy(L, T);
+            assert(loss.ndim() == 0 && loss.requires_grad());
+            double ref = 0.0;
+            for (size_t r = 0; r < B; ++r) ref -= logp[r * V + size_t(tv[r])];
+            ref /= double(B);
+            assert(std::abs(loss.data()[0] - ref) < 1e-4 * (1.0 + std::abs(ref)));
+
+            loss.backward();
+            for (size_t r = 0; r < B; ++r) {
+                for (size_t j = 0; j < V; ++j) {
+                    const double g = (std::exp(logp[r * V + j]) - (j == size_t(tv[r]) ? 1.0 : 0.0)) / double(B);
+                    assert(std::abs(L.grad().data()[r * V + j] - g) < 1e-6);
+                }
+            }
+        }
+
+        // transposed logits are copied once; a scaled upstream gradient
+        auto LT = random_tensor({ 9, 4 }, 102);
+        Tensor T = ops::to_dtype(Tensor::from_vector({ 8, 0, 3, 5 }, { 4 }), DType::Int32);
+        Tensor L = LT.transpose(0, 1).contiguous();
+        L.set_requires_grad(true);
+        Tensor loss = ops::cross_entropy(L, T);
+        assert(ops::cross_entropy(LT.transpose(0, 1), T).data()[0] == loss.data()[0]);
+        loss.grad_fn()->backward(Tensor::from_vector({ 2.0f }, { 1 }).reshape({}));
+        Tensor P = ops::softmax(L, 1);
+        const int32_t* pt = T.data_as<int32_t>();
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t j = 0; j < 9; ++j) {
+                const float g = 2.0f * (P.at({ r, j }) - (int32_t(j) == pt[r] ? 1.0f : 0.0f)) / 4.0f;
+                assert(std::abs(L.grad().at({ r, j }) - g) < 1e-6);
+            }
+        }
+
+        expect_throw("cross_entropy target out of range", [&] { (void)ops::cross_entropy(random_tensor({ 4, 8 }, 103), T); });
+        expect_throw("cross_entropy negative target", [&] {
+            (void)ops::cross_entropy(random_tensor({ 4, 9 }, 103), ops::to_dtype(Tensor::from_vector({ 1, 2, -1, 0 }, { 4 }), DType::Int32));
+            });
+        expect_throw("cross_entropy float targets", [&] { (void)ops::cross_entropy(random_tensor({ 4, 9 }, 103), Tensor::zeros({ 4 })); });
+        expect_throw("cross_entropy batch mismatch", [&] { (void)ops::cross_entropy(random_tensor({ 3, 9 }, 103), T); });
+        std::cout << "[OK]   cross_entropy\n";
+    }
+
+    // ---- layer_norm / rms_norm: every tail length, offsets, affine ----
+    {
+        for (size_t N : { 1, 5, 8, 16, 31, 64, 67, 130, 1000 }) {
+            const size_t R = 7;
+            auto X = random_tensor({ R, N }, 81);
+            // a large offset: a one-pass E[x^2] - E[x]^2 would lose the variance
+            for (size_t i = 0; i < X.numel(); ++i) X.data()[i] = 1000.0f + 3.0f * X.data()[i];
+            auto W = random_tensor({ N }, 82), B = random_tensor({ N }, 83);
+            Tensor Y = ops::layer_norm(X, W, B), Yn = ops::layer_norm(X, 0.0f);
+            Tensor Z = ops::rms_norm(X, W), Zn = ops::rms_norm(X);
+            for (size_t r = 0; r < R; ++r) {
+                const float* x = X.data() + r * N;
+                double mean = 0.0, var = 0.0, ms = 0.0;
+                for (size_t j = 0; j < N; ++j) mean += x[j];
+                mean /= double(N);
+                for (size_t j = 0; j < N; ++j) {
+                    var += (x[j] - mean) * (x[j] - mean);
+                    ms += double(x[j]) * x[j];
+                }
+                var /= double(N);
+                ms /= double(N);
+                const double rstd = 1.0 / std::sqrt(var + 1e-5), rrms = 1.0 / std::sqrt(ms + 1e-6);
+                for (size_t j = 0; j < N; ++j) {
+                    const double xh = (x[j] - mean) * rstd;
+                    assert(std::abs(Y.data()[r * N + j] - (xh * W.data()[j] + B.data()[j])) < 2e-3);
+                    if (N > 1) assert(std::abs(Yn.data()[r * N + j] - (x[j] - mean) / std::sqrt(var)) < 2e-3);
+                    assert(std::abs(Z.data()[r * N + j] - x[j] * rrms * W.data()[j]) < 1e-5);
+                    assert(std::abs(Zn.data()[r * N + j] - x[j] * rrms) < 1e-5);
+                }
+            }
+        }
+
+        // any layout of x, strided weight, rows over several threads
+        auto X = random_tensor({ 64, 3, 48 }, 84);
+        auto XT = X.transpose(0, 1);   // [3, 64, 48] view
+        Tensor wb = Tensor::from_vector({ 0.5f }, { 1 }).expand({ 48 });   // stride 0
+        Tensor w = wb.contiguous();
+        Tensor a = ops::rms_norm(XT, w).contiguous(), b = ops::rms_norm(XT.contiguous(), wb);
+        for (size_t i = 0; i < a.numel(); ++i) assert(a.data()[i] == b.data()[i]);
+
+        expect_throw("layer_norm weight shape", [&] { (void)ops::layer_norm(X, Tensor::zeros({ 47 }), Tensor::zeros({ 48 })); });
+        expect_throw("rms_norm of int32", [&] { (void)ops::rms_norm(ops::to_dtype(X, DType::Int32)); });
+        std::cout << "[OK]   layer_norm / rms_norm\n";
+    }
+
+    // ---- layer_norm / rms_norm backward: finite differences for x, weight, bias ----
+    {
+        const size_t R = 5, N = 19;
+        auto G = random_tensor({ R, N }, 94);
+        for (int variant = 0; variant < 4; ++variant) {
+            auto X = random_tensor({ R, N }, 91);
+            auto W = random_tensor({ N }, 92), B = random_tensor({ N }, 93);
+            // 0: layer_norm affine, 1: layer_norm plain, 2: rms_norm weight, 3: rms_norm plain
+            auto f = [&](const Tensor& x, const Tensor& w, const Tensor& b) {
+                switch (variant) {
+                case 0: return ops::layer_norm(x, w, b);
+                case 1: return ops::layer_norm(x);
+                case 2: return ops::rms_norm(x, w);
+                default: return ops::rms_norm(x);
+                }
+            };
+            X.set_requires_grad(true);
+            W.set_requires_grad(true);
+            B.set_requires_grad(true);
+            Tensor Y = f(X, W, B);
+            assert(Y.grad_fn());
+            Y.grad_fn()->backward(G);
+            auto loss = [&] {
+                Tensor y = f(X.detach(), W.detach(), B.detach());
+                double acc = 0.0;
+                for (size_t i = 0; i < y.numel(); ++i) acc += double(G.data()[i]) * y.data()[i];
+                return acc;
+            };
+            for (Tensor* t : { &X, &W, &B }) {
+                const bool used = t == &X || (t == &W && (variant == 0 || variant == 2)) || (t == &B && variant == 0);
+                assert(t->has_grad() == used);
+                if (!used) continue;
+                for (size_t e = 0; e < t->numel(); ++e) {
+                    const float v0 = t->data()[e], h = 1e-2f;
+                    t->data()[e] = v0 + h;
+                    const double up = loss();
+                    t->data()[e] = v0 - h;
+                    const double down = loss();
+                    t->data()[e] = v0;
+                    const double fd = (up - down) / (2.0 * h);
+                    if (std::abs(t->grad().data()[e] - fd) > 5e-3 * (1.0 + std::abs(fd))) {
+                        std::cerr << "[FAIL] norm variant " << variant << " grad " << e << ": " << t->grad().data()[e] << " vs " << fd << "\n";
+                        std::abort();
+                    }
+                }
+            }
+        }
+
+        // a weight that needs no grad gets none, x still does
+        auto X = random_tensor({ R, N }, 91);
+        auto W = random_tensor({ N }, 92), B = random_tensor({ N }, 93);
+        X.set_requires_grad(true);
+        Tensor Y = ops::layer_norm(X, W, B);
+        Y.grad_fn()->backward(G);
+        assert(X.has_grad() && !W.requires_grad() && !W.has_grad());
+        std::cout << "[OK]   layer_norm / rms_norm backward\n";
+    }
+
+    // ---- autograd engine: every op's backward against finite differences ----
+    {
+        auto leaf = [](const std::vector<size_t>& sizes, unsigned seed, bool away_from_zero = false) {
+            Tensor t = random_tensor(sizes, seed);
+            // for kinks (relu): no element within 0.1 of 0
+            if (away_from_zero) {
+                for (size_t i = 0; i < t.numel(); ++i) t.data()[i] += t.data()[i] < 0.0f ? -0.1f : 0.1f;
+            }
+            t.set_requires_grad(true);
+            return t;
+        };
+
+        auto A = leaf({ 3, 4 }, 201), B = leaf({ 4 }, 202), C = leaf({ 2, 1, 4 }, 203);
+        check_grads("add / sub / mul broadcast", [&] { return ops::sub(ops::mul(ops::add(A, B), C), A); }, { &A, &B, &C });
+        check_grads("mul(x, x)", [&] { return ops::mul(A, A); }, { &A });
+        auto Rl = leaf({ 5, 6 }, 204, true);
+        check_grads("relu", [&] { return ops::relu(Rl); }, { &Rl });
+
+        auto M1 = leaf({ 2, 3, 5 }, 205), M2 = leaf({ 5, 4 }, 206), M3 = leaf({ 3, 5 }, 207), M4 = leaf({ 2, 5, 4 }, 208);
+        check_grads("matmul batched x 2D", [&] { return ops::matmul(M1, M2); }, { &M1, &M2 });
+        check_grads("matmul 2D x batched", [&] { return ops::matmul(M3, M4); }, { &M3, &M4 });
+        check_grads("matmul transposed view", [&] { return ops::matmul(M2.transpose(0, 1), M3.transpose(0, 1)); }, { &M2, &M3 });
+
+        auto X = leaf({ 2, 3, 6 }, 209), W = leaf({ 6, 5 }, 210), Bi = leaf({ 5 }, 211), Res = leaf({ 2, 3, 5 }, 212);
+        check_grads("linear", [&] { return ops::linear(X, W, Bi); }, { &X, &W, &Bi });
+        check_grads("linear relu + residual", [&] { return ops::linear(X, W, Bi, ops::Activation::ReLU, Res); }, { &X, &W, &Bi, &Res }, 1e-3f);
+        check_grads("linear gelu + residual", [&] { return ops::linear(X, W, Bi, ops::Activation::GELU, Res); }, { &X, &W, &Bi, &Res });
+
+        // a large residual with a tiny z: y - r rounds to 0, z > 0 still
+        // counts (matches relu(linear) + r, unfused)
+        {
+            auto X1 = leaf({ 1, 3 }, 218), W1 = leaf({ 3, 2 }, 219);
+            Tensor zw = ops::matmul(X1.detach(), W1.detach());
+            auto B1 = leaf({ 2 }, 220);
+            B1.data()[0] = 1e-4f - zw.data()[0];
+            B1.data()[1] = -1e-4f - zw.data()[1];
+            auto R1 = leaf({ 1, 2 }, 221);
+            R1.data()[0] = R1.data()[1] = 4096.0f;
+            std::vector<Tensor> fused, plain;
+            for (int unfused = 0; unfused < 2; ++unfused) {
+                for (Tensor* t : { &X1, &W1, &B1, &R1 }) t->zero_grad();
+                Tensor y = unfused ? ops::add(ops::relu(ops::linear(X1, W1, B1)), R1)
+                    : ops::linear(X1, W1, B1, ops::Activation::ReLU, R1);
+                ops::sum(y).backward();
+                for (Tensor* t : { &X1, &W1, &B1, &R1 }) (unfused ? plain : fused).push_back(t->grad().clone());
+            }
+            assert(W1.grad().data()[0] != 0.0f);
+            for (size_t k = 0; k < fused.size(); ++k) {
+                for (size_t i = 0; i < fused[k].numel(); ++i) assert(std::abs(fused[k].data()[i] - plain[k].data()[i]) < 1e-5f);
+            }
+        }
+
+        auto S = leaf({ 3, 4, 5 }, 213);
+        check_grads("sum dims", [&] { return ops::sum(S, { 0, 2 }); }, { &S });
+        check_grads("sum all", [&] { return ops::sum(S); }, { &S });
+        check_grads("mean keepdim", [&] { return ops::mean(S, 1, true); }, { &S });
+        check_grads("max / min", [&] { return ops::add(ops::max(S, 2), ops::min(S, { 0, 2 })); }, { &S });
+
+        // prod: rows with no zero, one zero, two zeros (x / out would be 0 / 0)
+        auto P = leaf({ 3, 4 }, 214);
+        P.data()[5] = 0.0f;
+        P.data()[8] = 0.0f;
+        P.data()[10] = 0.0f;
+        check_grads("prod with zeros", [&] { return ops::prod(P, 1); }, { &P });
+        check_grads("prod all", [&] { return ops::prod(P.slice(0, 0, 1)); }, { &P });
+
+        auto V = leaf({ 4, 6 }, 215);
+        check_grads("transpose / slice / reshape", [&] {
+            return V.transpose(0, 1).slice(0, 1, 4).contiguous().reshape({ 2, 2, 4 });
+            }, { &V });
+        check_grads("expand / clone", [&] { return ops::mul(V.slice(1, 2, 1).expand({ 4, 3 }), V.clone().slice(1, 0, 3)); }, { &V });
+
+        auto E1 = leaf({ 3, 4 }, 216, true), E2 = leaf({ 4 }, 217, true);
+        check_grads("expr::eval", [&] {
+            return expr::eval(expr::relu(expr::add(expr::mul(E1, E2), 0.5f)) - expr::mul(E1, E1));
+            }, { &E1, &E2 });
+        check_grads("expr::eval of views", [&] { return expr::eval(expr::mul(E1.transpose(0, 1), 2.0f)); }, { &E1 });
+
+        // max / min ties share the gradient evenly
+        Tensor T = Tensor::from_vector({ 1.0f, 3.0f, 3.0f, 2.0f, 3.0f, 0.0f }, { 2, 3 });
+        T.set_requires_grad(true);
+        ops::sum(ops::max(T)).backward();
+        const float tie[] = { 0.0f, 1.0f / 3, 1.0f / 3, 0.0f, 1.0f / 3, 0.0f };
+        for (size_t i = 0; i < 6; ++i) assert(std::abs(T.grad().data()[i] - tie[i]) < 1e-7f);
+        std::cout << "[OK]   autograd op gradients\n";
+    }
+
+    // ---- autograd engine: traversal, accumulation, freeing the graph ----
+    {
+        auto X = random_tensor({ 4, 3 }, 221);
+        auto W = random_tensor({ 3, 2 }, 222);
+        X.set_requires_grad(true);
+        W.set_requires_grad(true);
+        auto chain = [&] {
+            // a diamond: h feeds the loss twice
+            Tensor h = ops::relu(ops::matmul(X, W));
+            return ops::mean(ops::add(ops::log_softmax(h, 1), ops::mul(h, h)));
+        };
+
+        Tensor loss = chain();
+        assert(loss.ndim() == 0 && loss.grad_fn());
+        loss.backward();
+        Tensor gx = X.grad().clone(), gw = W.grad().clone();
+        assert(!X.grad_fn() && !X.grad().requires_grad());
+
+        // grads accumulate across backward() calls
+        chain().backward();
+        for (size_t i = 0; i < gx.numel(); ++i) assert(std::abs(X.grad().data()[i] - 2.0f * gx.data()[i]) < 1e-6f);
+
+        // a freed graph throws, a retained one runs again
+        expect_throw("backward twice", [&] { loss.backward(); });
+        X.zero_grad();
+        Tensor kept = chain();
+        kept.backward(true);
+        kept.backward();
+        for (size_t i = 0; i < gx.numel(); ++i) assert(std::abs(X.grad().data()[i] - 2.0f * gx.data()[i]) < 1e-6f);
+        expect_throw("backward after retained run", [&] { kept.backward(); });
+
+        // saved tensors go as soon as their node has run
+        Tensor A = random_tensor({ 8 }, 223);
+        A.set_requires_grad(true);
+        const long base = A.storage_ptr().use_count();
+        Tensor sq = ops::sum(ops::mul(A, A));
+        assert(A.storage_ptr().use_count() > base);
+        sq.backward();
+        assert(A.storage_ptr().use_count() == base);
+        for (size_t i = 0; i < 8; ++i) assert(std::abs(A.grad().data()[i] - 2.0f * A.data()[i]) < 1e-6f);
+
+        // inputs that need no grad: no node input, no grad
+        Tensor C = random_tensor({ 8 }, 224);
+        Tensor y = ops::mul(A, C);
+        assert(y.grad_fn()->inputs[1] == nullptr);
+        assert(!ops::add(C, C).requires_grad() && !C.transpose(0, 0).requires_grad());
+        expect_throw("backward of a non-scalar", [&] { y.backward(); });
+        expect_throw("backward without grad", [&] { ops::sum(C).backward(); });
+        std::cout << "[OK]   autograd graph\n";
+    }
+
+    // ---- NoGradGuard / InferenceMode: no nodes, thread-local, nesting ----
+    {
+        Tensor W = random_tensor({ 4, 3 }, 231);
+        Tensor X = random_tensor({ 2, 4 }, 232);
+        W.set_requires_grad(true);
+        assert(grad_enabled() && !inference_mode_enabled());
+        {
+            NoGradGuard no_grad;
+            assert(!grad_enabled());
+            Tensor y = ops::relu(ops::matmul(X, W));
+            Tensor v = W.transpose(0, 1);
+            Tensor e = expr::eval(expr::mul(W, 2.0f));
+            assert(!y.requires_grad() && !y.grad_fn() && !v.requires_grad() && !e.requires_grad());
+            assert(!y.is_inference());
+            {
+                NoGradGuard nested;
+            }
+            assert(!grad_enabled());
+
+            // other threads keep their own mode
+            bool worker_grad = false;
+            std::thread([&] { worker_grad = grad_enabled(); }).join();
+            assert(worker_grad);
+        }
+        assert(grad_enabled());
+        assert(ops::matmul(X, W).grad_fn());
+
+        Tensor Xi = Tensor::zeros({ 1 });
+        {
+            InferenceMode inference;
+            assert(!grad_enabled() && inference_mode_enabled());
+            Tensor y = ops::softmax(ops::matmul(X, W), 1);
+            assert(!y.requires_grad() && y.is_inference() && !X.is_inference());
+            Xi = ops::add(X, X);
+            {
+                NoGradGuard nested;
+            }
+            assert(!grad_enabled());
+        }
+        assert(grad_enabled() && !inference_mode_enabled());
+
+        // parallel_for ranges run in the caller's mode, on every worker
+        {
+            const size_t prev = get_num_threads();
+            set_num_threads(4);
+            std::atomic<int> recorded{ 0 }, plain{ 0 }, on_workers{ 0 };
+            const auto caller = std::this_thread::get_id();
+            auto body = [&](size_t, size_t) {
+                // long enough for the workers to steal ranges
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (std::this_thread::get_id() != caller) on_workers++;
+                Tensor y = ops::mul(W, W);
+                if (y.requires_grad()) recorded++;
+                if (!y.is_inference()) plain++;
+            };
+            {
+                NoGradGuard no_grad;
+                parallel_for(0, 64, 1, body);
+            }
+            assert(recorded == 0 && plain == 64);
+            {
+                InferenceMode inference;
+                parallel_for(0, 64, 1, body);
+            }
+            assert(recorded == 0 && plain == 64);
+            parallel_for(0, 64, 1, body);
+            assert(recorded == 64 && on_workers > 0);
+            set_num_threads(prev);
+        }
+
+        // inference tensors and their views stay out of graphs
+        Tensor Xv = Xi.transpose(0, 1);
+        assert(Xi.is_inference() && Xv.is_inference() && !Xi.clone().is_inference());
+        expect_throw("requires_grad on an inference tensor", [&] { Xv.set_requires_grad(true); });
+        // ...but may feed ops on parameters that record
+        Tensor loss = ops::sum(ops::matmul(Xi, W));
+        loss.backward();
+        assert(W.has_grad() && !loss.is_inference());
+        std::cout << "[OK]   NoGradGuard / InferenceMode\n";
+    }
+
+    // ---- error cases ----
+    {
+        auto A = Tensor::zeros({ 2,3 });
+        auto B = Tensor::zeros({ 2,3 });
+        expect_throw("matmul shape mismatch", [&] { (void)ops::matmul(A, B); });
+        expect_throw("matmul non-2D", [&] { (void)ops::matmul(Tensor::zeros({ 3 }), B); });
+        expect_throw("add not broadcastable", [&] { (void)ops::add(A, Tensor::zeros({ 2 })); });
+    }
+
+    std::cout << "All ops tests passed ✅\n";
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ml/ops/elementwise.hpp"
+#include "ml/ops/matmul.hpp"
+#include "ml/runtime/parallel.hpp"
+#include "ml/tensor/tensor.hpp"
+
+static void expect_throw(const char* name, const std::function<void()>& fn) {
+    try {
+        fn();
+        std::cerr << "[FAIL] Expected exception: " << name << "\n";
+        std::abort();
+    }
+    catch (const std::exception&) {
+        std::cout << "[OK]   threw: " << name << "\n";
+    }
+}
+
+int main() {
+    using namespace ml;
+
+    std::cout << "Running parallel tests...\n";
+    size_t prev = get_num_threads();
+
+    // ---- parallel_for visits every index exactly once ----
+    {
+        for (size_t threads : { 1, 2, 4, 7 }) {
+            set_num_threads(threads);
+            for (size_t grain : { 1, 3, 64, 5000 }) {
+                const size_t n = 10007;
+                std::vector<std::atomic<int>> hits(n);
+                parallel_for(0, n, grain, [&](size_t b, size_t e) {
+                    assert(b % grain == 0 && b < e);
+                    assert(in_parallel_region());
+                    for (size_t i = b; i < e; ++i) hits[i].fetch_add(1);
+                    });
+                for (auto& h : hits) assert(h.load() == 1);
+            }
+        }
+        parallel_for(5, 5, 1, [](size_t, size_t) { assert(false); });
+        assert(!in_parallel_region());
+        std::cout << "[OK]   parallel_for coverage\n";
+    }
+
+    // ---- nested parallel_for runs inline, no deadlock ----
+    {
+        set_num_threads(4);
+        std::atomic<size_t> total{ 0 };
+        parallel_for(0, 64, 1, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                parallel_for(0, 1000, 10, [&](size_t ib, size_t ie) {
+                    total.fetch_add(ie - ib);
+                    });
+            }
+            });
+        assert(total.load() == 64 * 1000);
+
+        // a parallel matmul inside a parallel batch loop
+        auto A = Tensor::ones({ 128, 128 });
+        auto B = Tensor::ones({ 128, 128 });
+        std::vector<float> corner(8, 0.0f);
+        parallel_for(0, 8, 1, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) corner[i] = ops::matmul(A, B).at({ 127, 127 });
+            });
+        for (float c : corner) assert(c == 128.0f);
+        std::cout << "[OK]   nested parallelism\n";
+    }
+
+    // ---- exceptions propagate to the caller ----
+    {
+        set_num_threads(4);
+        expect_throw("parallel_for task", [] {
+            parallel_for(0, 1000, 1, [](size_t b, size_t) {
+                if (b == 517) throw std::runtime_error("boom");
+                });
+            });
+        // the pool is still usable afterwards
+        std::atomic<size_t> count{ 0 };
+        parallel_for(0, 100, 1, [&](size_t b, size_t e) { count.fetch_add(e - b); });
+        assert(count.load() == 100);
+    }
+
+    // ---- parallel_reduce is deterministic across thread counts ----
+    {
+        const size_t n = 1000003;
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; ++i) v[i] = 1.0f / float(1 + (i * 7919) % 1000);
+
+        auto sum = [&] {
+            return parallel_reduce(size_t(0), n, size_t(4096), 0.0f,
+                [&](size_t b, size_t e) {
+                    float s = 0.0f;
+                    for (size_t i = b; i < e; ++i) s += v[i];
+                    return s;
+                },
+                [](float x, float y) { return x + y; });
+        };
+
+        set_num_threads(1);
+        float ref = sum();
+        for (size_t threads : { 2, 3, 8 }) {
+            set_num_threads(threads);
+            for (int rep = 0; rep < 3; ++rep) assert(sum() == ref);
+        }
+        std::cout << "[OK]   parallel_reduce deterministic\n";
+    }
+
+    // ---- ops on the pool ----
+    {
+        set_num_threads(4);
+        const size_t n = 301 * 997;
+        std::vector<float> av(n), bv(n);
+        for (size_t i = 0; i < n; ++i) {
+            av[i] = float(i % 97) - 48.0f;
+            bv[i] = float(i % 13);
+        }
+        auto a = Tensor::from_vector(av, { n });
+        auto b = Tensor::from_vector(bv, { n });
+        auto s = ops::add(a, b);
+        auto r = ops::relu(a);
+        for (size_t i = 0; i < n; ++i) {
+            assert(s.data()[i] == av[i] + bv[i]);
+            assert(r.data()[i] == (av[i] > 0.0f ? av[i] : 0.0f));
+        }
+
+        auto M = Tensor::from_vector(av, { 1, n }).reshape({ 301, 997 }).transpose(0, 1);
+        auto Mc = M.contiguous();
+        for (size_t i = 0; i < 997; i += 13) {
+            for (size_t j = 0; j < 301; j += 7) assert(Mc.at({ i, j }) == M.at({ i, j }));
+        }
+        std::cout << "[OK]   elementwise + contiguous on the pool\n";
+    }
+
+    // ---- set_num_threads racing with parallel work on another thread ----
+    {
+        set_num_threads(4);
+        std::atomic<bool> done{ false };
+        std::atomic<size_t> rounds{ 0 };
+        std::thread user([&] {
+            const size_t n = 100000;
+            while (!done.load()) {
+                std::vector<int> hits(n, 0);
+                parallel_for(0, n, 1000, [&](size_t b, size_t e) {
+                    for (size_t i = b; i < e; ++i) hits[i]++;
+                    });
+                for (size_t i = 0; i < n; ++i) assert(hits[i] == 1);
+                rounds++;
+            }
+            });
+        for (size_t k = 0; k < 40 || rounds.load() < 10; ++k) set_num_threads(1 + k % 4);
+        done = true;
+        user.join();
+
+        expect_throw("set_num_threads inside parallel_for", [] {
+            parallel_for(0, 4, 1, [](size_t, size_t) { set_num_threads(2); });
+            });
+        std::cout << "[OK]   set_num_threads during parallel work\n";
+    }
+
+    set_num_threads(prev);
+    std::cout << "All parallel tests passed ✅\n";
+    return 0;
+}
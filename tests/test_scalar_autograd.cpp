@@ -40,6 +40,74 @@ int main() {
     std::cout << "df/dx = " << x3->grad << "\n"; // 0.5
     assert(std::abs(x3->grad - 0.5) < 1e-12);
 
+    // ====== Test 4: div / relu / exp: f = exp(a / b) + relu(a - b), a=2, b=4 ======
+    // df/da = exp(a/b)/b + 0, df/db = -exp(a/b)*a/b^2
+    auto a4 = Value::make(2.0);
+    auto b4 = Value::make(4.0);
+    auto f4 = exp(a4 / b4) + relu(a4 - b4);
+    f4->backward();
+    assert(std::abs(a4->grad - std::exp(0.5) / 4.0) < 1e-12);
+    assert(std::abs(b4->grad + std::exp(0.5) * 2.0 / 16.0) < 1e-12);
+
+    // ====== Test 5: a chain of a million nodes (no recursion anywhere) ======
+    // acc = acc * w + 1, n times from acc = 0: d(acc)/dw at w=1 is n(n-1)/2
+    {
+        Arena arena;
+        ArenaScope scope(arena);
+        const size_t n = 500000;
+        auto w = Value::make(1.0);
+        auto one = Value::make(1.0);
+        auto acc = Value::make(0.0);
+        for (size_t i = 0; i < n; ++i) acc = acc * w + one;
+        assert(arena.size() == 2 * n + 3);
+        acc->backward();
+        assert(acc->data == double(n));
+        assert(w->grad == double(n) * double(n - 1) / 2.0);
+        assert(one->grad == double(n));
+
+        // clear() frees the graph in O(1) and the next one reuses the blocks
+        const size_t cap = arena.capacity();
+        Value* first = w.node;
+        arena.clear();
+        assert(arena.size() == 0);
+        auto w2 = Value::make(3.0);
+        assert(w2.node == first && w2->grad == 0.0 && arena.capacity() == cap);
+    }
+
+    // ====== Test 6: ArenaScope picks the arena, and restores the previous one ======
+    {
+        Arena outer(8), inner(8);
+        ArenaScope s1(outer);
+        auto p = Value::make(1.0);
+        {
+            ArenaScope s2(inner);
+            auto q = Value::make(2.0) * p;   // p lives in outer, q in inner
+            q->backward();
+            assert(inner.size() == 2 && p->grad == 2.0);
+        }
+        auto r = p + p;   // outer again; block boundaries are invisible
+        for (int i = 0; i < 20; ++i) r = r + p;
+        assert(outer.size() == 22 && inner.size() == 2);
+        p->grad = 0.0;
+        r->backward();
+        assert(p->grad == 22.0);
+    }
+
+    // ====== Test 7: the default arena (no scope) holds every node until cleared ======
+    {
+        Arena& def = Arena::current();
+        def.clear();   // tests 1-3 built their graphs here
+        for (int step = 0; step < 3; ++step) {
+            auto x = Value::make(2.0);
+            auto y = x * x + x;
+            y->backward();
+            assert(x->grad == 5.0);
+            assert(def.size() == 3);
+            def.clear();   // without this, size() grows by 3 per step
+        }
+        assert(def.size() == 0);
+    }
+
     std::cout << "All scalar autograd tests passed ✅\n";
     return 0;
 }
@@ -1,9 +1,14 @@
 ﻿#include <cassert>
+#include <functional>
 #include <iostream>
+#include <thread>
 #include <stdexcept>
 #include <vector>
 
+#include "ml/core/allocator.hpp"
 #include "ml/core/shape.hpp"
+#include "ml/core/strided_loop.hpp"
+#include "ml/tensor/static_tensor.hpp"
 #include "ml/tensor/tensor.hpp"
 
 static void expect_throw(const char* name, const std::function<void()>& fn) {
@@ -103,6 +108,209 @@ int main() {
         std::cout << "[OK]   contiguous copy\n";
     }
 
+    // ---- expand is a zero-stride view ----
+    {
+        auto v = Tensor::arange(3);                   // [0 1 2]
+        auto E = v.expand({ 4,3 });                 // 4 rows of v
+
+        assert(E.storage_ptr() == v.storage_ptr());
+        assert((E.strides() == std::vector<size_t>{0, 1}));
+        assert(E.at({ 3,2 }) == 2.0f);
+        assert(!E.is_contiguous());
+
+        auto col = Tensor::arange(2).reshape({ 2,1 }); // [[0],[1]]
+        auto C = col.expand({ 2,5 });
+        assert(C.at({ 1,4 }) == 1.0f && C.at({ 0,3 }) == 0.0f);
+
+        auto Cc = C.contiguous();
+        assert(Cc.is_contiguous() && Cc.at({ 1,2 }) == 1.0f);
+
+        assert((ml::core::broadcast_shapes({ 4,1,3 }, { 5,1 }) == std::vector<size_t>{4, 5, 3}));
+        std::cout << "[OK]   expand view\n";
+    }
+
+    // ---- strided loop: coalescing + row walk ----
+    {
+        // contiguous [2,3,4] folds into one row of 24
+        ml::core::Shape sizes{ 2,3,4 }, st{ 12,4,1 };
+        ml::core::StridedLoop<1> flat(sizes, { &st });
+        assert(flat.ndim() == 1 && flat.inner_size() == 24 && flat.inner_stride(0) == 1);
+
+        // [B,N] + [N]: the broadcast operand keeps the loop 2D
+        ml::core::Shape bs{ 5,8 }, out_st{ 8,1 }, bias_st{ 0,1 };
+        ml::core::StridedLoop<2> bias(bs, { &out_st, &bias_st });
+        assert(bias.ndim() == 2 && bias.inner_size() == 8);
+
+        // transposed [3,2] view of a [2,3] buffer, walked from the middle of a row
+        ml::core::Shape ts{ 3,2 }, tst{ 1,3 };
+        ml::core::StridedLoop<1> tr(ts, { &tst });
+        std::vector<size_t> seen;
+        tr.for_range(1, 6, [&](const std::array<size_t, 1>& off, size_t n) {
+            for (size_t j = 0; j < n; ++j) seen.push_back(off[0] + j * tr.inner_stride(0));
+            });
+        assert((seen == std::vector<size_t>{3, 1, 4, 2, 5}));
+        std::cout << "[OK]   strided loop\n";
+    }
+
+    // ---- inline shape metadata ----
+    {
+        using ml::core::Shape;
+        Shape s{ 2,3,4 };
+        Shape copy = s;
+        copy[0] = 7;
+        assert(s[0] == 2 && copy == (Shape{ 7,3,4 }));
+        assert((s == std::vector<size_t>{2, 3, 4}) && s.to_vector() == (std::vector<size_t>{2, 3, 4}));
+
+        Shape full(ml::core::kMaxDims, 1);
+        assert(full.size() == Shape::capacity());
+        expect_throw("Shape: push past capacity", [&] { full.push_back(1); });
+
+        // a rank-8 tensor still works end to end
+        auto t = ml::Tensor::ones({ 1,2,1,2,1,2,1,2 });
+        assert(t.numel() == 16 && t.transpose(1, 7).at({ 0,1,0,0,0,1,0,0 }) == 1.0f);
+        expect_throw("rank > kMaxDims", [] { ml::Tensor::zeros({ 1,1,1,1,1,1,1,1,1 }); });
+        std::cout << "[OK]   inline shape\n";
+    }
+
+    // ---- dtypes: storage size, typed access, copies of views ----
+    {
+        using ml::DType;
+        auto h = Tensor::ones({ 3,5 }, DType::Float16);
+        assert(h.dtype() == DType::Float16 && h.element_size() == 2);
+        assert(h.storage_ptr()->nbytes() == 30);
+        assert(static_cast<float>(h.data_as<ml::core::Half>()[14]) == 1.0f);
+
+        auto q = Tensor::zeros({ 4,4 }, DType::Int8);
+        int8_t* qp = q.data_as<int8_t>();
+        for (int i = 0; i < 16; ++i) qp[i] = static_cast<int8_t>(i - 8);
+        auto qt = q.transpose(0, 1).contiguous();
+        assert(qt.dtype() == DType::Int8 && qt.data_as<int8_t>()[1] == -4);   // q[1][0]
+        assert(qt.raw_data() != q.raw_data());
+        assert(q.slice(0, 1, 2).raw_data() == static_cast<const void*>(qp + 4));
+
+        auto d = Tensor::ones({ 2,2 }, DType::Float64);
+        assert((d.accessor<2, double>()(1, 1) == 1.0));
+
+        expect_throw("data() on int8", [&] { (void)q.data(); });
+        expect_throw("data_as wrong type", [&] { (void)h.data_as<float>(); });
+        expect_throw("at() on float16", [&] { (void)h.at({ 0,0 }); });
+        expect_throw("accessor wrong dtype", [&] { (void)d.accessor<2>(); });
+        std::cout << "[OK]   dtypes\n";
+    }
+
+    // ---- unchecked accessor matches at() on views ----
+    {
+        auto base = Tensor::arange(24).reshape({ 2,3,4 });
+        auto v = base.transpose(0, 2).slice(1, 1, 2);     // [4,2,2]
+        auto acc = v.accessor<3>();
+        for (size_t i = 0; i < 4; ++i)
+            for (size_t j = 0; j < 2; ++j)
+                for (size_t k = 0; k < 2; ++k) {
+                    assert(acc(i, j, k) == v.at({ i,j,k }));
+                    assert(acc[i][j][k] == v.at({ i,j,k }));
+                }
+        assert(acc.size(0) == 4 && acc.stride(0) == 1);
+
+        auto w = base.accessor<3>();
+        w(1, 2, 3) = -1.0f;
+        assert(base.at({ 1,2,3 }) == -1.0f);
+
+        const Tensor& cb = base;
+        assert(cb.accessor<3>()[1][2][3] == -1.0f);
+        expect_throw("accessor rank mismatch", [&] { (void)base.accessor<2>(); });
+        std::cout << "[OK]   accessor\n";
+    }
+
+    // ---- caching allocator reuses freed blocks ----
+    {
+        using namespace ml::core;
+        empty_allocator_cache();
+        reset_allocator_stats();
+        size_t in_use = allocator_stats().bytes_in_use;
+
+        const float* first = nullptr;
+        {
+            auto t = Tensor::zeros({ 1000, 3 });
+            first = t.data();
+            assert(allocator_stats().misses == 1);
+            assert(allocator_stats().bytes_in_use > in_use);
+        }
+        assert(allocator_stats().bytes_cached >= 1000 * 3 * sizeof(float));
+        assert(allocator_stats().bytes_in_use == in_use);
+
+        // same size class (3000 and 2900 floats both round to 12288 bytes)
+        for (int i = 0; i < 10; ++i) {
+            auto t = Tensor::ones({ 2900 });
+            assert(t.data() == first);
+            assert(t.at({ 2899 }) == 1.0f);
+        }
+        assert(allocator_stats().hits == 10);
+        assert(allocator_stats().misses == 1);
+
+        // a block freed by an exiting thread is picked up through the shared pool
+        std::thread([] { auto t = Tensor::zeros({ 77777 }); }).join();
+        reset_allocator_stats();
+        { auto t = Tensor::zeros({ 77777 }); }
+        assert(allocator_stats().hits == 1 && allocator_stats().misses == 0);
+
+        // limit 0: nothing is kept
+        size_t limit = allocator_cache_limit();
+        empty_allocator_cache();
+        set_allocator_cache_limit(0);
+        { auto t = Tensor::zeros({ 5000 }); }
+        assert(allocator_stats().bytes_cached == 0);
+        set_allocator_cache_limit(limit);
+        std::cout << "[OK]   caching allocator\n";
+    }
+
+    // ---- fixed-shape StaticTensor ----
+    {
+        using ml::StaticTensor;
+        using M3 = StaticTensor<float, 3, 3>;
+        // shapes, constants and kernels are usable at compile time
+        static_assert(M3::rank == 2 && M3::numel == 9 && M3::strides[0] == 3);
+        static_assert(StaticTensor<float, 2, 3, 4>::strides[0] == 12);
+        constexpr M3 R{ 0, -1, 0, 1, 0, 0, 0, 0, 1 };   // 90 degrees about z
+        constexpr StaticTensor<float, 3> p{ 1, 2, 3 };
+        constexpr auto q = ml::matmul(R, p);
+        static_assert(q(0) == -2.0f && q(1) == 1.0f && q(2) == 3.0f);
+        static_assert(ml::matmul(R, ml::transpose(R)) == M3::identity());
+        static_assert(ml::matmul(M3::identity(), R) == R);
+
+        // non-square products and elementwise ops against the Tensor path
+        StaticTensor<float, 2, 4> A;
+        StaticTensor<float, 4, 3> B;
+        for (size_t i = 0; i < A.numel; ++i) A[i] = float(i) - 3.0f;
+        for (size_t i = 0; i < B.numel; ++i) B[i] = 0.5f * float(i);
+        auto C = ml::matmul(A, B);
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t j = 0; j < 3; ++j) {
+                float ref = 0.0f;
+                for (size_t k = 0; k < 4; ++k) ref += A(i, k) * B(k, j);
+                assert(C(i, j) == ref);
+            }
+        auto S = 2.0f * (A + A) - A * A;
+        for (size_t i = 0; i < A.numel; ++i) assert(S[i] == 4.0f * A[i] - A[i] * A[i]);
+
+        // zero-copy Tensor view: reads and writes go to the static storage
+        Tensor ta = A.as_tensor();
+        assert(ta.data() == A.data() && (ta.sizes() == std::vector<size_t>{ 2,4 }));
+        assert(ta.at({ 1,2 }) == A(1, 2));
+        ta.at({ 0,0 }) = 42.0f;
+        assert(A(0, 0) == 42.0f);
+        auto tv = ta.transpose(0, 1);      // views of the borrowed storage work too
+        assert(tv.at({ 2,1 }) == A(1, 2));
+
+        // and back: copy from a strided tensor of the right shape
+        auto At = StaticTensor<float, 4, 2>::from_tensor(tv);
+        assert(At == ml::transpose(A));
+        expect_throw("from_tensor shape", [&] { (void)StaticTensor<float, 2, 4>::from_tensor(tv); });
+        expect_throw("from_tensor dtype", [&] {
+            (void)StaticTensor<double, 2, 4>::from_tensor(ta);
+            });
+        std::cout << "[OK]   static tensor\n";
+    }
+
     // ---- error cases ----
     {
         auto A = Tensor::arange(6).reshape({ 2,3 });
@@ -111,6 +319,11 @@ int main() {
         expect_throw("reshape numel mismatch", [&] { (void)A.reshape({ 5,5 }); });
         expect_throw("transpose bad dim", [&] { (void)A.transpose(0, 10); });
         expect_throw("slice out of bounds", [&] { (void)A.slice(0, 2, 2); });
+        expect_throw("slice zero length", [&] { (void)A.slice(0, 1, 0); });
+        expect_throw("expand to zero", [&] { (void)A.expand({ 0,3,1 }); });
+        expect_throw("expand non-1 dim", [&] { (void)A.expand({ 4,3 }); });
+        expect_throw("expand fewer dims", [&] { (void)A.expand({ 3 }); });
+        expect_throw("broadcast mismatch", [&] { (void)ml::core::broadcast_shapes({ 2,3 }, { 4 }); });
 
         std::cout << "[OK]   error cases\n";
     }